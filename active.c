@@ -0,0 +1,40 @@
+#include "active.h"
+#include "stats.h"
+
+int active_init(ActiveSet *s, SimContext *arena, int count) {
+    s->arena = arena;
+    s->size = count;
+    s->next_compact = count > 1 ? count / 2 : 1;
+    s->idx = simctx_alloc(arena, sizeof(int) * (count > 0 ? count : 1));
+    if (!s->idx) return 0;
+    for (int i = 0; i < count; i++) s->idx[i] = i;
+    return 1;
+}
+
+void active_free(ActiveSet *s) {
+    simctx_free(s->arena, s->idx);
+    s->idx = NULL;
+    s->size = 0;
+}
+
+void active_compact(ActiveSet *s, const Process *list, int completed) {
+    if (completed < s->next_compact) return;
+    int kept = 0;
+    for (int k = 0; k < s->size; k++) {
+        int i = s->idx[k];
+        if (list[i].state != STATE_TERMINATED) s->idx[kept++] = i;
+    }
+    STAT_ADD(procs_retired, s->size - kept);
+    s->size = kept;
+    s->next_compact = completed + (kept > 1 ? kept / 2 : 1);
+}
+
+int active_after(const ActiveSet *s, int idx) {
+    int lo = 0, hi = s->size;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (s->idx[mid] <= idx) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
@@ -0,0 +1,36 @@
+#ifndef ACTIVE_H
+#define ACTIVE_H
+
+#include "process.h"
+
+// Conjunto denso dos processos ainda ativos (não terminados) de um motor de
+// varrimento linear: os ciclos de chegadas, de I/O, de escolha e de
+// próximo evento percorrem idx[0..size-1] em vez de 0..count-1, pelo que o
+// custo acompanha os processos vivos e não o total histórico.
+//
+// Os índices ficam por ordem crescente, para que os varrimentos vejam os
+// processos pela mesma ordem que antes (mensagens, desempates e a procura
+// circular do RR não mudam). Por isso um processo terminado não sai logo por
+// troca com o último: active_compact retira de uma vez todos os terminados
+// quando já houve pelo menos size/2 conclusões desde a compactação anterior,
+// o que dá custo amortizado O(1) por processo. Entre compactações os
+// varrimentos ainda podem ver processos terminados (já ignorados pelo
+// estado).
+typedef struct {
+    SimContext *arena;  // origem da memória (NULL = malloc)
+    int *idx;           // índices ativos, por ordem crescente
+    int size;
+    int next_compact;   // conclusões a partir das quais volta a compactar
+} ActiveSet;
+
+// Todos os índices 0..count-1 começam ativos.
+int  active_init(ActiveSet *s, SimContext *arena, int count);
+void active_free(ActiveSet *s);
+// Chamada no início de cada passo com o número de processos já concluídos
+// (ou rejeitados) do motor; só compacta quando compensa.
+void active_compact(ActiveSet *s, const Process *list, int completed);
+// Primeira posição com índice > idx (size se não houver): início da procura
+// circular a seguir ao último escolhido.
+int  active_after(const ActiveSet *s, int idx);
+
+#endif
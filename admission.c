@@ -0,0 +1,123 @@
+#include "admission.h"
+#include "stats.h"
+#include <stdlib.h>
+#include <limits.h>
+
+static int compare_int(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static void tree_build(AdmissionTree *t, int node, int l, int r) {
+    t->sum[node] = 0;
+    if (l == r) { t->best[node] = -(long long)t->deadlines[l]; return; }
+    int m = (l + r) / 2;
+    tree_build(t, 2 * node, l, m);
+    tree_build(t, 2 * node + 1, m + 1, r);
+    long long left_best = t->best[2 * node];
+    long long right_best = t->sum[2 * node] + t->best[2 * node + 1];
+    t->best[node] = (left_best > right_best) ? left_best : right_best;
+}
+
+static void tree_add(AdmissionTree *t, int node, int l, int r, int leaf, long long delta) {
+    if (l == r) {
+        t->sum[node] += delta;
+        t->best[node] = t->sum[node] - t->deadlines[l];
+        return;
+    }
+    int m = (l + r) / 2;
+    if (leaf <= m) tree_add(t, 2 * node, l, m, leaf, delta);
+    else tree_add(t, 2 * node + 1, m + 1, r, leaf, delta);
+    t->sum[node] = t->sum[2 * node] + t->sum[2 * node + 1];
+    long long left_best = t->best[2 * node];
+    long long right_best = t->sum[2 * node] + t->best[2 * node + 1];
+    t->best[node] = (left_best > right_best) ? left_best : right_best;
+}
+
+// Combina (soma, melhor) das folhas [ql, r] do nó; devolve o melhor e acumula a soma.
+static long long tree_query_suffix(const AdmissionTree *t, int node, int l, int r, int ql, long long *sum_out) {
+    if (r < ql) { *sum_out = 0; return LLONG_MIN; }
+    if (l >= ql) { *sum_out = t->sum[node]; return t->best[node]; }
+    int m = (l + r) / 2;
+    long long left_sum, right_sum;
+    long long left_best = tree_query_suffix(t, 2 * node, l, m, ql, &left_sum);
+    long long right_best = tree_query_suffix(t, 2 * node + 1, m + 1, r, ql, &right_sum);
+    *sum_out = left_sum + right_sum;
+    if (right_best != LLONG_MIN) right_best += left_sum;
+    return (left_best > right_best) ? left_best : right_best;
+}
+
+int admission_init(AdmissionTree *t, SimContext *arena, Process *list, int count) {
+    t->arena = arena;
+    t->deadlines = simctx_alloc(t->arena, sizeof(int) * (count > 0 ? count : 1));
+    t->leaf_of = simctx_alloc(t->arena, sizeof(int) * (count > 0 ? count : 1));
+    t->charged = simctx_calloc(t->arena, count > 0 ? count : 1, sizeof(long long));
+    t->sum = NULL; t->best = NULL;
+    if (!t->deadlines || !t->leaf_of || !t->charged) { admission_free(t); return 0; }
+
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        if (list[i].spec->deadline > 0) t->deadlines[n++] = list[i].spec->deadline;
+    }
+    qsort(t->deadlines, n, sizeof(int), compare_int);
+    int distinct = 0;
+    for (int i = 0; i < n; i++) {
+        if (distinct == 0 || t->deadlines[distinct - 1] != t->deadlines[i]) t->deadlines[distinct++] = t->deadlines[i];
+    }
+    t->leaves = distinct;
+
+    for (int i = 0; i < count; i++) {
+        t->leaf_of[i] = -1;
+        if (list[i].spec->deadline <= 0) continue;
+        int lo = 0, hi = distinct - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (t->deadlines[mid] < list[i].spec->deadline) lo = mid + 1; else hi = mid;
+        }
+        t->leaf_of[i] = lo;
+    }
+
+    if (distinct > 0) {
+        t->sum = simctx_calloc(t->arena, 4 * distinct, sizeof(long long));
+        t->best = simctx_calloc(t->arena, 4 * distinct, sizeof(long long));
+        if (!t->sum || !t->best) { admission_free(t); return 0; }
+        tree_build(t, 1, 0, distinct - 1);
+    }
+    return 1;
+}
+
+void admission_free(AdmissionTree *t) {
+    simctx_free(t->arena, t->deadlines); simctx_free(t->arena, t->leaf_of); simctx_free(t->arena, t->charged); simctx_free(t->arena, t->sum); simctx_free(t->arena, t->best);
+    t->deadlines = NULL; t->leaf_of = NULL; t->charged = NULL; t->sum = NULL; t->best = NULL;
+    t->leaves = 0;
+}
+
+int admission_has_deadline(const AdmissionTree *t, int idx) {
+    return t->leaf_of[idx] != -1;
+}
+
+// Define o trabalho restante que o processo idx contribui para a procura. O(log n).
+void admission_charge(AdmissionTree *t, int idx, long long remaining) {
+    int leaf = t->leaf_of[idx];
+    if (leaf == -1) return;
+    long long delta = remaining - t->charged[idx];
+    if (delta == 0) return;
+    t->charged[idx] = remaining;
+    tree_add(t, 1, 0, t->leaves - 1, leaf, delta);
+}
+
+// Apenas deadlines ainda futuros são verificados; o trabalho de jobs já
+// atrasados continua a contar na soma de prefixo, porque EDF ainda os executa.
+int admission_feasible(const AdmissionTree *t, long long now) {
+    if (t->leaves == 0) return 1;
+    int lo = 0, hi = t->leaves;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (t->deadlines[mid] <= now) lo = mid + 1; else hi = mid;
+    }
+    if (lo >= t->leaves) return 1;
+    long long suffix_sum;
+    long long best = tree_query_suffix(t, 1, 0, t->leaves - 1, lo, &suffix_sum);
+    long long prefix = t->sum[1] - suffix_sum;
+    return now + prefix + best <= 0;
+}
@@ -0,0 +1,29 @@
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include "process.h"
+#include "simctx.h"
+
+// Perfil de procura EDF mantido incrementalmente numa árvore de segmentos
+// sobre os deadlines absolutos distintos da carga. Cada folha k guarda a soma
+// C_k da procura restante (CPU, trocas de contexto e I/O previstos, ver
+// edf_admission_demand) dos jobs admitidos com deadline D_k; cada nó guarda
+// (soma, melhor) com melhor = max_k (soma de prefixo até k - D_k). O conjunto
+// admitido é viável no instante 'now' sse now + max_{D_k > now}(...) <= 0.
+typedef struct {
+    SimContext *arena;      // origem da memória (NULL = malloc)
+    int leaves;
+    int *deadlines;         // deadlines distintos, ordenados
+    long long *sum;         // nós da árvore (4 * leaves)
+    long long *best;
+    int *leaf_of;           // folha de cada processo (-1 se sem deadline)
+    long long *charged;     // trabalho de cada processo atualmente na árvore
+} AdmissionTree;
+
+int  admission_init(AdmissionTree *t, SimContext *arena, Process *list, int count);
+void admission_free(AdmissionTree *t);
+void admission_charge(AdmissionTree *t, int idx, long long remaining);
+int  admission_feasible(const AdmissionTree *t, long long now);
+int  admission_has_deadline(const AdmissionTree *t, int idx);
+
+#endif
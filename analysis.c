@@ -0,0 +1,272 @@
+#define _POSIX_C_SOURCE 200809L
+#include "analysis.h"
+#include "stats.h"
+#include <math.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+
+typedef struct {
+    long long c;
+    long long t;
+    long long d;
+    int id;
+} AnalysisTask;
+
+static int compare_task_period(const void *a, const void *b) {
+    const AnalysisTask *t1 = (const AnalysisTask *)a;
+    const AnalysisTask *t2 = (const AnalysisTask *)b;
+    if (t1->t != t2->t) return (t1->t < t2->t) ? -1 : 1;
+    return t1->id - t2->id;
+}
+
+static double elapsed_ms_since(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000.0 + (now.tv_nsec - start->tv_nsec) / 1.0e6;
+}
+
+// Análise do tempo de resposta (iteração de ponto fixo) com prioridades RM:
+// R = C_i + soma_{j em hp(i)} ceil(R / T_j) * C_j. Pára na primeira tarefa que falha.
+// Antes de iterar, cada tarefa é testada com o majorante linear de Bini e
+// Buttazzo, R_ub = (C_i + soma C_j (1 - U_j)) / (1 - soma U_j), que custa O(1)
+// com somas acumuladas; só as tarefas que o excedem pagam a iteração exata.
+static void response_time_analysis(AnalysisTask *tasks, int n, SchedAnalysis *out) {
+    out->rta_verdict = VERDICT_SCHEDULABLE;
+    double hp_util = 0.0;
+    double hp_weighted = 0.0;
+    for (int i = 0; i < n; i++) {
+        double u_i = (double)tasks[i].c / tasks[i].t;
+        if (hp_util < 1.0) {
+            double r_ub = (tasks[i].c + hp_weighted) / (1.0 - hp_util);
+            if (r_ub <= (double)tasks[i].d) {
+                if ((long long)ceil(r_ub) > out->rta_worst_response) {
+                    out->rta_worst_response = (long long)ceil(r_ub);
+                    out->rta_worst_task_id = tasks[i].id;
+                }
+                hp_util += u_i;
+                hp_weighted += tasks[i].c * (1.0 - u_i);
+                continue;
+            }
+        }
+        hp_util += u_i;
+        hp_weighted += tasks[i].c * (1.0 - u_i);
+
+        long long r = tasks[i].c;
+        for (int j = 0; j < i; j++) r += tasks[j].c;
+        for (;;) {
+            if (r > tasks[i].d) break;
+            long long next = tasks[i].c;
+            for (int j = 0; j < i && next <= tasks[i].d; j++) {
+                next += ((r + tasks[j].t - 1) / tasks[j].t) * tasks[j].c;
+            }
+            if (next == r) break;
+            r = next;
+        }
+        if (r > out->rta_worst_response) {
+            out->rta_worst_response = r;
+            out->rta_worst_task_id = tasks[i].id;
+        }
+        if (r > tasks[i].d) {
+            out->rta_verdict = VERDICT_UNSCHEDULABLE;
+            out->rta_failed_task_id = tasks[i].id;
+            return;
+        }
+    }
+}
+
+// Procura do processador h(t) = soma max(0, floor((t - D_i) / T_i) + 1) * C_i.
+static long long processor_demand(const AnalysisTask *tasks, int n, long long t) {
+    long long h = 0;
+    for (int i = 0; i < n; i++) {
+        if (t >= tasks[i].d) h += ((t - tasks[i].d) / tasks[i].t + 1) * tasks[i].c;
+    }
+    return h;
+}
+
+// Maior deadline absoluto estritamente menor que t (-1 se nenhum).
+static long long last_deadline_before(const AnalysisTask *tasks, int n, long long t) {
+    long long best = -1;
+    for (int i = 0; i < n; i++) {
+        if (tasks[i].d >= t) continue;
+        long long k = (t - 1 - tasks[i].d) / tasks[i].t;
+        long long d = tasks[i].d + k * tasks[i].t;
+        if (d > best) best = d;
+    }
+    return best;
+}
+
+#define HYPERPERIOD_LIMIT (LLONG_MAX / 4)
+
+static long long gcd_ll(long long a, long long b) {
+    while (b != 0) { long long r = a % b; a = b; b = r; }
+    return a;
+}
+
+// Teste exato de EDF para deadlines restritos via QPA (Zhang & Burns).
+static void edf_demand_test(AnalysisTask *tasks, int n, SchedAnalysis *out) {
+    if (out->utilization > 1.0) { out->edf_verdict = VERDICT_UNSCHEDULABLE; return; }
+    if (out->implicit_deadlines) { out->edf_verdict = VERDICT_SCHEDULABLE; return; }
+
+    // Teste de densidade (suficiente): soma C / min(D, T) <= 1.
+    double density = 0.0;
+    for (int i = 0; i < n; i++) density += (double)tasks[i].c / (tasks[i].d < tasks[i].t ? tasks[i].d : tasks[i].t);
+    if (density <= 1.0) { out->edf_verdict = VERDICT_SCHEDULABLE; return; }
+
+    // Limite do intervalo a testar: hiperperíodo + D_max e, com U < 1, o de
+    // Baruah (L_a). Sem nenhum dos dois representável o teste fica inconclusivo.
+    long long d_min = LLONG_MAX, d_max = 0, hyper = 1;
+    int hyper_capped = 0;
+    double la_sum = 0.0;
+    for (int i = 0; i < n; i++) {
+        if (tasks[i].d < d_min) d_min = tasks[i].d;
+        if (tasks[i].d > d_max) d_max = tasks[i].d;
+        la_sum += (double)(tasks[i].t - tasks[i].d) * tasks[i].c / tasks[i].t;
+        if (!hyper_capped) {
+            long long g = gcd_ll(hyper, tasks[i].t);
+            if (hyper / g > HYPERPERIOD_LIMIT / tasks[i].t) hyper_capped = 1;
+            else hyper = hyper / g * tasks[i].t;
+        }
+    }
+    long long bound = hyper_capped ? -1 : hyper + d_max;
+    if (out->utilization < 1.0) {
+        double la = la_sum / (1.0 - out->utilization);
+        if (la < (double)HYPERPERIOD_LIMIT) {
+            long long la_bound = (la > (double)d_max) ? (long long)ceil(la) : d_max;
+            if (bound < 0 || la_bound < bound) bound = la_bound;
+        }
+    }
+    if (bound < 0) { out->edf_verdict = VERDICT_UNKNOWN; return; }
+
+    long long t = last_deadline_before(tasks, n, bound + 1);
+    while (t >= 0) {
+        long long h = processor_demand(tasks, n, t);
+        if (h > t) { out->edf_verdict = VERDICT_UNSCHEDULABLE; out->edf_failed_at = t; return; }
+        if (h <= d_min) break;
+        t = (h < t) ? h : last_deadline_before(tasks, n, t);
+    }
+    out->edf_verdict = VERDICT_SCHEDULABLE;
+}
+
+void analyze_task_set(const ProcessSpec *list, int count, int switch_cost, SchedAnalysis *out) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    memset(out, 0, sizeof(*out));
+    out->switch_overhead = 2 * switch_cost;
+    out->implicit_deadlines = 1;
+    out->ll_verdict = VERDICT_UNKNOWN;
+    out->hyperbolic_verdict = VERDICT_UNKNOWN;
+    out->rta_verdict = VERDICT_UNKNOWN;
+    out->edf_verdict = VERDICT_UNKNOWN;
+    out->rta_failed_task_id = -1;
+    out->rta_worst_task_id = -1;
+    out->edf_failed_at = -1;
+    out->synchronous = 1;
+
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        if (list[i].period <= 0) continue;
+        n++;
+        if (list[i].arrival_time != 0) out->synchronous = 0;
+    }
+    out->task_count = n;
+    out->aperiodic_count = count - n;
+    if (n == 0) { out->elapsed_ms = elapsed_ms_since(&start); return; }
+
+    AnalysisTask *tasks = sim_malloc(sizeof(AnalysisTask) * n);
+    if (!tasks) {
+        fprintf(stderr, "Erro: Falha ao alocar memória em analyze_task_set\n");
+        out->elapsed_ms = elapsed_ms_since(&start);
+        return;
+    }
+
+    double product = 1.0;
+    int constrained = 1;
+    int k = 0;
+    for (int i = 0; i < count; i++) {
+        if (list[i].period <= 0) continue;
+        tasks[k].c = list[i].burst_time + out->switch_overhead;
+        tasks[k].t = list[i].period;
+        tasks[k].d = (list[i].deadline > 0) ? list[i].deadline : list[i].period;
+        tasks[k].id = list[i].id;
+        if (tasks[k].d != tasks[k].t) out->implicit_deadlines = 0;
+        if (tasks[k].d > tasks[k].t) constrained = 0;
+        double u = (double)tasks[k].c / tasks[k].t;
+        out->utilization += u;
+        product *= (u + 1.0);
+        k++;
+    }
+    out->ll_bound = n * (pow(2.0, 1.0 / n) - 1.0);
+    out->hyperbolic_product = product;
+
+    // Os limites de Liu-Layland e hiperbólico só são válidos para D == T.
+    if (out->implicit_deadlines) {
+        if (out->utilization <= out->ll_bound) out->ll_verdict = VERDICT_SCHEDULABLE;
+        if (product <= 2.0) out->hyperbolic_verdict = VERDICT_SCHEDULABLE;
+    }
+
+    if (out->utilization > 1.0) {
+        out->rta_verdict = VERDICT_UNSCHEDULABLE;
+        out->rta_skipped = 1;
+    } else if (out->ll_verdict == VERDICT_SCHEDULABLE || out->hyperbolic_verdict == VERDICT_SCHEDULABLE) {
+        out->rta_verdict = VERDICT_SCHEDULABLE;
+        out->rta_skipped = 1;
+    } else if (constrained) {
+        qsort(tasks, n, sizeof(AnalysisTask), compare_task_period);
+        response_time_analysis(tasks, n, out);
+    }
+
+    edf_demand_test(tasks, n, out);
+
+    sim_free(tasks);
+    out->elapsed_ms = elapsed_ms_since(&start);
+}
+
+static const char *verdict_str(int verdict) {
+    if (verdict == VERDICT_SCHEDULABLE) return "ESCALONÁVEL";
+    if (verdict == VERDICT_UNSCHEDULABLE) return "NÃO ESCALONÁVEL";
+    return "inconclusivo";
+}
+
+void print_schedulability_report(const SchedAnalysis *a) {
+    printf("\n--- Análise de Escalonabilidade ---\n");
+    if (a->task_count == 0) {
+        printf("Sem tarefas periódicas (period > 0): análise não aplicável.\n");
+        printf("--------------------------------------------------\n");
+        return;
+    }
+    printf("Tarefas Periódicas:            %d\n", a->task_count);
+    if (a->aperiodic_count > 0) printf("Processos Aperiódicos Ignorados: %d\n", a->aperiodic_count);
+    printf("Overhead por Job (2 x CS):     %d\n", a->switch_overhead);
+    printf("Deadlines Implícitos (D=T):    %s\n", a->implicit_deadlines ? "Sim" : "Não");
+    printf("Libertação Síncrona (t=0):     %s\n", a->synchronous ? "Sim" : "Não (análise do instante crítico)");
+    printf("Utilização Total (U):          %.4f\n", a->utilization);
+    printf("--------------------------------------------------\n");
+    printf("RM Liu-Layland (U <= %.4f):   %s\n", a->ll_bound,
+           a->implicit_deadlines ? verdict_str(a->ll_verdict) : "n/a (D != T)");
+    printf("RM Hiperbólico (Prod = %.4f): %s\n", a->hyperbolic_product,
+           a->implicit_deadlines ? verdict_str(a->hyperbolic_verdict) : "n/a (D != T)");
+    printf("RM Análise Tempo Resposta:     %s%s\n", verdict_str(a->rta_verdict),
+           a->rta_skipped ? " (decidido sem iterar)" : "");
+    if (a->rta_failed_task_id != -1) printf("    Primeira tarefa com R > D:  P%d\n", a->rta_failed_task_id);
+    if (!a->rta_skipped && a->rta_worst_task_id != -1)
+        printf("    Maior R (majorante):        %lld (P%d)\n", a->rta_worst_response, a->rta_worst_task_id);
+    printf("EDF Procura do Processador:    %s\n", verdict_str(a->edf_verdict));
+    if (a->edf_failed_at != -1) printf("    h(t) > t em t =             %lld\n", a->edf_failed_at);
+    printf("--------------------------------------------------\n");
+    printf("Tempo de Análise:              %.3f ms\n", a->elapsed_ms);
+    printf("--------------------------------------------------\n");
+}
+
+// Indica se a análise já garante que a simulação do algoritmo pedido não
+// perde deadlines. Só um veredicto ESCALONÁVEL decide: o custo de 2 trocas
+// por job é um majorante, pelo que um NÃO ESCALONÁVEL pode não se verificar
+// na simulação. As análises assumem todas as tarefas libertadas em t = 0,
+// pelo que com offsets (chegada > 0) a simulação corre sempre.
+int analysis_decides(const SchedAnalysis *a, const char *algorithm) {
+    if (a->task_count == 0 || a->aperiodic_count > 0 || !a->synchronous) return 0;
+    if (strcmp(algorithm, "rm") == 0) return a->rta_verdict == VERDICT_SCHEDULABLE;
+    if (strcmp(algorithm, "edf") == 0) return a->edf_verdict == VERDICT_SCHEDULABLE;
+    return 0;
+}
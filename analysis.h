@@ -0,0 +1,36 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include "process.h"
+
+// Veredictos das análises de escalonabilidade.
+#define VERDICT_UNKNOWN      -1
+#define VERDICT_UNSCHEDULABLE 0
+#define VERDICT_SCHEDULABLE   1
+
+typedef struct {
+    int task_count;             // tarefas periódicas analisadas (period > 0)
+    int aperiodic_count;        // processos ignorados pela análise (period == 0)
+    int switch_overhead;        // custo adicionado a cada C (2 trocas de contexto por job)
+    int implicit_deadlines;     // 1 se D == T para todas as tarefas
+    int synchronous;            // 1 se todas as tarefas são libertadas em t = 0
+    double utilization;         // U = soma (C + overhead) / T
+    double ll_bound;            // n (2^(1/n) - 1)
+    double hyperbolic_product;  // produto (U_i + 1)
+    int ll_verdict;             // suficiente: SCHEDULABLE ou UNKNOWN
+    int hyperbolic_verdict;     // suficiente: SCHEDULABLE ou UNKNOWN
+    int rta_verdict;            // exata para prioridades fixas (RM)
+    int rta_failed_task_id;     // primeira tarefa com R > D (-1 se nenhuma)
+    long long rta_worst_response;
+    int rta_worst_task_id;
+    int rta_skipped;            // 1 se o veredicto RM foi decidido sem iterar a RTA
+    int edf_verdict;            // exata (teste de procura do processador / QPA)
+    long long edf_failed_at;    // instante t com h(t) > t (-1 se nenhum)
+    double elapsed_ms;
+} SchedAnalysis;
+
+void analyze_task_set(const ProcessSpec *list, int count, int switch_cost, SchedAnalysis *out);
+void print_schedulability_report(const SchedAnalysis *a);
+int analysis_decides(const SchedAnalysis *a, const char *algorithm);
+
+#endif
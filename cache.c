@@ -0,0 +1,178 @@
+#define _POSIX_C_SOURCE 200809L
+#include "cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define CACHE_MAGIC "PSCACHE1"
+
+typedef struct {
+    char magic[8];
+    uint32_t version;           // SIM_RESULTS_VERSION
+    uint32_t record_size;
+    uint64_t key;
+} CacheHeader;
+
+uint64_t cache_hash_bytes(uint64_t h, const void *data, size_t n) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+uint64_t cache_hash_int(uint64_t h, long long v) { return cache_hash_bytes(h, &v, sizeof(v)); }
+static uint64_t hash_double(uint64_t h, double v) { return cache_hash_bytes(h, &v, sizeof(v)); }
+
+// Os campos são lidos um a um para não depender do preenchimento das estruturas.
+uint64_t cache_hash_workload(const SimWorkload *workload) {
+    uint64_t h = CACHE_HASH_INIT;
+    h = cache_hash_int(h, workload->count);
+    for (int i = 0; i < workload->count; i++) {
+        const ProcessSpec *p = &workload->processes[i];
+        h = cache_hash_int(h, p->id);
+        h = cache_hash_int(h, p->arrival_time);
+        h = cache_hash_int(h, p->burst_time);
+        h = cache_hash_int(h, p->priority);
+        h = cache_hash_int(h, p->deadline);
+        h = cache_hash_int(h, p->period);
+        h = cache_hash_int(h, p->tickets);
+        h = cache_hash_int(h, p->io_burst_duration);
+        h = cache_hash_int(h, p->phase_count);
+        for (int k = 0; k < p->phase_count; k++) {
+            const Phase *ph = &workload->phases[p->phase_offset + k];
+            h = cache_hash_int(h, ph->cpu_end);
+            h = cache_hash_int(h, ph->io);
+        }
+    }
+    return h;
+}
+
+// Log, trace, Gantt e a arena não mudam os resultados e ficam de fora.
+uint64_t cache_key(uint64_t workload_hash, const SimConfig *cfg) {
+    uint64_t h = CACHE_HASH_INIT;
+    h = cache_hash_int(h, SIM_RESULTS_VERSION);
+    h = cache_hash_int(h, sizeof(SimResults));
+    h = cache_hash_int(h, (long long)workload_hash);
+    h = cache_hash_bytes(h, cfg->algorithm, strlen(cfg->algorithm) + 1);
+    h = cache_hash_int(h, cfg->quantum);
+    h = cache_hash_int(h, cfg->max_simulation_time);
+    h = cache_hash_int(h, (long long)cfg->seed);
+    h = hash_double(h, cfg->pred_alpha);
+    h = hash_double(h, cfg->pred_tau0);
+    h = cache_hash_int(h, cfg->admission_mode);
+    h = cache_hash_int(h, cfg->context_switch_cost);
+    h = cache_hash_int(h, cfg->aging_threshold);
+    h = cache_hash_int(h, cfg->aging_interval);
+    for (int k = 0; k < MLQ_RR_LEVELS; k++) h = cache_hash_int(h, cfg->mlq_quantum[k]);
+    h = cache_hash_int(h, cfg->io_device_count);
+    for (int k = 0; k < cfg->io_device_count; k++) {
+        h = cache_hash_int(h, cfg->io_devices[k].discipline);
+        h = hash_double(h, cfg->io_devices[k].rate);
+        h = cache_hash_int(h, cfg->io_devices[k].full_seek);
+    }
+    return h;
+}
+
+static int make_dir(const char *path) {
+    return mkdir(path, 0755) == 0 || errno == EEXIST;
+}
+
+int cache_open(ResultCache *cache, const char *dir) {
+    memset(cache, 0, sizeof(*cache));
+    if (dir) {
+        snprintf(cache->dir, sizeof(cache->dir), "%s", dir);
+    } else {
+        const char *xdg = getenv("XDG_CACHE_HOME");
+        const char *home = getenv("HOME");
+        char parent[sizeof(cache->dir) - 16];
+        if (xdg && xdg[0]) snprintf(parent, sizeof(parent), "%s", xdg);
+        else if (home && home[0]) snprintf(parent, sizeof(parent), "%s/.cache", home);
+        else {
+            fprintf(stderr, "Aviso: Sem HOME nem XDG_CACHE_HOME; cache de resultados desligada.\n");
+            return 0;
+        }
+        make_dir(parent);
+        snprintf(cache->dir, sizeof(cache->dir), "%s/probsched", parent);
+    }
+    if (!make_dir(cache->dir)) {
+        fprintf(stderr, "Aviso: Não foi possível criar a cache '%s' (%s); cache de resultados desligada.\n",
+                cache->dir, strerror(errno));
+        return 0;
+    }
+    cache->enabled = 1;
+    return 1;
+}
+
+static void entry_path(const ResultCache *cache, uint64_t key, char *buf, size_t size) {
+    snprintf(buf, size, "%s/%016llx.res", cache->dir, (unsigned long long)key);
+}
+
+static int cache_load(const ResultCache *cache, uint64_t key, SimResults *out) {
+    char path[sizeof(cache->dir) + 32];
+    entry_path(cache, key, path, sizeof(path));
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+    CacheHeader hdr;
+    int ok = fread(&hdr, sizeof(hdr), 1, f) == 1 && memcmp(hdr.magic, CACHE_MAGIC, 8) == 0 &&
+             hdr.version == SIM_RESULTS_VERSION && hdr.record_size == sizeof(SimResults) && hdr.key == key &&
+             fread(out, sizeof(SimResults), 1, f) == 1;
+    fclose(f);
+    return ok;
+}
+
+// Escreve num temporário da mesma diretoria e renomeia: quem ler a entrada
+// vê-a completa ou não a vê.
+static void cache_store(ResultCache *cache, uint64_t key, const SimResults *res) {
+    char path[sizeof(cache->dir) + 32];
+    char tmp[sizeof(cache->dir) + 32];
+    entry_path(cache, key, path, sizeof(path));
+    snprintf(tmp, sizeof(tmp), "%s/.tmp-XXXXXX", cache->dir);
+
+    int fd = mkstemp(tmp);
+    FILE *f = fd >= 0 ? fdopen(fd, "wb") : NULL;
+    int ok = 0;
+    if (f) {
+        CacheHeader hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        memcpy(hdr.magic, CACHE_MAGIC, 8);
+        hdr.version = SIM_RESULTS_VERSION;
+        hdr.record_size = sizeof(SimResults);
+        hdr.key = key;
+        ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 && fwrite(res, sizeof(SimResults), 1, f) == 1;
+        ok = (fclose(f) == 0) && ok;
+    } else if (fd >= 0) {
+        close(fd);
+    }
+    if (ok) ok = rename(tmp, path) == 0;
+    if (!ok) {
+        if (fd >= 0) unlink(tmp);
+        // Sem escrita na diretoria não vale a pena continuar a tentar.
+        if (__atomic_exchange_n(&cache->enabled, 0, __ATOMIC_SEQ_CST)) {
+            fprintf(stderr, "Aviso: Falha ao escrever na cache '%s'; cache de resultados desligada.\n", cache->dir);
+        }
+    }
+}
+
+int cache_simulate(ResultCache *cache, uint64_t workload_hash, const SimWorkload *workload,
+                   const SimConfig *cfg, SimResults *results) {
+    // Uma ramificação muda os parâmetros a meio e não entra na chave; com
+    // checkpoints ou retoma a simulação tem de correr.
+    if (!cache || cfg->on_branch || cfg->checkpoint_path || cfg->resume_path || !__atomic_load_n(&cache->enabled, __ATOMIC_SEQ_CST)) {
+        return simulate(workload, cfg, results);
+    }
+
+    uint64_t key = cache_key(workload_hash, cfg);
+    if (cache_load(cache, key, results)) {
+        __atomic_fetch_add(&cache->hits, 1, __ATOMIC_SEQ_CST);
+        return results->status;
+    }
+    __atomic_fetch_add(&cache->misses, 1, __ATOMIC_SEQ_CST);
+    int status = simulate(workload, cfg, results);
+    if (status == SIM_OK) cache_store(cache, key, results);
+    return status;
+}
@@ -0,0 +1,41 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdint.h>
+#include "probsched.h"
+
+// Cache de resultados em disco, endereçada pelo conteúdo: a chave de uma
+// simulação é um hash (FNV-1a 64) da carga (processos e fases, seja qual for
+// a origem: ficheiro ou gerador com a sua semente), de todos os campos da
+// configuração que afetam o resultado e de SIM_RESULTS_VERSION. Cada entrada
+// é um ficheiro <chave>.res com um cabeçalho e o SimResults; entradas de
+// outra versão ou com outro tamanho de registo são ignoradas. A escrita é
+// feita num temporário e renomeada, pelo que várias threads ou processos
+// podem partilhar a mesma diretoria.
+#define CACHE_HASH_INIT 14695981039346656037ULL
+
+typedef struct {
+    char dir[512];
+    int enabled;
+    long long hits;
+    long long misses;       // simulados (e guardados, se correram bem)
+} ResultCache;
+
+uint64_t cache_hash_bytes(uint64_t h, const void *data, size_t n);
+uint64_t cache_hash_int(uint64_t h, long long v);
+uint64_t cache_hash_workload(const SimWorkload *workload);
+// Chave de uma simulação da carga com hash 'workload_hash' e configuração 'cfg'.
+uint64_t cache_key(uint64_t workload_hash, const SimConfig *cfg);
+
+// dir == NULL usa $XDG_CACHE_HOME/probsched ou ~/.cache/probsched. Se a
+// diretoria não puder ser criada avisa no stderr, deixa a cache desligada e
+// devolve 0.
+int  cache_open(ResultCache *cache, const char *dir);
+
+// Simula, ou devolve o resultado guardado para a mesma chave. Só resultados
+// SIM_OK são guardados. cache == NULL (ou desligada), ramificações, checkpoints
+// e retoma chamam simulate().
+int  cache_simulate(ResultCache *cache, uint64_t workload_hash, const SimWorkload *workload,
+                    const SimConfig *cfg, SimResults *results);
+
+#endif
@@ -0,0 +1,460 @@
+#define _POSIX_C_SOURCE 200809L
+#include "checkpoint.h"
+#include "cache.h"
+#include "stats.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define CHECKPOINT_MAGIC   "PSCKPT01"
+#define CHECKPOINT_VERSION 1
+
+enum { STATE_BYTES, STATE_PROCESSES, STATE_HEAP, STATE_FENWICK, STATE_IODEV };
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t entries;
+    uint64_t identity;       // chave da simulação (carga e configuração)
+    uint64_t layout;         // tamanhos das regiões, pela ordem de registo
+    uint64_t payload_size;
+    uint64_t checksum;       // FNV-1a das regiões
+    int64_t time;            // instante simulado do checkpoint
+} CheckpointHeader;
+
+typedef struct {
+    int kind;
+    void *ptr;
+    size_t size;             // bytes (STATE_BYTES) ou número de processos
+} StateEntry;
+
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+} StateBuffer;
+
+struct SimState {
+    StateEntry entries[CHECKPOINT_MAX_ENTRIES];
+    int count;
+    int overflow;
+    uint64_t identity;
+
+    // Disparo.
+    int every;
+    int every_ms;
+    int next_time;
+    double last_ms;
+
+    // Checkpoint a retomar (lido por sim_state_open).
+    unsigned char *resume;
+    CheckpointHeader resume_header;
+
+    // Escrita em segundo plano: o motor enche um buffer e entrega-o em
+    // 'pending'; a thread escreve-o a partir de 'writing'.
+    const char *path;
+    StateBuffer buffers[2];
+    int pending;             // índice do buffer à espera (-1 = nenhum)
+    int writing;             // índice do buffer em escrita (-1 = nenhum)
+    int quit;
+    int error;               // errno da última falha de escrita
+    int warned;
+    long long written;
+    long long skipped;
+    pthread_t thread;
+    int started;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+};
+
+// Percorre as regiões registadas: copia-as para 'out' (salvar), de 'in'
+// (repor) ou só mede; 'layout' acumula os tamanhos.
+typedef struct {
+    unsigned char *out;
+    const unsigned char *in;
+    size_t offset;
+    uint64_t layout;
+} StateCursor;
+
+static void region(StateCursor *c, void *ptr, size_t n) {
+    c->layout = cache_hash_int(c->layout, (long long)n);
+    if (n == 0) return;
+    if (c->out) memcpy(c->out + c->offset, ptr, n);
+    else if (c->in) memcpy(ptr, c->in + c->offset, n);
+    c->offset += n;
+}
+
+#define REGION(c, var) region((c), &(var), sizeof(var))
+
+static void walk_heap(StateCursor *c, IndexedHeap *h) {
+    size_t cap = (size_t)h->capacity;
+    REGION(c, h->size);
+    region(c, h->heap, cap * sizeof(int));
+    region(c, h->pos, cap * sizeof(int));
+    region(c, h->key, cap * sizeof(long long));
+    region(c, h->tiebreak, cap * sizeof(long long));
+}
+
+// Os processos guardam-se inteiros; ao repor mantêm-se as referências para
+// a carga desta execução. As linhas de resultado voltam a ficar por entregar.
+static void walk_processes(StateCursor *c, Process *list, size_t count) {
+    c->layout = cache_hash_int(c->layout, (long long)sizeof(Process));
+    if (!c->in) {
+        region(c, list, count * sizeof(Process));
+        return;
+    }
+    c->layout = cache_hash_int(c->layout, (long long)(count * sizeof(Process)));
+    for (size_t i = 0; i < count; i++) {
+        const ProcessSpec *spec = list[i].spec;
+        const struct Phase *phases = list[i].phases;
+        memcpy(&list[i], c->in + c->offset, sizeof(Process));
+        c->offset += sizeof(Process);
+        list[i].spec = spec;
+        list[i].phases = phases;
+        list[i].result_reported = 0;
+    }
+}
+
+static void walk_iodev(StateCursor *c, IoDevices *io) {
+    c->layout = cache_hash_int(c->layout, io->count);
+    for (int k = 0; k < io->count; k++) {
+        IoDevice *d = &io->devices[k];
+        REGION(c, d->queued);
+        REGION(c, d->direction);
+        REGION(c, d->head);
+        REGION(c, d->busy_idx);
+        REGION(c, d->busy_start);
+        REGION(c, d->busy_until);
+        REGION(c, d->requests);
+        REGION(c, d->busy_time);
+        REGION(c, d->queue_delay_sum);
+        REGION(c, d->queue_delay_max);
+        REGION(c, d->queue_max);
+        walk_heap(c, &d->queue);
+        walk_heap(c, &d->next_sweep);
+    }
+    if (io->count > 0) {
+        size_t n = (size_t)io->devices[0].queue.capacity;
+        region(c, io->req_submit, n * sizeof(int));
+        region(c, io->req_track, n * sizeof(int));
+        region(c, io->req_duration, n * sizeof(int));
+    }
+    REGION(c, io->submit_seq);
+}
+
+static void walk(SimState *st, StateCursor *c) {
+    for (int k = 0; k < st->count; k++) {
+        StateEntry *e = &st->entries[k];
+        c->layout = cache_hash_int(c->layout, e->kind);
+        switch (e->kind) {
+            case STATE_BYTES:     region(c, e->ptr, e->size); break;
+            case STATE_PROCESSES: walk_processes(c, e->ptr, e->size); break;
+            case STATE_HEAP:      walk_heap(c, e->ptr); break;
+            case STATE_FENWICK: {
+                Fenwick *fw = e->ptr;
+                region(c, fw->tree, (size_t)(fw->size + 1) * sizeof(long long));
+                region(c, fw->value, (size_t)(fw->size > 0 ? fw->size : 1) * sizeof(long long));
+                break;
+            }
+            case STATE_IODEV:     walk_iodev(c, e->ptr); break;
+        }
+    }
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1.0e3 + ts.tv_nsec / 1.0e6;
+}
+
+// Temporário na mesma diretoria, fsync e rename: o ficheiro tem sempre um
+// checkpoint completo, o anterior ou o novo. Devolve 0 ou o errno.
+static int write_atomic(const char *path, const unsigned char *data, size_t size) {
+    char tmp[4096];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp)) return ENAMETOOLONG;
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return errno;
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = write(fd, data + done, size - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            int err = errno;
+            close(fd); unlink(tmp);
+            return err;
+        }
+        done += (size_t)n;
+    }
+    if (fsync(fd) != 0 || close(fd) != 0) {
+        int err = errno;
+        unlink(tmp);
+        return err;
+    }
+    if (rename(tmp, path) != 0) {
+        int err = errno;
+        unlink(tmp);
+        return err;
+    }
+    return 0;
+}
+
+static void *writer_main(void *arg) {
+    SimState *st = arg;
+    pthread_mutex_lock(&st->lock);
+    for (;;) {
+        while (st->pending < 0 && !st->quit) pthread_cond_wait(&st->wake, &st->lock);
+        if (st->pending < 0) break;
+        st->writing = st->pending;
+        st->pending = -1;
+        StateBuffer *buf = &st->buffers[st->writing];
+        pthread_mutex_unlock(&st->lock);
+        // O checksum é calculado aqui para não atrasar o motor.
+        CheckpointHeader *hdr = (CheckpointHeader *)buf->data;
+        hdr->checksum = cache_hash_bytes(CACHE_HASH_INIT, buf->data + sizeof(CheckpointHeader), hdr->payload_size);
+        int err = write_atomic(st->path, buf->data, buf->size);
+        pthread_mutex_lock(&st->lock);
+        st->writing = -1;
+        if (err) st->error = err;
+        else st->written++;
+    }
+    pthread_mutex_unlock(&st->lock);
+    return NULL;
+}
+
+static void warn_write_error(SimRun *run) {
+    SimState *st = run->state;
+    pthread_mutex_lock(&st->lock);
+    int err = st->error;
+    pthread_mutex_unlock(&st->lock);
+    if (err && !st->warned) {
+        st->warned = 1;
+        sim_warn(run, "Aviso: Falha ao escrever o checkpoint '%s': %s\n", st->path, strerror(err));
+    }
+}
+
+static void state_save(SimRun *run, int current_time) {
+    SimState *st = run->state;
+    if (st->overflow) return;
+    warn_write_error(run);
+    if (!st->started) {
+        if (pthread_create(&st->thread, NULL, writer_main, st) != 0) {
+            if (!st->warned) sim_warn(run, "Aviso: Sem thread de escrita; checkpoints desligados.\n");
+            st->warned = 1;
+            st->path = NULL;
+            return;
+        }
+        st->started = 1;
+    }
+
+    // Com um buffer em escrita e o outro à espera, este checkpoint é saltado:
+    // a cópia do estado nunca espera pelo disco.
+    pthread_mutex_lock(&st->lock);
+    int busy = st->pending >= 0;
+    int slot = (st->writing == 0) ? 1 : 0;
+    if (busy) st->skipped++;
+    pthread_mutex_unlock(&st->lock);
+    if (busy) return;
+
+    StateCursor c = { NULL, NULL, 0, CACHE_HASH_INIT };
+    walk(st, &c);
+    StateBuffer *buf = &st->buffers[slot];
+    size_t size = sizeof(CheckpointHeader) + c.offset;
+    if (size > buf->capacity) {
+        unsigned char *data = sim_realloc(buf->data, size);
+        if (!data) {
+            sim_warn(run, "Aviso: Memória insuficiente para o checkpoint em t=%d\n", current_time);
+            return;
+        }
+        buf->data = data;
+        buf->capacity = size;
+    }
+    StateCursor save = { buf->data + sizeof(CheckpointHeader), NULL, 0, CACHE_HASH_INIT };
+    walk(st, &save);
+
+    CheckpointHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, CHECKPOINT_MAGIC, 8);
+    hdr.version = CHECKPOINT_VERSION;
+    hdr.entries = (uint32_t)st->count;
+    hdr.identity = st->identity;
+    hdr.layout = save.layout;
+    hdr.payload_size = save.offset;
+    hdr.time = current_time;
+    memcpy(buf->data, &hdr, sizeof(hdr));
+    buf->size = size;
+
+    pthread_mutex_lock(&st->lock);
+    st->pending = slot;
+    pthread_cond_signal(&st->wake);
+    pthread_mutex_unlock(&st->lock);
+}
+
+// Próximo disparo: o instante simulado entra em hook_time e o relógio é
+// consultado a cada CHECKPOINT_CLOCK_STEPS passos.
+static void state_arm(SimRun *run) {
+    SimState *st = run->state;
+    if (!st->path) return;
+    if (st->every > 0 && st->next_time < run->hook_time) run->hook_time = st->next_time;
+    if (st->every_ms > 0) run->hook_steps = CHECKPOINT_CLOCK_STEPS;
+}
+
+void sim_state_tick(SimRun *run, int current_time) {
+    SimState *st = run->state;
+    if (!st->path) return;
+    int due = 0;
+    if (st->every > 0 && current_time >= st->next_time) {
+        due = 1;
+        st->next_time = current_time + st->every;
+    }
+    if (st->every_ms > 0 && now_ms() - st->last_ms >= st->every_ms) due = 1;
+    if (due) {
+        state_save(run, current_time);
+        st->last_ms = now_ms();
+    }
+    state_arm(run);
+}
+
+static int read_resume(SimRun *run, SimState *st, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        sim_fail(run, SIM_ERR_CHECKPOINT, "Erro ao abrir o checkpoint '%s': %s\n", path, strerror(errno));
+        return 0;
+    }
+    CheckpointHeader *hdr = &st->resume_header;
+    int ok = fread(hdr, sizeof(*hdr), 1, f) == 1 && memcmp(hdr->magic, CHECKPOINT_MAGIC, 8) == 0 &&
+             hdr->version == CHECKPOINT_VERSION;
+    if (!ok) {
+        fclose(f);
+        sim_fail(run, SIM_ERR_CHECKPOINT, "Erro: '%s' não é um checkpoint desta versão do simulador.\n", path);
+        return 0;
+    }
+    if (hdr->identity != st->identity) {
+        fclose(f);
+        sim_fail(run, SIM_ERR_CHECKPOINT, "Erro: O checkpoint '%s' pertence a outra simulação (carga ou configuração diferentes).\n", path);
+        return 0;
+    }
+    st->resume = sim_malloc(hdr->payload_size > 0 ? hdr->payload_size : 1);
+    ok = st->resume && fread(st->resume, 1, hdr->payload_size, f) == hdr->payload_size &&
+         cache_hash_bytes(CACHE_HASH_INIT, st->resume, hdr->payload_size) == hdr->checksum;
+    fclose(f);
+    if (!ok) {
+        sim_fail(run, SIM_ERR_CHECKPOINT, "Erro: O checkpoint '%s' está truncado ou corrompido.\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+int sim_state_open(SimRun *run, const SimWorkload *workload) {
+    const SimConfig *cfg = run->config;
+    int checkpoints = cfg->checkpoint_path && cfg->checkpoint_path[0] != '\0' &&
+                      (cfg->checkpoint_every > 0 || cfg->checkpoint_every_ms > 0);
+    if (!checkpoints && !cfg->resume_path) return 1;
+
+    SimState *st = sim_calloc(1, sizeof(SimState));
+    if (!st) {
+        sim_fail(run, SIM_ERR_MEMORY, "Erro malloc checkpoint\n");
+        return 0;
+    }
+    run->state = st;
+    st->identity = cache_key(cache_hash_workload(workload), cfg);
+    st->path = checkpoints ? cfg->checkpoint_path : NULL;
+    st->every = cfg->checkpoint_every;
+    st->every_ms = cfg->checkpoint_every_ms;
+    st->next_time = st->every;
+    st->last_ms = now_ms();
+    st->pending = -1;
+    st->writing = -1;
+    pthread_mutex_init(&st->lock, NULL);
+    pthread_cond_init(&st->wake, NULL);
+
+    if (cfg->resume_path && !read_resume(run, st, cfg->resume_path)) return 0;
+
+    // Estado da execução que não pertence a nenhum motor.
+    SIM_STATE(run, run->rng);
+    SIM_STATE(run, run->switch_cost);
+    SIM_STATE(run, run->aging_threshold);
+    SIM_STATE(run, run->aging_interval);
+    SIM_STATE(run, run->quantum);
+    SIM_STATE(run, run->mlq_quantum);
+    SIM_STATE(run, run->results->status);
+    sim_state_bytes(run, run->classes, sizeof(ClassStats));
+    st->entries[st->count++] = (StateEntry){ STATE_IODEV, &run->io, 0 };
+    state_arm(run);
+    return 1;
+}
+
+void sim_state_close(SimRun *run) {
+    SimState *st = run->state;
+    if (!st) return;
+    if (st->started) {
+        pthread_mutex_lock(&st->lock);
+        st->quit = 1;
+        pthread_cond_signal(&st->wake);
+        pthread_mutex_unlock(&st->lock);
+        pthread_join(st->thread, NULL);
+        warn_write_error(run);
+    }
+    run->results->checkpoints_written = st->written;
+    run->results->checkpoints_skipped = st->skipped;
+    pthread_mutex_destroy(&st->lock);
+    pthread_cond_destroy(&st->wake);
+    sim_free(st->buffers[0].data);
+    sim_free(st->buffers[1].data);
+    sim_free(st->resume);
+    sim_free(st);
+    run->state = NULL;
+}
+
+static void add_entry(SimRun *run, int kind, void *ptr, size_t size) {
+    SimState *st = run->state;
+    if (!st) return;
+    if (st->count == CHECKPOINT_MAX_ENTRIES) {
+        st->overflow = 1;
+        return;
+    }
+    st->entries[st->count++] = (StateEntry){ kind, ptr, size };
+}
+
+void sim_state_bytes(SimRun *run, void *ptr, size_t size) { add_entry(run, STATE_BYTES, ptr, size); }
+void sim_state_processes(SimRun *run, Process *list, int count) { add_entry(run, STATE_PROCESSES, list, (size_t)count); }
+void sim_state_heap(SimRun *run, IndexedHeap *h) { add_entry(run, STATE_HEAP, h, 0); }
+void sim_state_fenwick(SimRun *run, Fenwick *fw) { add_entry(run, STATE_FENWICK, fw, 0); }
+
+int sim_state_ready(SimRun *run) {
+    SimState *st = run->state;
+    if (!st) return 1;
+    if (st->overflow) {
+        sim_fail(run, SIM_ERR_CHECKPOINT, "Erro: Estado do motor excede %d regiões de checkpoint.\n", CHECKPOINT_MAX_ENTRIES);
+        return 0;
+    }
+    if (!st->resume) return 1;
+
+    const CheckpointHeader *hdr = &st->resume_header;
+    StateCursor measure = { NULL, NULL, 0, CACHE_HASH_INIT };
+    walk(st, &measure);
+    if (hdr->entries != (uint32_t)st->count || hdr->layout != measure.layout || hdr->payload_size != measure.offset) {
+        sim_fail(run, SIM_ERR_CHECKPOINT, "Erro: O checkpoint '%s' não corresponde ao estado deste motor.\n",
+                 run->config->resume_path);
+        return 0;
+    }
+    StateCursor restore = { NULL, st->resume, 0, CACHE_HASH_INIT };
+    walk(st, &restore);
+    sim_free(st->resume);
+    st->resume = NULL;
+
+    // O checkpoint foi tirado no início deste passo: o próximo dispara mais à frente.
+    int t = (int)hdr->time;
+    run->results->resumed_time = t;
+    st->next_time = t + st->every;
+    st->last_ms = now_ms();
+    run->hook_time = run->branch_time;
+    state_arm(run);
+    sim_log(run, "\nRetomado do checkpoint '%s' em t=%d\n", run->config->resume_path, t);
+    return 1;
+}
@@ -0,0 +1,48 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "sim.h"
+#include "fenwick.h"
+
+// Checkpoint e retoma de uma execução (SimConfig.checkpoint_*, resume_path).
+// Antes do ciclo principal, cada motor regista o estado que transporta de um
+// passo para o seguinte: variáveis locais, vetores, a lista de processos,
+// heaps e árvores. Os parâmetros de execução, o gerador, o estado da
+// execução, as métricas por classe e os dispositivos de I/O são registados
+// por simulate(). O checkpoint é tirado em sim_checkpoint, no início de um
+// passo, pelo que repor esse estado e continuar o ciclo reproduz a mesma
+// execução e os mesmos resultados finais.
+//
+// O ficheiro tem um cabeçalho (identidade da simulação, hash da disposição
+// das regiões, instante e checksum) seguido das regiões pela ordem de
+// registo, sem ponteiros. O motor serializa para um de dois buffers e uma
+// thread escreve-o num temporário e renomeia-o (fsync antes), sem parar a
+// simulação; com um checkpoint em escrita e outro à espera, os seguintes são
+// saltados até haver um buffer livre. O trace, o Gantt e os contadores de
+// --stats de uma execução retomada só cobrem a parte retomada; as linhas dos
+// processos terminados antes do checkpoint são entregues no fim.
+#define CHECKPOINT_MAX_ENTRIES 48
+#define CHECKPOINT_CLOCK_STEPS 4096   // passos entre consultas do relógio
+
+typedef struct SimState SimState;
+
+// Chamadas por simulate(). sim_state_open prepara o registo e lê o
+// checkpoint a retomar; devolve 0 (com a execução falhada) se não servir.
+int  sim_state_open(SimRun *run, const SimWorkload *workload);
+// Espera pela última escrita e preenche os contadores dos resultados.
+void sim_state_close(SimRun *run);
+// Chamada por sim_hook: tira o checkpoint se estiver na altura e rearma.
+void sim_state_tick(SimRun *run, int current_time);
+
+// Registo (sem efeito se os checkpoints estiverem desligados).
+void sim_state_bytes(SimRun *run, void *ptr, size_t size);
+#define SIM_STATE(run, var) sim_state_bytes((run), &(var), sizeof(var))
+void sim_state_processes(SimRun *run, Process *list, int count);
+void sim_state_heap(SimRun *run, IndexedHeap *h);
+void sim_state_fenwick(SimRun *run, Fenwick *fw);
+// Fecha o registo e, ao retomar, repõe o estado. Devolve 0 se o checkpoint
+// não corresponder ao estado registado (a execução fica falhada e o motor
+// deve terminar o ciclo sem passos).
+int  sim_state_ready(SimRun *run);
+
+#endif
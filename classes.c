@@ -0,0 +1,91 @@
+#include "classes.h"
+#include <string.h>
+
+// Balde de v: exato abaixo de 8; acima, a oitava e e os 3 bits seguintes ao
+// mais significativo.
+static int hist_bin(int v) {
+    if (v < 8) return v > 0 ? v : 0;
+    int e = 3;
+    while (e < 30 && (v >> (e + 1)) != 0) e++;
+    return 8 + (e - 3) * 8 + ((v >> (e - 3)) & 7);
+}
+
+// Ponto médio do balde (o próprio valor nos exatos).
+static double hist_value(int bin) {
+    if (bin < 8) return bin;
+    int e = 3 + (bin - 8) / 8, sub = (bin - 8) % 8;
+    long long width = 1LL << (e - 3);
+    return (double)((8 + sub) * width) + (width - 1) / 2.0;
+}
+
+// Percentil pct (ordem mais próxima, como o P99 global) de n amostras.
+static double hist_percentile(const int *hist, long long n, int pct) {
+    if (n <= 0) return 0.0;
+    long long rank = (pct * n + 99) / 100, seen = 0;
+    for (int b = 0; b < CLASS_HIST_BINS; b++) {
+        seen += hist[b];
+        if (seen >= rank) return hist_value(b);
+    }
+    return hist_value(CLASS_HIST_BINS - 1);
+}
+
+static void acc_record(ClassAcc *a, const ClassSample *s) {
+    a->cpu_time += s->cpu;
+    a->deadline_misses += s->missed;
+    if (s->max_ready > a->max_ready_wait) a->max_ready_wait = s->max_ready;
+    if (s->cpu + s->waiting > 0) {
+        double x = (double)s->cpu / ((double)s->cpu + s->waiting);
+        a->fair_count++;
+        a->fair_sum += x;
+        a->fair_sum2 += x * x;
+    }
+    if (s->turnaround < 0) return;
+    int values[CLASS_LATENCIES] = { s->waiting, s->turnaround, s->response };
+    a->completed++;
+    for (int m = 0; m < CLASS_LATENCIES; m++) {
+        if (values[m] < 0) continue;
+        a->samples[m]++;
+        a->sum[m] += values[m];
+        a->hist[m][hist_bin(values[m])]++;
+    }
+}
+
+void class_record(ClassStats *cs, const ClassSample *s) {
+    if (!cs) return;
+    int prio = s->priority < 1 ? 1 : (s->priority > SIM_PRIORITY_CLASSES ? SIM_PRIORITY_CLASSES : s->priority);
+    acc_record(&cs->priority[prio - 1], s);
+    if (cs->track_queues && s->queue >= 0 && s->queue < SIM_QUEUE_CLASSES) acc_record(&cs->queue[s->queue], s);
+    acc_record(&cs->all, s);
+}
+
+// Jain: (soma x)^2 / (n * soma x^2); 1 sem processos ou com todos em x = 0.
+static double acc_jain(const ClassAcc *a) {
+    return a->fair_sum2 > 0.0 ? a->fair_sum * a->fair_sum / (a->fair_count * a->fair_sum2) : 1.0;
+}
+
+static void acc_result(const ClassAcc *a, long long cpu_total, SimClassResult *r) {
+    SimLatency *lat[CLASS_LATENCIES] = { &r->waiting, &r->turnaround, &r->response };
+    memset(r, 0, sizeof(*r));
+    r->completed = a->completed;
+    for (int m = 0; m < CLASS_LATENCIES; m++) {
+        if (a->samples[m] == 0) continue;
+        lat[m]->avg = (double)a->sum[m] / a->samples[m];
+        lat[m]->p50 = hist_percentile(a->hist[m], a->samples[m], 50);
+        lat[m]->p95 = hist_percentile(a->hist[m], a->samples[m], 95);
+        lat[m]->p99 = hist_percentile(a->hist[m], a->samples[m], 99);
+    }
+    r->deadline_misses = a->deadline_misses;
+    r->cpu_share = cpu_total > 0 ? 100.0 * a->cpu_time / cpu_total : 0.0;
+    r->max_ready_wait = a->max_ready_wait;
+    r->jain_index = acc_jain(a);
+}
+
+void class_finish(const ClassStats *cs, SimResults *res) {
+    if (!cs) return;
+    long long cpu_total = cs->all.cpu_time;
+    for (int k = 0; k < SIM_PRIORITY_CLASSES; k++) acc_result(&cs->priority[k], cpu_total, &res->priority_class[k]);
+    for (int k = 0; k < SIM_QUEUE_CLASSES; k++) acc_result(&cs->queue[k], cpu_total, &res->queue_class[k]);
+    res->queue_classes = cs->track_queues;
+    res->jain_index = acc_jain(&cs->all);
+    res->max_ready_wait = cs->all.max_ready_wait;
+}
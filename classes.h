@@ -0,0 +1,52 @@
+#ifndef CLASSES_H
+#define CLASSES_H
+
+#include "probsched.h"
+
+// Métricas por classe (prioridade da carga e fila do mlq) e equidade: cada
+// conclusão soma os seus tempos aos acumuladores da classe e a um histograma
+// logarítmico por latência, em O(1), sem passagens extra pela lista de
+// processos nem vetores por processo. class_finish converte os acumuladores
+// nos resultados (médias, percentis, parte do CPU, índice de Jain).
+#define CLASS_HIST_BINS 232     // 8 exatos + 28 oitavas de 8 baldes (até 2^31)
+
+enum { CLASS_WAITING, CLASS_TURNAROUND, CLASS_RESPONSE, CLASS_LATENCIES };
+
+typedef struct {
+    long long completed;
+    long long samples[CLASS_LATENCIES]; // amostras por latência (resposta só com início)
+    long long sum[CLASS_LATENCIES];
+    long long deadline_misses;
+    long long cpu_time;
+    int max_ready_wait;
+    long long fair_count;       // processos na soma de Jain
+    double fair_sum;            // soma de x
+    double fair_sum2;           // soma de x^2
+    int hist[CLASS_LATENCIES][CLASS_HIST_BINS];
+} ClassAcc;
+
+// Estado fixo, sem ponteiros: é registado tal como está nos checkpoints.
+typedef struct {
+    ClassAcc priority[SIM_PRIORITY_CLASSES];
+    ClassAcc queue[SIM_QUEUE_CLASSES];
+    ClassAcc all;
+    int track_queues;           // só o mlq tem filas
+} ClassStats;
+
+// Uma conclusão (turnaround >= 0) ou, no fim da simulação, o que ficou por
+// terminar (turnaround = -1: só conta o CPU, a fome e a equidade).
+typedef struct {
+    int priority;               // prioridade da carga (limitada a 1..5)
+    int queue;                  // fila do mlq (-1 = nenhuma)
+    int cpu;                    // CPU recebido
+    int waiting;                // espera total em READY
+    int turnaround;
+    int response;               // -1 = nunca iniciado (sem amostra)
+    int max_ready;              // maior espera de um burst em READY
+    int missed;                 // deadlines perdidos
+} ClassSample;
+
+void class_record(ClassStats *cs, const ClassSample *s);
+void class_finish(const ClassStats *cs, SimResults *res);
+
+#endif
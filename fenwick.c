@@ -0,0 +1,57 @@
+#include "fenwick.h"
+#include "stats.h"
+#include <stdlib.h>
+
+int fenwick_init(Fenwick *fw, SimContext *arena, int size) {
+    fw->arena = arena;
+    fw->size = size;
+    fw->tree = simctx_calloc(fw->arena, size + 1, sizeof(long long));
+    fw->value = simctx_calloc(fw->arena, size > 0 ? size : 1, sizeof(long long));
+    if (!fw->tree || !fw->value) {
+        fenwick_free(fw);
+        return 0;
+    }
+    fw->top_bit = 1;
+    while (fw->top_bit * 2 <= size) fw->top_bit *= 2;
+    return 1;
+}
+
+void fenwick_free(Fenwick *fw) {
+    simctx_free(fw->arena, fw->tree); simctx_free(fw->arena, fw->value);
+    fw->tree = NULL; fw->value = NULL;
+    fw->size = 0;
+}
+
+void fenwick_set(Fenwick *fw, int idx, long long value) {
+    long long delta = value - fw->value[idx];
+    if (delta == 0) return;
+    fw->value[idx] = value;
+    for (int i = idx + 1; i <= fw->size; i += i & (-i)) {
+        fw->tree[i] += delta;
+    }
+}
+
+long long fenwick_get(const Fenwick *fw, int idx) {
+    return fw->value[idx];
+}
+
+long long fenwick_total(const Fenwick *fw) {
+    long long sum = 0;
+    for (int i = fw->size; i > 0; i -= i & (-i)) sum += fw->tree[i];
+    return sum;
+}
+
+// Devolve o menor índice cuja soma de prefixo (inclusiva) excede 'ticket',
+// ou -1 se ticket >= total.
+int fenwick_find(const Fenwick *fw, long long ticket) {
+    if (ticket < 0) return -1;
+    int pos = 0;
+    for (int step = fw->top_bit; step > 0; step >>= 1) {
+        int next = pos + step;
+        if (next <= fw->size && fw->tree[next] <= ticket) {
+            pos = next;
+            ticket -= fw->tree[next];
+        }
+    }
+    return (pos < fw->size) ? pos : -1;
+}
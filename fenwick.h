@@ -0,0 +1,24 @@
+#ifndef FENWICK_H
+#define FENWICK_H
+
+#include "simctx.h"
+
+// Árvore de Fenwick (Binary Indexed Tree) sobre pesos não negativos
+// indexados por processo (0..size-1). Atualizações, somas de prefixo e a
+// procura do índice que contém um dado "bilhete" custam O(log n).
+typedef struct {
+    SimContext *arena;  // origem da memória (NULL = malloc)
+    long long *tree;    // 1-based internamente
+    long long *value;   // peso atual de cada índice
+    int size;
+    int top_bit;
+} Fenwick;
+
+int  fenwick_init(Fenwick *fw, SimContext *arena, int size);
+void fenwick_free(Fenwick *fw);
+void fenwick_set(Fenwick *fw, int idx, long long value);
+long long fenwick_get(const Fenwick *fw, int idx);
+long long fenwick_total(const Fenwick *fw);
+int  fenwick_find(const Fenwick *fw, long long ticket);
+
+#endif
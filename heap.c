@@ -0,0 +1,133 @@
+#include "heap.h"
+#include "stats.h"
+#include <stdlib.h>
+#include <limits.h>
+
+static int heap_less(const IndexedHeap *h, int a, int b) {
+    if (h->key[a] != h->key[b]) return h->key[a] < h->key[b];
+    if (h->tiebreak[a] != h->tiebreak[b]) return h->tiebreak[a] < h->tiebreak[b];
+    return a < b;
+}
+
+static void heap_swap(IndexedHeap *h, int i, int j) {
+    int a = h->heap[i];
+    int b = h->heap[j];
+    h->heap[i] = b; h->pos[b] = i;
+    h->heap[j] = a; h->pos[a] = j;
+}
+
+static void heap_sift_up(IndexedHeap *h, int k) {
+    while (k > 0) {
+        int parent = (k - 1) / 2;
+        if (!heap_less(h, h->heap[k], h->heap[parent])) break;
+        heap_swap(h, k, parent);
+        k = parent;
+    }
+}
+
+static void heap_sift_down(IndexedHeap *h, int k) {
+    for (;;) {
+        int left = 2 * k + 1;
+        int right = left + 1;
+        int smallest = k;
+        if (left < h->size && heap_less(h, h->heap[left], h->heap[smallest])) smallest = left;
+        if (right < h->size && heap_less(h, h->heap[right], h->heap[smallest])) smallest = right;
+        if (smallest == k) break;
+        heap_swap(h, k, smallest);
+        k = smallest;
+    }
+}
+
+int heap_init(IndexedHeap *h, SimContext *arena, int capacity) {
+    h->arena = arena;
+    h->size = 0;
+    h->capacity = capacity;
+    h->heap = simctx_alloc(h->arena, sizeof(int) * capacity);
+    h->pos = simctx_alloc(h->arena, sizeof(int) * capacity);
+    h->key = simctx_alloc(h->arena, sizeof(long long) * capacity);
+    h->tiebreak = simctx_alloc(h->arena, sizeof(long long) * capacity);
+    if (!h->heap || !h->pos || !h->key || !h->tiebreak) {
+        heap_free(h);
+        return 0;
+    }
+    for (int i = 0; i < capacity; i++) h->pos[i] = -1;
+    return 1;
+}
+
+int heap_reserve(IndexedHeap *h, int capacity) {
+    if (capacity <= h->capacity) return 1;
+    int *heap = simctx_realloc(h->arena, h->heap, sizeof(int) * h->capacity, sizeof(int) * capacity);
+    if (heap) h->heap = heap;
+    int *pos = simctx_realloc(h->arena, h->pos, sizeof(int) * h->capacity, sizeof(int) * capacity);
+    if (pos) h->pos = pos;
+    long long *key = simctx_realloc(h->arena, h->key, sizeof(long long) * h->capacity, sizeof(long long) * capacity);
+    if (key) h->key = key;
+    long long *tiebreak = simctx_realloc(h->arena, h->tiebreak, sizeof(long long) * h->capacity, sizeof(long long) * capacity);
+    if (tiebreak) h->tiebreak = tiebreak;
+    if (!heap || !pos || !key || !tiebreak) return 0;
+    for (int i = h->capacity; i < capacity; i++) h->pos[i] = -1;
+    h->capacity = capacity;
+    return 1;
+}
+
+void heap_free(IndexedHeap *h) {
+    simctx_free(h->arena, h->heap); simctx_free(h->arena, h->pos); simctx_free(h->arena, h->key); simctx_free(h->arena, h->tiebreak);
+    h->heap = NULL; h->pos = NULL; h->key = NULL; h->tiebreak = NULL;
+    h->size = 0;
+    h->capacity = 0;
+}
+
+void heap_clear(IndexedHeap *h) {
+    for (int k = 0; k < h->size; k++) h->pos[h->heap[k]] = -1;
+    h->size = 0;
+}
+
+int heap_contains(const IndexedHeap *h, int idx) {
+    return idx >= 0 && idx < h->capacity && h->pos[idx] != -1;
+}
+
+void heap_push(IndexedHeap *h, int idx, long long key, long long tiebreak) {
+    if (heap_contains(h, idx)) { heap_update(h, idx, key, tiebreak); return; }
+    h->key[idx] = key;
+    h->tiebreak[idx] = tiebreak;
+    h->heap[h->size] = idx;
+    h->pos[idx] = h->size;
+    h->size++;
+    heap_sift_up(h, h->size - 1);
+}
+
+void heap_update(IndexedHeap *h, int idx, long long key, long long tiebreak) {
+    if (!heap_contains(h, idx)) { heap_push(h, idx, key, tiebreak); return; }
+    h->key[idx] = key;
+    h->tiebreak[idx] = tiebreak;
+    heap_sift_up(h, h->pos[idx]);
+    heap_sift_down(h, h->pos[idx]);
+}
+
+void heap_remove(IndexedHeap *h, int idx) {
+    if (!heap_contains(h, idx)) return;
+    int k = h->pos[idx];
+    h->size--;
+    if (k != h->size) {
+        heap_swap(h, k, h->size);
+        h->pos[idx] = -1;
+        heap_sift_up(h, k);
+        heap_sift_down(h, k);
+    } else {
+        h->pos[idx] = -1;
+    }
+}
+
+int heap_peek(const IndexedHeap *h) {
+    return (h->size > 0) ? h->heap[0] : -1;
+}
+
+int heap_pop(IndexedHeap *h) {
+    int top = heap_peek(h);
+    if (top != -1) heap_remove(h, top);
+    return top;
+}
+
+long long heap_peek_key(const IndexedHeap *h) {
+    return (h->size > 0) ? h->key[h->heap[0]] : LLONG_MAX;
+}
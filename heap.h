@@ -0,0 +1,33 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include "simctx.h"
+
+// Min-heap indexado: cada elemento é um índice de processo (0..capacity-1)
+// com uma chave (key) e um desempate (tiebreak). A posição de cada índice
+// é mantida em 'pos', pelo que remover/atualizar um índice é O(log n).
+typedef struct {
+    SimContext *arena;  // origem da memória (NULL = malloc)
+    int *heap;          // heap[k] = índice do processo na posição k
+    int *pos;           // pos[idx] = posição no heap, -1 se ausente
+    long long *key;
+    long long *tiebreak;
+    int size;
+    int capacity;
+} IndexedHeap;
+
+int  heap_init(IndexedHeap *h, SimContext *arena, int capacity);
+void heap_free(IndexedHeap *h);
+void heap_clear(IndexedHeap *h);
+// Aumenta a capacidade (índices novos ausentes); devolve 0 sem memória.
+int  heap_reserve(IndexedHeap *h, int capacity);
+
+int  heap_contains(const IndexedHeap *h, int idx);
+void heap_push(IndexedHeap *h, int idx, long long key, long long tiebreak);
+void heap_update(IndexedHeap *h, int idx, long long key, long long tiebreak);
+void heap_remove(IndexedHeap *h, int idx);
+int  heap_peek(const IndexedHeap *h);
+int  heap_pop(IndexedHeap *h);
+long long heap_peek_key(const IndexedHeap *h);
+
+#endif
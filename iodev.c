@@ -0,0 +1,227 @@
+#include "iodev.h"
+#include "sim.h"
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+static const char *discipline_names[] = { "FCFS", "SCAN" };
+
+int iodev_parse(const char *text, IoDeviceSpec *spec) {
+    char buf[64];
+    strncpy(buf, text, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    spec->rate = 1.0;
+    spec->full_seek = 0;
+
+    char *tok = strtok(buf, ":");
+    if (!tok) return 0;
+    if (strcmp(tok, "fcfs") == 0) spec->discipline = IODEV_FCFS;
+    else if (strcmp(tok, "scan") == 0) spec->discipline = IODEV_SCAN;
+    else return 0;
+
+    if ((tok = strtok(NULL, ":")) != NULL) {
+        spec->rate = atof(tok);
+        if (spec->rate <= 0.0) return 0;
+    }
+    if ((tok = strtok(NULL, ":")) != NULL) {
+        spec->full_seek = atoi(tok);
+        if (spec->full_seek < 0) return 0;
+    }
+    return 1;
+}
+
+void iodev_init(IoDevices *io, SimRun *run, const IoDeviceSpec *specs, int count) {
+    memset(io, 0, sizeof(*io));
+    io->run = run;
+    io->count = (count < IODEV_MAX) ? count : IODEV_MAX;
+    for (int k = 0; k < io->count; k++) io->devices[k].spec = specs[k];
+}
+
+void iodev_trace_tracks(IoDevices *io) {
+    TraceWriter *tw = io->run->trace;
+    if (io->count == 0) { trace_io_track(tw, 0, "I/O"); return; }
+    for (int k = 0; k < io->count; k++) {
+        char name[32];
+        snprintf(name, sizeof(name), "I/O %d (%s)", k, discipline_names[io->devices[k].spec.discipline]);
+        trace_io_track(tw, k, name);
+    }
+}
+
+void iodev_free(IoDevices *io) {
+    SimContext *arena = io->run->arena;
+    for (int k = 0; k < io->count; k++) {
+        heap_free(&io->devices[k].queue);
+        heap_free(&io->devices[k].next_sweep);
+    }
+    simctx_free(arena, io->req_submit); simctx_free(arena, io->req_track); simctx_free(arena, io->req_duration);
+    io->req_submit = NULL; io->req_track = NULL; io->req_duration = NULL;
+    io->ready = 0;
+    io->list = NULL;
+}
+
+// Filas e registos vivem na arena da execução; são alocados de novo em cada
+// reset, porque cada motor traz a sua própria lista local.
+int iodev_reset(IoDevices *io, Process *list, int count) {
+    SimContext *arena = io->run->arena;
+    io->list = list;
+    io->ready = 0;
+    if (io->count == 0) return 1;
+
+    for (int k = 0; k < io->count; k++) {
+        memset(&io->devices[k].queue, 0, sizeof(IndexedHeap));
+        memset(&io->devices[k].next_sweep, 0, sizeof(IndexedHeap));
+    }
+    io->req_submit = simctx_alloc(arena, sizeof(int) * count);
+    io->req_track = simctx_alloc(arena, sizeof(int) * count);
+    io->req_duration = simctx_alloc(arena, sizeof(int) * count);
+    int ok = io->req_submit && io->req_track && io->req_duration;
+    for (int k = 0; k < io->count && ok; k++) {
+        ok = heap_init(&io->devices[k].queue, arena, count) && heap_init(&io->devices[k].next_sweep, arena, count);
+    }
+    if (!ok) {
+        sim_warn(io->run, "Erro malloc dispositivos de I/O (a usar I/O sem contenção)\n");
+        iodev_free(io);
+        io->list = list;
+        return 0;
+    }
+
+    for (int k = 0; k < io->count; k++) {
+        IoDevice *d = &io->devices[k];
+        d->queued = 0;
+        d->direction = 1;
+        d->head = 0;
+        d->busy_idx = -1;
+        d->busy_start = 0;
+        d->busy_until = 0;
+        d->requests = 0;
+        d->busy_time = 0;
+        d->queue_delay_sum = 0;
+        d->queue_delay_max = 0;
+        d->queue_max = 0;
+    }
+    io->submit_seq = 0;
+    io->ready = 1;
+    return 1;
+}
+
+// Pista do pedido: função fixa do processo e da fase, igual em todos os
+// algoritmos para que a carga no disco seja a mesma.
+static int request_track(const Process *p) {
+    unsigned h = (unsigned)p->spec->id * 2654435761u ^ (unsigned)(p->phase_next + 1) * 40503u;
+    return (int)(h % IODEV_TRACKS);
+}
+
+static void start_service(IoDevices *io, IoDevice *d, int idx, int t, IndexedHeap *io_wait) {
+    Process *p = &io->list[idx];
+    int track = io->req_track[idx];
+    int distance = (track > d->head) ? track - d->head : d->head - track;
+    int service = (int)ceil(io->req_duration[idx] / d->spec.rate);
+    if (service < 1) service = 1;
+    service += (d->spec.full_seek * distance + IODEV_TRACKS - 1) / IODEV_TRACKS;
+
+    int delay = t - io->req_submit[idx];
+    d->requests++;
+    d->queue_delay_sum += delay;
+    if (delay > d->queue_delay_max) d->queue_delay_max = delay;
+
+    d->head = track;
+    d->busy_idx = idx;
+    d->busy_start = t;
+    d->busy_until = t + service;
+    p->io_completion_time = d->busy_until;
+    trace_io(io->run->trace, (int)(d - io->devices), p->spec->id, io->req_submit[idx], p->io_completion_time);
+    if (io_wait) heap_push(io_wait, idx, p->io_completion_time, p->spec->arrival_time);
+}
+
+static void enqueue(IoDevices *io, IoDevice *d, int idx) {
+    if (d->spec.discipline == IODEV_SCAN) {
+        int track = io->req_track[idx];
+        int ahead = (d->direction > 0) ? track >= d->head : track <= d->head;
+        if (ahead) heap_push(&d->queue, idx, (long long)d->direction * track, io->submit_seq++);
+        else heap_push(&d->next_sweep, idx, -(long long)d->direction * track, io->submit_seq++);
+    } else {
+        heap_push(&d->queue, idx, io->submit_seq++, 0);
+    }
+    d->queued++;
+    if (d->queued > d->queue_max) d->queue_max = d->queued;
+}
+
+static int dequeue(IoDevice *d) {
+    if (d->spec.discipline == IODEV_SCAN && d->queue.size == 0) {
+        IndexedHeap tmp = d->queue;
+        d->queue = d->next_sweep;
+        d->next_sweep = tmp;
+        d->direction = -d->direction;
+    }
+    d->queued--;
+    return heap_pop(&d->queue);
+}
+
+static void device_advance(IoDevices *io, IoDevice *d, int now, IndexedHeap *io_wait) {
+    while (d->busy_idx != -1 && d->busy_until <= now) {
+        int t = d->busy_until;
+        d->busy_time += t - d->busy_start;
+        d->busy_idx = -1;
+        if (d->queued > 0) start_service(io, d, dequeue(d), t, io_wait);
+    }
+}
+
+void iodev_advance(IoDevices *io, int now, IndexedHeap *io_wait) {
+    if (!io->ready) return;
+    for (int k = 0; k < io->count; k++) device_advance(io, &io->devices[k], now, io_wait);
+}
+
+void iodev_submit(IoDevices *io, Process *p, int now, int duration, IndexedHeap *io_wait) {
+    p->state = STATE_BLOCKED;
+    series_io_begin(io->run->series, now);
+    if (!io->ready) {
+        p->io_completion_time = now + duration;
+        trace_io(io->run->trace, 0, p->spec->id, now, p->io_completion_time);
+        if (io_wait) heap_push(io_wait, (int)(p - io->list), p->io_completion_time, p->spec->arrival_time);
+        return;
+    }
+
+    int idx = (int)(p - io->list);
+    IoDevice *d = &io->devices[p->spec->id % io->count];
+    io->req_submit[idx] = now;
+    io->req_duration[idx] = duration;
+    io->req_track[idx] = request_track(p);
+
+    device_advance(io, d, now, io_wait);
+    if (d->busy_idx == -1) {
+        start_service(io, d, idx, now, io_wait);
+    } else {
+        p->io_completion_time = INT_MAX;
+        enqueue(io, d, idx);
+    }
+}
+
+void iodev_report(IoDevices *io, int final_time) {
+    if (!io->ready) return;
+    SimRun *run = io->run;
+    SimResults *res = run->results;
+    res->io_device_count = io->count;
+    sim_log(run, "\n--- Dispositivos de I/O ---\n");
+    sim_log(run, "Disp | Disciplina | Taxa  | Seek | Pedidos | Utilização | Espera Fila (média/máx) | Fila Máx\n");
+    sim_log(run, "-----------------------------------------------------------------------------------------\n");
+    for (int k = 0; k < io->count; k++) {
+        const IoDevice *d = &io->devices[k];
+        SimIoDeviceResult *r = &res->io[k];
+        long long busy = d->busy_time;
+        // Serviço ainda em curso no fim da simulação conta até final_time.
+        if (d->busy_idx != -1 && d->busy_start < final_time) {
+            busy += ((d->busy_until < final_time) ? d->busy_until : final_time) - d->busy_start;
+        }
+        r->requests = d->requests;
+        r->utilization = final_time > 0 ? 100.0 * busy / final_time : 0.0;
+        r->avg_queue_delay = d->requests > 0 ? (double)d->queue_delay_sum / d->requests : 0.0;
+        r->max_queue_delay = d->queue_delay_max;
+        r->max_queue_length = d->queue_max;
+        sim_log(run, "D%-3d | %-10s | %5.2f | %-4d | %-7lld | %8.2f %% | %10.2f / %-10d | %d\n",
+                k, discipline_names[d->spec.discipline], d->spec.rate, d->spec.full_seek, r->requests,
+                r->utilization, r->avg_queue_delay, r->max_queue_delay, r->max_queue_length);
+    }
+    sim_log(run, "-----------------------------------------------------------------------------------------\n");
+}
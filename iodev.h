@@ -0,0 +1,83 @@
+#ifndef IODEV_H
+#define IODEV_H
+
+#include "process.h"
+#include "heap.h"
+
+// Dispositivos de I/O partilhados com fila própria. Sem dispositivos
+// configurados o I/O é um atraso puro (servidor infinito), como antes: cada
+// pedido termina exatamente 'duration' unidades depois. Com dispositivos, o
+// processo P<id> usa o dispositivo id % N, cada dispositivo serve um pedido
+// de cada vez e os restantes esperam na fila segundo a disciplina.
+#define IODEV_MAX     8
+#define IODEV_TRACKS  200   // posições (pistas) usadas pelo SCAN e pelo seek
+
+typedef enum {
+    IODEV_FCFS,
+    IODEV_SCAN          // elevador (LOOK): serve na direção atual, depois inverte
+} IoDiscipline;
+
+typedef struct {
+    IoDiscipline discipline;
+    double rate;
+    int full_seek;
+} IoDeviceSpec;
+
+typedef struct {
+    IoDeviceSpec spec;
+    IndexedHeap queue;        // FCFS: ordem de submissão; SCAN: varrimento atual
+    IndexedHeap next_sweep;   // SCAN: pedidos que ficaram atrás da cabeça
+    int queued;
+    int direction;            // SCAN: +1 pistas crescentes, -1 decrescentes
+    int head;
+    int busy_idx;             // pedido em serviço (-1 se livre)
+    int busy_start;
+    int busy_until;
+
+    long long requests;
+    long long busy_time;
+    long long queue_delay_sum;
+    int queue_delay_max;
+    int queue_max;
+} IoDevice;
+
+struct SimRun;
+
+// Dispositivos de uma execução. O estado dos pedidos é indexado pela lista
+// local do motor (um processo tem no máximo um pedido pendente, por isso
+// basta um registo por processo).
+typedef struct {
+    struct SimRun *run;
+    IoDevice devices[IODEV_MAX];
+    int count;
+    Process *list;
+    int ready;
+    int *req_submit;
+    int *req_track;
+    int *req_duration;
+    long long submit_seq;
+} IoDevices;
+
+// Especificação "<fcfs|scan>[:<taxa>[:<seek>]]": taxa = unidades de I/O
+// servidas por unidade de tempo (padrão 1.0, > 0); seek = custo de percorrer
+// todas as pistas (padrão 0, >= 0). Devolve 0 se a especificação for inválida.
+int  iodev_parse(const char *text, IoDeviceSpec *spec);
+
+void iodev_init(IoDevices *io, struct SimRun *run, const IoDeviceSpec *specs, int count);
+// Associa os dispositivos à lista local de um motor e limpa o estado dinâmico.
+int  iodev_reset(IoDevices *io, Process *list, int count);
+void iodev_free(IoDevices *io);
+// Uma faixa de I/O por dispositivo no trace (uma só, "I/O", sem dispositivos).
+void iodev_trace_tracks(IoDevices *io);
+
+// Bloqueia p num pedido de 'duration' unidades. io_completion_time fica
+// INT_MAX enquanto o pedido espera na fila. Nos motores orientados a eventos,
+// io_wait recebe cada pedido quando entra em serviço (NULL nos motores por tick).
+void iodev_submit(IoDevices *io, Process *p, int now, int duration, IndexedHeap *io_wait);
+// Conclui os serviços terminados até 'now' e inicia os pedidos seguintes.
+void iodev_advance(IoDevices *io, int now, IndexedHeap *io_wait);
+
+// Imprime a tabela dos dispositivos e preenche os resultados da execução.
+void iodev_report(IoDevices *io, int final_time);
+
+#endif
@@ -3,21 +3,33 @@
 #include <string.h>
 #include <time.h>
 #include <limits.h>
-#include "process.h"
+#include "workload.h"
+#include "probsched.h"
 #include "scheduler.h"
+#include "analysis.h"
+#include "stats.h"
+#include "output.h"
+#include "sweep.h"
+#include "tune.h"
+#include "shard.h"
+#include "whatif.h"
+#include "opensys.h"
 
 void print_usage() {
     printf("Uso: ./probsched [opções]\n");
     printf("Opções:\n");
     printf("  -h, --help           Mostrar esta ajuda\n");
-    printf("  -a <algoritmo>       Algoritmo (fcfs,sjf,rr,prio-np,prio-p,edf,rm,mlq) (padrão: fcfs)\n");
-    printf("                       (edf/rm/mlq/prio-p são preemptivos)\n");
+    printf("  -a <algoritmo>       Algoritmo (fcfs,sjf,srtf,sjf-pred,rr,lottery,stride,\n                       prio-np,prio-p,edf,rm,mlq) (padrão: fcfs)\n");
+    printf("                       (srtf/edf/rm/mlq/prio-p são preemptivos)\n");
     printf("                       (prio-p inclui Aging por padrão)\n");
     printf("  -n <numero>          Número de processos a gerar (random/static) (padrão: 10)\n");
     printf("  -f <filename>        Ler processos de um ficheiro (ignora -n, --gen, dist params)\n");
-    printf("                       Formato: ID Chegada Burst Prio Dead Period [IODuration]\n");
+    printf("                       Formato: ID Chegada Burst(s) Prio Dead Period [IODur(s) [Tickets]]\n");
+    printf("                       (Burst(s)/IODur(s) aceitam listas separadas por vírgulas, ex: 5,3,4 e 2,3)\n");
+    printf("                       (Tickets para lottery/stride; por omissão derivados da prioridade)\n");
+    printf("                       (Period > 0: tarefa periódica para rm/edf, Dead = deadline relativo)\n");
     printf("  -t <max_time>        Tempo máximo de simulação (-1 para sem limite) (padrão: 100)\n");
-    printf("  -q <quantum>         Time quantum base para Round Robin e MLQ (padrão: 4)\n");
+    printf("  -q <quantum>         Time quantum base para Round Robin, MLQ, Lottery e Stride (padrão: 4)\n");
     printf("  -s <semente>         Semente para gerador aleatório (padrão: baseado no tempo)\n");
     printf("  --gen <modo>         Modo de geração se -f não for usado: 'static' ou 'random' (padrão: random)\n");
     printf("  --burst-dist <dist>  Distribuição para burst time: 'normal' ou 'exp' (padrão: normal)\n");
@@ -26,22 +38,251 @@ void print_usage() {
     printf("  --mean <valor>       Média para burst time Normal (padrão: 10.0)\n");
     printf("  --stddev <valor>     Desvio padrão para burst time Normal (padrão: 3.0)\n");
     printf("  --io-chance <prob>   Probabilidade (0.0 a 1.0) de um processo ter I/O (padrão: 0.3)\n");
+    printf("                       (os pontos de I/O são amostrados uma vez e iguais em todos os algoritmos)\n");
     printf("  --io-dur <min> <max> Duração min/max para I/O bursts (padrão: 3 8)\n");
+    printf("  --io-dev <espec>     Dispositivo de I/O partilhado '<fcfs|scan>[:taxa[:seek]]' (repetível, máx %d);\n", IODEV_MAX);
+    printf("                       o processo P<id> usa o dispositivo id %% N (padrão: I/O sem contenção)\n");
+    printf("  --bursts <n>         Número de bursts de CPU por processo aleatório, com I/O entre eles (padrão: 1)\n");
+    printf("  --alpha <valor>      Peso alpha da média exponencial em sjf-pred (padrão: %.1f)\n", SJF_PRED_DEFAULT_ALPHA);
+    printf("  --tau0 <valor>       Estimativa inicial tau0 do burst em sjf-pred (padrão: %.1f)\n", SJF_PRED_DEFAULT_TAU0);
+    printf("  --cs <custo>         Custo de cada troca de contexto (padrão: %d)\n", CONTEXT_SWITCH_COST);
+    printf("  --aging <ticks>      Ticks em READY até o aging subir a prioridade em prio-p (padrão: %d)\n", AGING_THRESHOLD);
+    printf("  --aging-interval <n> Intervalo entre verificações de aging em prio-p (padrão: %d)\n", AGING_INTERVAL);
+    printf("  --admission <modo>   Controlo de admissão EDF à chegada: 'reject', 'defer' ou 'off' (padrão: off)\n");
+    printf("  --reps <n>           Replicações: corre n vezes com as sementes seed..seed+n-1, reutilizando\n");
+    printf("                       a arena de simulação entre execuções (o trace e a série só registam a primeira)\n");
+    printf("  --stats              Mostrar contadores de instrumentação dos motores no fim\n");
+    printf("  --analyze            Análise de escalonabilidade (U, Liu-Layland, hiperbólico, RTA, EDF)\n");
+    printf("  --analyze-skip       Como --analyze, mas não simula rm/edf se a análise garantir que\n");
+    printf("                       nenhum deadline é perdido (só com todas as tarefas em t=0)\n");
+    printf("  --trace <ficheiro>   Exportar o escalonamento em formato Trace Event (Perfetto/chrome://tracing)\n");
+    printf("  --timeseries <W> <f> Escrever em CSV, por janelas de W unidades, a utilização da CPU, as médias da fila\n");
+    printf("                       de prontos, em I/O e em sistema, e as chegadas, conclusões e trocas de contexto\n");
+    printf("  --gantt              Mostrar o diagrama de Gantt em ASCII no fim\n");
+    printf("  --gantt-csv <fich.>  Escrever os intervalos de execução (pid,start,end,cpu,reason) em CSV\n");
+    printf("  --format <fmt>       Saída dos resultados: 'text', 'csv', 'json' ou 'ndjson' (padrão: text);\n");
+    printf("                       fora de 'text' só são escritas as métricas globais, uma linha por execução\n");
+    printf("  --out <ficheiro>     Escrever as métricas de --format num ficheiro em vez do stdout\n");
+    printf("  --rows <ficheiro>    Escrever uma linha por processo, à medida que terminam (formato de\n");
+    printf("                       --format; CSV com 'text')\n");
+    printf("  --classes <ficheiro> Escrever as métricas por classe de prioridade (e por fila no mlq):\n");
+    printf("                       latências com P50/P95/P99, deadlines, parte do CPU, fome e Jain\n");
+    printf("                       (formato de --format; com 'text' também as mostra no fim)\n");
+    printf("  --sweep <espec>      Varrimento de parâmetros sobre a mesma carga, ex: 'q=1..64:x2,cs=0,1,5,aging=10..40:10'\n");
+    printf("                       (chaves q, cs, aging, ai; valores a, a..b, a..b:N ou a..b:xN); uma linha por ponto\n");
+    printf("  --jobs <n>           Threads do varrimento e da afinação (padrão: número de CPUs)\n");
+    printf("  --workers <n>        Correr o varrimento em n processos (fork) com resultados num ficheiro mapeado\n");
+    printf("  --sweep-file <fich.> Ficheiro de resultados do varrimento em processos; se já existir para a mesma\n");
+    printf("                       carga e grelha, retoma os pontos em falta (implica --workers)\n");
+    printf("  --whatif <T>:<espec> Simular uma vez até T e aí ramificar (fork) uma continuação por variante,\n");
+    printf("                       com a sintaxe de --sweep, ex: '200:q=2,8,32'; compara com a continuação sem alterações\n");
+    printf("  --checkpoint-every <N|Ns> Guardar o estado completo da simulação a cada N unidades de tempo\n");
+    printf("                       simulado ou a cada N segundos de tempo real (sufixo 's'), ex: 5000 ou 30s\n");
+    printf("  --checkpoint-file <f> Ficheiro dos checkpoints (substituído atomicamente a cada um)\n");
+    printf("  --resume <f>         Retomar a simulação de um checkpoint da mesma carga e configuração\n");
+    printf("  --open <rho>         Sistema aberto: chegadas Poisson sem fim com utilização alvo rho = lambda*E[S]\n");
+    printf("                       (E[S] de --burst-dist/--mean/--lambda); fcfs, sjf, srtf, rr, prio-np, prio-p\n");
+    printf("  --open-trace <f>     Sistema aberto com as chegadas lidas em fluxo de um ficheiro (formato de -f)\n");
+    printf("  --arrivals <n>       Chegadas a simular em sistema aberto (padrão: %lld; todo o ficheiro com --open-trace)\n", OPEN_DEFAULT_ARRIVALS);
+    printf("  --batches <b>        Lotes do intervalo de confiança em sistema aberto (2 a %d) (padrão: %d)\n", STEADY_MAX_BATCHES, OPEN_DEFAULT_BATCHES);
+    printf("  --no-cache           Não usar a cache de resultados em disco (recalcula sempre)\n");
+    printf("  --cache-dir <dir>    Diretoria da cache de resultados (padrão: ~/.cache/probsched); a cache\n");
+    printf("                       serve --sweep, --tune e execuções só com métricas (--format sem --rows)\n");
+    printf("  --tune <objetivo>    Afinar o quantum (lottery/stride), o aging (prio-p) ou os quanta do mlq\n");
+    printf("                       por successive halving: 'p99' (espera P99), 'avg' (espera média) ou 'turnaround'\n");
+    printf("  --tune-budget <pct>  Sobrecarga máxima de trocas de contexto na afinação (%% do tempo) (padrão: sem limite)\n");
+    printf("  --mlq-q <q0>,<q1>    Quanta das filas Q0 e Q1 do mlq (padrão: q e 2*q)\n");
 }
 
-void print_process_list(Process* list, int count) {
+void print_process_list(const ProcessSpec* list, int count) {
     if (!list || count <= 0) return;
     printf("\n--- Lista de Processos (%d) ---\n", count);
-    printf("ID | Chegada | Burst | Prio | Dead | Period | IO Dur\n");
-    printf("--------------------------------------------------\n");
+    printf("ID | Chegada | Burst | Prio | Dead | Period | IO Dur | Tickets\n");
+    printf("------------------------------------------------------------\n");
     for (int i = 0; i < count; i++) {
-        printf("P%-2d| %-7d | %-5d | %-4d | %-4d | %-6d | %d\n",
+        printf("P%-2d| %-7d | %-5d | %-4d | %-4d | %-6d | %-6d | %d\n",
                list[i].id, list[i].arrival_time, list[i].burst_time,
-               list[i].priority, list[i].deadline, list[i].period, list[i].io_burst_duration);
+               list[i].priority, list[i].deadline, list[i].period, list[i].io_burst_duration, list[i].tickets);
     }
+    printf("------------------------------------------------------------\n");
+}
+
+#define POINT_TABLE_RULE "-------------------------------------------------------------------------------------------------------------------------------\n"
+
+static void print_arena_report(const SimContext *ctx) {
+    size_t demand = ctx->used + ctx->fallback_bytes;
+    size_t peak = (demand > ctx->peak) ? demand : ctx->peak;
+    printf("\n--- Contexto de Simulação (arena) ---\n");
+    printf("Capacidade da Arena:           %zu KiB (%llu crescimento%s)\n",
+           ctx->capacity / 1024, ctx->grows, ctx->grows == 1 ? "" : "s");
+    printf("Pico por Execução:             %zu KiB\n", peak / 1024);
+    printf("Execuções (resets):            %llu\n", ctx->resets);
+    printf("Alocações na Arena:            %llu (fallback malloc: %llu)\n",
+           ctx->arena_allocs, ctx->fallback_allocs);
     printf("--------------------------------------------------\n");
 }
 
+// A coluna dos quanta das filas só aparece no mlq, o único que os usa.
+static void print_point_header(const char *first, int mlq) {
+    printf("%-5s | Q    | CS   | Aging | Int  |%s Espera Média | Espera P99 | Turnaround Médio | Trocas | Util. CPU | Deadl. Falh.\n",
+           first, mlq ? " MLQ Q0/Q1 |" : "");
+    printf(POINT_TABLE_RULE);
+}
+
+static void print_point_row(const char *label, const SweepPoint *pt, const SimResults *r, int mlq) {
+    printf("%-5s | %-4d | %-4d | %-5d | %-4d | ", label, pt->quantum, pt->switch_cost, pt->aging_threshold, pt->aging_interval);
+    if (mlq) {
+        char mlq_str[24];
+        snprintf(mlq_str, sizeof(mlq_str), "%d/%d", pt->mlq_quantum[0] > 0 ? pt->mlq_quantum[0] : pt->quantum,
+                 pt->mlq_quantum[1] > 0 ? pt->mlq_quantum[1] : pt->quantum * 2);
+        printf("%-9s | ", mlq_str);
+    }
+    printf("%12.2f | %10.0f | %16.2f | %-6d | %7.2f %% | %d\n",
+           r->avg_waiting_time, r->p99_waiting_time, r->avg_turnaround_time, r->context_switches,
+           r->cpu_utilization, r->deadline_misses);
+}
+
+static void print_class_row(const char *label, const SimClassResult *c) {
+    printf("%-6s | %-7lld | %8.2f | %8.0f | %8.2f | %8.0f | %8.2f | %8.0f | %-5lld | %6.2f %% | %-9d | %.4f\n",
+           label, c->completed, c->waiting.avg, c->waiting.p99, c->turnaround.avg, c->turnaround.p99,
+           c->response.avg, c->response.p99, c->deadline_misses, c->cpu_share, c->max_ready_wait, c->jain_index);
+}
+
+static void print_class_table(const SimResults *r) {
+    char label[12];
+    printf("\n--- Métricas por Classe ---\n");
+    printf("Classe | Compl.  | Espera   | E. P99   | Turnar.  | T. P99   | Resposta | R. P99   | Perd. | CPU      | Fome Máx. | Jain\n");
+    printf(POINT_TABLE_RULE);
+    for (int k = 0; k < SIM_PRIORITY_CLASSES; k++) {
+        snprintf(label, sizeof(label), "Prio %d", k + 1);
+        print_class_row(label, &r->priority_class[k]);
+    }
+    for (int k = 0; r->queue_classes && k < SIM_QUEUE_CLASSES; k++) {
+        snprintf(label, sizeof(label), "Fila %d", k);
+        print_class_row(label, &r->queue_class[k]);
+    }
+    printf(POINT_TABLE_RULE);
+    printf("Índice de Jain (global):       %.4f\n", r->jain_index);
+    printf("Maior Espera em READY (fome):  %d\n", r->max_ready_wait);
+}
+
+// rows[k] == NULL: ponto sem resultado (varrimento em processos).
+static void print_sweep_table(const SweepGrid *grid, const SimResults *const *rows, int jobs, const char *unit, double wall_ms,
+                              int mlq) {
+    printf("\n--- Varrimento (%d pontos, %d %s) ---\n", grid->count, jobs < grid->count ? jobs : grid->count, unit);
+    print_point_header("Ponto", mlq);
+    int best = -1;
+    for (int k = 0; k < grid->count; k++) {
+        if (!rows[k]) continue;
+        char label[16];
+        snprintf(label, sizeof(label), "%d", k);
+        print_point_row(label, &grid->points[k], rows[k], mlq);
+        if (best < 0 || rows[k]->avg_waiting_time < rows[best]->avg_waiting_time) best = k;
+    }
+    printf(POINT_TABLE_RULE);
+    if (best >= 0) printf("Menor Espera Média:            ponto %d (%.2f)\n", best, rows[best]->avg_waiting_time);
+    printf("Tempo de Parede:               %.3f ms (%.3f ms por ponto)\n", wall_ms, wall_ms / grid->count);
+}
+
+// results[0] é a referência (base) e results[1 + k] a variante k.
+static void print_whatif_table(const SweepGrid *variants, const SweepPoint *base, const SimResults *results,
+                               const WhatIfSummary *summary, int mlq) {
+    if (summary->reached_time < 0) {
+        printf("\n--- What-if em t=%d: a simulação terminou em t=%d, antes da ramificação ---\n",
+               summary->branch_time, results[0].final_time);
+    } else {
+        printf("\n--- What-if em t=%d (ramificação em t=%d, %d variantes) ---\n",
+               summary->branch_time, summary->reached_time, variants->count);
+    }
+    print_point_header("Var.", mlq);
+    print_point_row("base", base, &results[0], mlq);
+    for (int k = 0; k < variants->count; k++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d", k);
+        if (results[1 + k].status == SIM_OK) print_point_row(label, &variants->points[k], &results[1 + k], mlq);
+        else printf("%-5s | (falhou: %s)\n", label, sim_status_name(results[1 + k].status));
+    }
+    printf(POINT_TABLE_RULE);
+    if (summary->reached_time >= 0) {
+        printf("Prefixo Comum:                 t=0..%d simulado uma vez para %d continuações\n",
+               summary->reached_time, variants->count + 1);
+    }
+    printf("Tempo de Parede:               %.3f ms\n", summary->wall_ms);
+}
+
+static void print_tune_report(const TuneReport *report, const char *algorithm, const TuneOptions *options) {
+    char flags[48];
+    printf("\n--- Afinação (successive halving, objetivo: %s) ---\n", tune_objective_name(options->objective));
+    printf("Candidatos:                    %d\n", report->count);
+    if (options->switch_budget >= 0) printf("Orçamento de Trocas:           %.2f %% do tempo\n", options->switch_budget);
+    else printf("Orçamento de Trocas:           sem limite\n");
+    printf("Ronda | Horizonte  | Avaliados\n");
+    for (int r = 0; r < report->rungs; r++) {
+        if (report->horizon[r] == -1) printf("%-5d | %-10s | %d\n", r, "completo", report->evaluated[r]);
+        else printf("%-5d | %-10d | %d\n", r, report->horizon[r], report->evaluated[r]);
+    }
+
+    // Frente de Pareto da ronda final, por sobrecarga crescente.
+    int *front = malloc(sizeof(int) * report->count);
+    int n = 0;
+    for (int k = 0; front && k < report->count; k++) {
+        const TuneCandidate *c = &report->candidates[k];
+        if (c->rung != report->rungs - 1 || c->front != 0) continue;
+        int pos = n++;
+        while (pos > 0 && report->candidates[front[pos - 1]].overhead > c->overhead) {
+            front[pos] = front[pos - 1];
+            pos--;
+        }
+        front[pos] = k;
+    }
+    printf("\n--- Frente de Pareto (latência vs sobrecarga de trocas) ---\n");
+    printf("Parâmetros      | Objetivo   | Espera P99 | Espera Média | Trocas | Sobrecarga | Orçamento\n");
+    printf("--------------------------------------------------------------------------------------------\n");
+    for (int i = 0; i < n; i++) {
+        const TuneCandidate *c = &report->candidates[front[i]];
+        tune_point_flags(algorithm, &c->point, flags, sizeof(flags));
+        printf("%-15s | %10.2f | %10.0f | %12.2f | %-6d | %8.2f %% | %s%s\n",
+               flags, c->objective, c->result.p99_waiting_time, c->result.avg_waiting_time,
+               c->result.context_switches, c->overhead, c->feasible ? "cumpre" : "excede",
+               front[i] == report->best ? " *" : "");
+    }
+    printf("--------------------------------------------------------------------------------------------\n");
+    free(front);
+
+    if (report->best >= 0) {
+        const TuneCandidate *best = &report->candidates[report->best];
+        tune_point_flags(algorithm, &best->point, flags, sizeof(flags));
+        printf("Melhor Configuração:           %s (%s = %.2f, sobrecarga %.2f %%%s)\n", flags,
+               tune_objective_name(options->objective), best->objective, best->overhead,
+               best->feasible ? "" : ", fora do orçamento");
+    }
+    int evaluations = 0;
+    for (int r = 0; r < report->rungs; r++) evaluations += report->evaluated[r];
+    printf("Avaliações:                    %d simulações (%d completas; grelha completa: %d), tempo simulado %lld\n",
+           evaluations, report->evaluated[report->rungs - 1], report->count, report->simulated_time);
+    printf("Tempo de Parede:               %.3f ms\n", report->wall_ms);
+}
+
+static void print_open_report(const OpenResults *r) {
+    printf("\n--- Sistema Aberto (regime estacionário) ---\n");
+    printf("Chegadas:                      %lld (carga oferecida %.4f)\n", r->arrivals, r->offered_load);
+    printf("Concluídos:                    %lld (aquecimento descartado pelo MSER-5: %lld)\n", r->completed, r->warmup);
+    printf("Em Sistema no Fim:             %lld (máximo %lld; %d posições reservadas)\n", r->in_system, r->max_in_system, r->slots);
+    printf("Tempo Final:                   %lld\n", r->final_time);
+    printf("Utilização CPU:                %.2f %%\n", r->utilization);
+    printf("Sobrecarga de Trocas:          %.2f %% (%lld trocas)\n", r->switch_overhead, r->context_switches);
+    printf("Throughput:                    %.6f processos/unidade de tempo\n", r->throughput);
+    printf("Resposta Média:                %.4f ± %.4f (IC 95%%, %d lotes de %lld)\n",
+           r->response.mean, r->response.half_width, r->response.batches, r->response.batch_size);
+    printf("Espera Média:                  %.4f ± %.4f\n", r->waiting.mean, r->waiting.half_width);
+}
+
+// Destino das mensagens da simulação: eventos no stdout, erros no stderr.
+static void log_to_stdio(void *arg, int level, const char *text) {
+    (void)arg;
+    fputs(text, level == SIM_LOG_ERROR ? stderr : stdout);
+}
+
 
 int main(int argc, char *argv[]) {
 
@@ -64,6 +305,47 @@ int main(int argc, char *argv[]) {
     double io_chance = 0.3;
     int min_io_duration = 3;
     int max_io_duration = 8;
+    int bursts_per_process = 1;
+    double pred_alpha = SJF_PRED_DEFAULT_ALPHA;
+    double pred_tau0 = SJF_PRED_DEFAULT_TAU0;
+    int admission_mode = ADMISSION_NONE;
+    int switch_cost = CONTEXT_SWITCH_COST;
+    int aging_threshold = AGING_THRESHOLD;
+    int aging_interval = AGING_INTERVAL;
+    int show_stats = 0;
+    int analyze = 0;
+    int analyze_skip = 0;
+    char trace_filename[256] = "";
+    char series_filename[256] = "";
+    int series_window = 0;
+    int gantt_ascii = 0;
+    char gantt_csv_filename[256] = "";
+    int replications = 1;
+    int output_format = OUTPUT_TEXT;
+    char output_filename[256] = "";
+    char rows_filename[256] = "";
+    char classes_filename[256] = "";
+    const char *sweep_spec = NULL;
+    int jobs = sweep_default_jobs();
+    int workers = 0;
+    char sweep_filename[256] = "";
+    int use_cache = 1;
+    const char *whatif_spec = NULL;
+    int whatif_time = -1;
+    const char *cache_dir = NULL;
+    int checkpoint_every = 0;
+    int checkpoint_every_ms = 0;
+    const char *checkpoint_file = NULL;
+    const char *resume_file = NULL;
+    double open_utilization = 0.0;
+    const char *open_trace = NULL;
+    long long open_arrivals = 0;
+    int open_batches = 0;
+    int tune_objective = -1;
+    double tune_budget = -1.0;
+    int mlq_quantum[MLQ_RR_LEVELS] = { 0, 0 };
+    IoDeviceSpec io_devices[IODEV_MAX];
+    int io_device_count = 0;
 
 
     for (int i = 1; i < argc; i++) {
@@ -109,82 +391,648 @@ int main(int argc, char *argv[]) {
                  if (max_io_duration < min_io_duration) max_io_duration = min_io_duration;
              } else { fprintf(stderr, "Erro: Flag --io-dur requer min e max.\n"); return 1; }
         }
+        else if (strcmp(argv[i], "--io-dev") == 0) {
+             if (++i < argc) {
+                 if (io_device_count == IODEV_MAX) { fprintf(stderr, "Erro: No máximo %d dispositivos de I/O.\n", IODEV_MAX); return 1; }
+                 if (!iodev_parse(argv[i], &io_devices[io_device_count])) {
+                     fprintf(stderr, "Erro: Especificação de I/O inválida '%s' (esperado <fcfs|scan>[:taxa>0[:seek>=0]])\n", argv[i]);
+                     return 1;
+                 }
+                 io_device_count++;
+             } else { fprintf(stderr, "Erro: Faltando argumento para --io-dev\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--reps") == 0) {
+             if (++i < argc) { replications = atoi(argv[i]); if (replications < 1) { fprintf(stderr, "Erro: --reps deve ser >= 1.\n"); return 1; } } else { fprintf(stderr, "Erro: Faltando argumento para --reps\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--bursts") == 0) {
+             if (++i < argc) { bursts_per_process = atoi(argv[i]); if (bursts_per_process < 1) { fprintf(stderr, "Erro: --bursts deve ser >= 1.\n"); return 1; } } else { fprintf(stderr, "Erro: Faltando argumento para --bursts\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--alpha") == 0) {
+             if (++i < argc) { pred_alpha = atof(argv[i]); if (pred_alpha < 0.0 || pred_alpha > 1.0) pred_alpha = SJF_PRED_DEFAULT_ALPHA; } else { fprintf(stderr, "Erro: Faltando argumento para --alpha\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--cs") == 0) {
+             if (++i < argc) { switch_cost = atoi(argv[i]); if (switch_cost < 0) { fprintf(stderr, "Erro: --cs deve ser >= 0.\n"); return 1; } } else { fprintf(stderr, "Erro: Faltando argumento para --cs\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--aging") == 0) {
+             if (++i < argc) { aging_threshold = atoi(argv[i]); if (aging_threshold < 1) { fprintf(stderr, "Erro: --aging deve ser >= 1.\n"); return 1; } } else { fprintf(stderr, "Erro: Faltando argumento para --aging\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--aging-interval") == 0) {
+             if (++i < argc) { aging_interval = atoi(argv[i]); if (aging_interval < 1) { fprintf(stderr, "Erro: --aging-interval deve ser >= 1.\n"); return 1; } } else { fprintf(stderr, "Erro: Faltando argumento para --aging-interval\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--admission") == 0) {
+             if (++i < argc) {
+                 if (strcmp(argv[i], "reject") == 0) admission_mode = ADMISSION_REJECT;
+                 else if (strcmp(argv[i], "defer") == 0) admission_mode = ADMISSION_DEFER;
+                 else if (strcmp(argv[i], "off") == 0) admission_mode = ADMISSION_NONE;
+                 else { fprintf(stderr, "Erro: Modo de admissão '%s' desconhecido (reject, defer, off)\n", argv[i]); return 1; }
+             } else { fprintf(stderr, "Erro: Faltando argumento para --admission\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--format") == 0) {
+             if (++i < argc) {
+                 output_format = output_parse_format(argv[i]);
+                 if (output_format < 0) { fprintf(stderr, "Erro: Formato '%s' desconhecido (text, csv, json, ndjson)\n", argv[i]); return 1; }
+             } else { fprintf(stderr, "Erro: Faltando argumento para --format\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--out") == 0) { if (++i < argc) strncpy(output_filename, argv[i], sizeof(output_filename)-1); else { fprintf(stderr, "Erro: Faltando argumento para --out\n"); return 1;} }
+        else if (strcmp(argv[i], "--rows") == 0) { if (++i < argc) strncpy(rows_filename, argv[i], sizeof(rows_filename)-1); else { fprintf(stderr, "Erro: Faltando argumento para --rows\n"); return 1;} }
+        else if (strcmp(argv[i], "--classes") == 0) { if (++i < argc) strncpy(classes_filename, argv[i], sizeof(classes_filename)-1); else { fprintf(stderr, "Erro: Faltando argumento para --classes\n"); return 1;} }
+        else if (strcmp(argv[i], "--sweep") == 0) { if (++i < argc) sweep_spec = argv[i]; else { fprintf(stderr, "Erro: Faltando argumento para --sweep\n"); return 1;} }
+        else if (strcmp(argv[i], "--jobs") == 0) {
+             if (++i < argc) { jobs = atoi(argv[i]); if (jobs < 1) { fprintf(stderr, "Erro: --jobs deve ser >= 1.\n"); return 1; } } else { fprintf(stderr, "Erro: Faltando argumento para --jobs\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--workers") == 0) {
+             if (++i < argc) { workers = atoi(argv[i]); if (workers < 1) { fprintf(stderr, "Erro: --workers deve ser >= 1.\n"); return 1; } } else { fprintf(stderr, "Erro: Faltando argumento para --workers\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--sweep-file") == 0) { if (++i < argc) strncpy(sweep_filename, argv[i], sizeof(sweep_filename)-1); else { fprintf(stderr, "Erro: Faltando argumento para --sweep-file\n"); return 1;} }
+        else if (strcmp(argv[i], "--whatif") == 0) {
+            if (++i < argc) {
+                char *end;
+                long t = strtol(argv[i], &end, 10);
+                if (end == argv[i] || *end != ':' || t < 0 || t > INT_MAX) {
+                    fprintf(stderr, "Erro: --whatif espera <T>:<espec> com T >= 0 ('%s')\n", argv[i]);
+                    return 1;
+                }
+                whatif_time = (int)t;
+                whatif_spec = end + 1;
+            } else { fprintf(stderr, "Erro: Faltando argumento para --whatif\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--checkpoint-every") == 0) {
+            if (++i < argc) {
+                char *end;
+                double v = strtod(argv[i], &end);
+                if (end != argv[i] && strcmp(end, "s") == 0 && v > 0.0 && v * 1000.0 <= INT_MAX) {
+                    checkpoint_every_ms = v * 1000.0 < 1.0 ? 1 : (int)(v * 1000.0);
+                } else if (end != argv[i] && *end == '\0' && v >= 1.0 && v <= INT_MAX && v == (int)v) {
+                    checkpoint_every = (int)v;
+                } else {
+                    fprintf(stderr, "Erro: --checkpoint-every espera N >= 1 (tempo simulado) ou Ns (segundos) ('%s')\n", argv[i]);
+                    return 1;
+                }
+            } else { fprintf(stderr, "Erro: Faltando argumento para --checkpoint-every\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--checkpoint-file") == 0) { if (++i < argc) checkpoint_file = argv[i]; else { fprintf(stderr, "Erro: Faltando argumento para --checkpoint-file\n"); return 1;} }
+        else if (strcmp(argv[i], "--resume") == 0) { if (++i < argc) resume_file = argv[i]; else { fprintf(stderr, "Erro: Faltando argumento para --resume\n"); return 1;} }
+        else if (strcmp(argv[i], "--open") == 0) {
+             if (++i < argc) { open_utilization = atof(argv[i]); if (open_utilization <= 0.0) { fprintf(stderr, "Erro: --open deve ser > 0.\n"); return 1; } } else { fprintf(stderr, "Erro: Faltando argumento para --open\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--open-trace") == 0) { if (++i < argc) open_trace = argv[i]; else { fprintf(stderr, "Erro: Faltando argumento para --open-trace\n"); return 1;} }
+        else if (strcmp(argv[i], "--arrivals") == 0) {
+             if (++i < argc) { open_arrivals = strtoll(argv[i], NULL, 10); if (open_arrivals < 1) { fprintf(stderr, "Erro: --arrivals deve ser >= 1.\n"); return 1; } } else { fprintf(stderr, "Erro: Faltando argumento para --arrivals\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--batches") == 0) {
+             if (++i < argc) { open_batches = atoi(argv[i]); if (open_batches < 2 || open_batches > STEADY_MAX_BATCHES) { fprintf(stderr, "Erro: --batches deve estar entre 2 e %d.\n", STEADY_MAX_BATCHES); return 1; } } else { fprintf(stderr, "Erro: Faltando argumento para --batches\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--no-cache") == 0) { use_cache = 0; }
+        else if (strcmp(argv[i], "--cache-dir") == 0) { if (++i < argc) cache_dir = argv[i]; else { fprintf(stderr, "Erro: Faltando argumento para --cache-dir\n"); return 1;} }
+        else if (strcmp(argv[i], "--tune") == 0) {
+             if (++i < argc) {
+                 tune_objective = tune_parse_objective(argv[i]);
+                 if (tune_objective < 0) { fprintf(stderr, "Erro: Objetivo de afinação '%s' desconhecido (p99, avg, turnaround)\n", argv[i]); return 1; }
+             } else { fprintf(stderr, "Erro: Faltando argumento para --tune\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--tune-budget") == 0) {
+             if (++i < argc) { tune_budget = atof(argv[i]); if (tune_budget < 0.0) { fprintf(stderr, "Erro: --tune-budget deve ser >= 0.\n"); return 1; } } else { fprintf(stderr, "Erro: Faltando argumento para --tune-budget\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--mlq-q") == 0) {
+             if (++i < argc) {
+                 if (sscanf(argv[i], "%d,%d", &mlq_quantum[0], &mlq_quantum[1]) != 2 || mlq_quantum[0] < 1 || mlq_quantum[1] < 1) {
+                     fprintf(stderr, "Erro: --mlq-q espera <q0>,<q1> com ambos >= 1 ('%s')\n", argv[i]);
+                     return 1;
+                 }
+             } else { fprintf(stderr, "Erro: Faltando argumento para --mlq-q\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--stats") == 0) { show_stats = 1; }
+        else if (strcmp(argv[i], "--analyze") == 0) { analyze = 1; }
+        else if (strcmp(argv[i], "--analyze-skip") == 0) { analyze = 1; analyze_skip = 1; }
+        else if (strcmp(argv[i], "--gantt") == 0) { gantt_ascii = 1; }
+        else if (strcmp(argv[i], "--gantt-csv") == 0) { if (++i < argc) strncpy(gantt_csv_filename, argv[i], sizeof(gantt_csv_filename)-1); else { fprintf(stderr, "Erro: Faltando argumento para --gantt-csv\n"); return 1;} }
+        else if (strcmp(argv[i], "--trace") == 0) { if (++i < argc) strncpy(trace_filename, argv[i], sizeof(trace_filename)-1); else { fprintf(stderr, "Erro: Faltando argumento para --trace\n"); return 1;} }
+        else if (strcmp(argv[i], "--timeseries") == 0) {
+             if (i + 2 < argc) {
+                 series_window = atoi(argv[++i]);
+                 if (series_window < 1) { fprintf(stderr, "Erro: --timeseries espera uma janela >= 1 ('%s')\n", argv[i]); return 1; }
+                 strncpy(series_filename, argv[++i], sizeof(series_filename)-1);
+             } else { fprintf(stderr, "Erro: Faltando argumentos para --timeseries <W> <ficheiro>\n"); return 1; }
+        }
+        else if (strcmp(argv[i], "--tau0") == 0) {
+             if (++i < argc) { pred_tau0 = atof(argv[i]); if (pred_tau0 <= 0.0) pred_tau0 = SJF_PRED_DEFAULT_TAU0; } else { fprintf(stderr, "Erro: Faltando argumento para --tau0\n"); return 1; }
+        }
         else { fprintf(stderr, "Erro: Opção desconhecida '%s'\n", argv[i]); print_usage(); return 1; }
     }
 
 
-    printf("--- Simulador ProbSched ---\n");
-    printf("Config: Algo=%s, N=%d, Q=%d, TMax=%d, Seed=%s%d\n",
-           algorithm, num_processes, quantum, max_simulation_time,
-           use_fixed_seed ? "(fixa) " : "(tempo) ", seed);
-     printf("        Gen=%s", (strlen(input_filename)>0 ? "file" : generation_mode));
-     if (strlen(input_filename) == 0 && strcmp(generation_mode,"random")==0) {
-          printf(", Burst=%s(M=%.1f,SD=%.1f / L=%.2f), Prio=%s, L_Arr=%.2f\n",
-                burst_dist_str, mean_norm, stddev_norm, lambda_burst, prio_gen_str, lambda_arrival);
-          printf("        IO: Chance=%.2f, Dur=%d-%d\n", io_chance, min_io_duration, max_io_duration);
-     } else if (strlen(input_filename) > 0) {
-         printf(" ('%s')\n", input_filename);
-     } else {
-         printf("\n");
-     }
+    // Com saída estruturada o stdout fica só com os registos pedidos.
+    int verbose = (output_format == OUTPUT_TEXT);
+    SimContext arena;
+    simctx_init(&arena, simctx_estimate(num_processes));
 
+    SimConfig config;
+    sim_config_defaults(&config);
+    config.algorithm = algorithm;
+    config.quantum = quantum;
+    config.max_simulation_time = max_simulation_time;
+    config.pred_alpha = pred_alpha;
+    config.pred_tau0 = pred_tau0;
+    config.admission_mode = admission_mode;
+    config.context_switch_cost = switch_cost;
+    config.aging_threshold = aging_threshold;
+    config.aging_interval = aging_interval;
+    config.mlq_quantum[0] = mlq_quantum[0];
+    config.mlq_quantum[1] = mlq_quantum[1];
+    memcpy(config.io_devices, io_devices, sizeof(IoDeviceSpec) * io_device_count);
+    config.io_device_count = io_device_count;
+    config.log = log_to_stdio;
+    config.log_level = verbose ? SIM_LOG_INFO : SIM_LOG_ERROR;
+    config.gantt_ascii = gantt_ascii;
+    config.gantt_csv_path = gantt_csv_filename;
+    config.arena = &arena;
 
-    srand(seed);
-    Process* process_list = NULL;
-    int actual_process_count = 0;
-
-    if (strlen(input_filename) > 0) {
-        process_list = read_processes_from_file(input_filename, &actual_process_count);
-        if (!process_list) return 1;
-        num_processes = actual_process_count;
-    } else {
-        actual_process_count = num_processes;
-        if (strcmp(generation_mode, "static") == 0) {
-             process_list = generate_static_processes(actual_process_count);
-        } else {
-             double p1_burst = (burst_dist_type == 1) ? lambda_burst : mean_norm;
-             double p2_burst = (burst_dist_type == 1) ? 0.0 : stddev_norm;
-             process_list = generate_random_processes(actual_process_count, lambda_arrival, p1_burst, p2_burst, burst_dist_type, prio_type, io_chance, min_io_duration, max_io_duration);
+    // O varrimento só produz métricas globais, uma linha por ponto.
+    SweepGrid grid = { NULL, 0 };
+    SimResults *sweep_results = NULL;
+    const SimResults **sweep_rows = NULL;
+    if (tune_objective >= 0) {
+        if (sweep_spec) { fprintf(stderr, "Erro: --tune e --sweep não podem ser usados em conjunto.\n"); simctx_destroy(&arena); return 1; }
+        if (!tune_algorithm_supported(algorithm)) {
+            fprintf(stderr, "Erro: '%s' não usa o quantum, o aging nem os quanta do mlq: nada a afinar (lottery, stride, prio-p, mlq).\n", algorithm);
+            simctx_destroy(&arena);
+            return 1;
+        }
+    }
+    SweepGrid whatif_grid = { NULL, 0 };
+    SimResults *whatif_results = NULL;
+    if (whatif_spec) {
+        if (sweep_spec || tune_objective >= 0) {
+            fprintf(stderr, "Erro: --whatif não pode ser usado com --sweep nem --tune.\n");
+            simctx_destroy(&arena);
+            return 1;
+        }
+        if (!sweep_parse(whatif_spec, &config, WHATIF_MAX_VARIANTS, &whatif_grid)) { simctx_destroy(&arena); return 1; }
+        // Variantes idênticas à referência seriam apresentadas como alternativas distintas.
+        int unused = sweep_varied_params(&whatif_grid, &config) & ~sim_algorithm_params(algorithm);
+        if (unused && sim_algorithm_valid(algorithm)) {
+            char keys[32];
+            sweep_param_keys(unused, keys, sizeof(keys));
+            fprintf(stderr, "Erro: '%s' não usa %s: essas variantes seguiriam a mesma continuação que a referência.\n", algorithm, keys);
+            sweep_free(&whatif_grid);
+            simctx_destroy(&arena);
+            return 1;
+        }
+        whatif_results = malloc(sizeof(SimResults) * (whatif_grid.count + 1));
+        if (!whatif_results) {
+            fprintf(stderr, "Erro malloc what-if\n");
+            sweep_free(&whatif_grid);
+            simctx_destroy(&arena);
+            return 1;
+        }
+    }
+    // Checkpoints e retoma são de uma única simulação.
+    if ((checkpoint_every > 0 || checkpoint_every_ms > 0) != (checkpoint_file != NULL)) {
+        fprintf(stderr, "Erro: --checkpoint-every e --checkpoint-file têm de ser usados em conjunto.\n");
+        simctx_destroy(&arena);
+        return 1;
+    }
+    if ((checkpoint_file || resume_file) && (sweep_spec || tune_objective >= 0 || whatif_spec || replications > 1)) {
+        fprintf(stderr, "Erro: --checkpoint-file e --resume não podem ser usados com --sweep, --tune, --whatif nem --reps > 1.\n");
+        simctx_destroy(&arena);
+        return 1;
+    }
+    // A série de uma execução retomada ficaria sem o que aconteceu antes do checkpoint.
+    if (resume_file && strlen(series_filename) > 0) {
+        fprintf(stderr, "Erro: --timeseries não pode ser usado com --resume.\n");
+        simctx_destroy(&arena);
+        return 1;
+    }
+    config.checkpoint_path = checkpoint_file;
+    config.checkpoint_every = checkpoint_every;
+    config.checkpoint_every_ms = checkpoint_every_ms;
+    config.resume_path = resume_file;
+    // Sistema aberto: as chegadas são geradas (ou lidas) pelo próprio motor.
+    int open_mode = (open_utilization > 0.0 || open_trace != NULL);
+    OpenConfig open_config;
+    open_config_defaults(&open_config);
+    if (open_mode) {
+        if (open_utilization > 0.0 && open_trace) {
+            fprintf(stderr, "Erro: --open e --open-trace não podem ser usados em conjunto.\n");
+            simctx_destroy(&arena);
+            return 1;
+        }
+        if (strlen(input_filename) > 0 || sweep_spec || tune_objective >= 0 || whatif_spec || checkpoint_file || resume_file) {
+            fprintf(stderr, "Erro: --open não pode ser usado com -f, --sweep, --tune, --whatif nem checkpoints.\n");
+            simctx_destroy(&arena);
+            return 1;
+        }
+        if (!open_algorithm_supported(algorithm)) {
+            fprintf(stderr, "Erro: --open suporta fcfs, sjf, srtf, rr, prio-np e prio-p.\n");
+            simctx_destroy(&arena);
+            return 1;
         }
-         if (!process_list) {
-             fprintf(stderr, "Erro: Falha ao gerar lista de processos.\n");
-             return 1;
+        if (strlen(trace_filename) > 0 || strlen(series_filename) > 0 || strlen(rows_filename) > 0 ||
+            strlen(classes_filename) > 0 || gantt_ascii || strlen(gantt_csv_filename) > 0 || analyze) {
+            fprintf(stderr, "Aviso: --trace, --timeseries, --rows, --classes, --gantt e --analyze são ignorados em sistema aberto.\n");
+            trace_filename[0] = '\0';
+            series_filename[0] = '\0';
+            rows_filename[0] = '\0';
+            classes_filename[0] = '\0';
+        }
+        open_config.utilization = open_utilization;
+        open_config.burst_dist_type = burst_dist_type;
+        open_config.mean_norm = mean_norm;
+        open_config.stddev_norm = stddev_norm;
+        open_config.lambda_burst = lambda_burst;
+        open_config.prio_type = prio_type;
+        open_config.trace_path = open_trace;
+        open_config.arrivals = open_arrivals > 0 ? open_arrivals : (open_trace ? 0 : OPEN_DEFAULT_ARRIVALS);
+        if (open_batches > 0) open_config.batches = open_batches;
+    } else if (open_arrivals > 0 || open_batches > 0) {
+        fprintf(stderr, "Aviso: --arrivals e --batches só têm efeito com --open ou --open-trace.\n");
+    }
+    // Em processos os resultados ficam no ficheiro mapeado, não em memória.
+    int sharded = (workers > 0 || strlen(sweep_filename) > 0);
+    if (sharded && !sweep_spec) { fprintf(stderr, "Erro: --workers e --sweep-file requerem --sweep.\n"); simctx_destroy(&arena); return 1; }
+    if (sharded && strlen(sweep_filename) > 0 && replications > 1) {
+        fprintf(stderr, "Erro: --sweep-file não pode ser usado com --reps > 1.\n");
+        simctx_destroy(&arena);
+        return 1;
+    }
+    if (sharded && workers == 0) workers = sweep_default_jobs();
+    if (sweep_spec) {
+        if (!sweep_parse(sweep_spec, &config, sharded ? SHARD_MAX_POINTS : SWEEP_MAX_POINTS, &grid)) { simctx_destroy(&arena); return 1; }
+        int unused = sweep_varied_params(&grid, &config) & ~sim_algorithm_params(algorithm);
+        if (unused && sim_algorithm_valid(algorithm)) {
+            char keys[32];
+            sweep_param_keys(unused, keys, sizeof(keys));
+            fprintf(stderr, "Aviso: '%s' não usa %s: pontos que só diferem nessas chaves dão o mesmo resultado.\n", algorithm, keys);
+        }
+        if (!sharded) sweep_results = malloc(sizeof(SimResults) * grid.count);
+        sweep_rows = malloc(sizeof(const SimResults *) * grid.count);
+        if ((!sharded && !sweep_results) || !sweep_rows) {
+            fprintf(stderr, "Erro malloc varrimento\n");
+            free(sweep_results);
+            sweep_free(&grid);
+            simctx_destroy(&arena);
+            return 1;
+        }
+    }
+    if ((sweep_spec || tune_objective >= 0 || whatif_spec) &&
+        (strlen(trace_filename) > 0 || strlen(series_filename) > 0 || strlen(rows_filename) > 0 ||
+         strlen(classes_filename) > 0 || gantt_ascii || strlen(gantt_csv_filename) > 0)) {
+        fprintf(stderr, "Aviso: --trace, --timeseries, --rows, --classes e --gantt são ignorados com --sweep, --tune e --whatif.\n");
+        trace_filename[0] = '\0';
+        series_filename[0] = '\0';
+        rows_filename[0] = '\0';
+        classes_filename[0] = '\0';
+    }
+
+    if (verbose) {
+        printf("--- Simulador ProbSched ---\n");
+        printf("Config: Algo=%s, N=%d, Q=%d, TMax=%d, Seed=%s%d\n",
+               algorithm, num_processes, quantum, max_simulation_time,
+               use_fixed_seed ? "(fixa) " : "(tempo) ", seed);
+         printf("        Gen=%s", (strlen(input_filename)>0 ? "file" : generation_mode));
+         if (strlen(input_filename) == 0 && strcmp(generation_mode,"random")==0) {
+              printf(", Burst=%s(M=%.1f,SD=%.1f / L=%.2f), Prio=%s, L_Arr=%.2f\n",
+                    burst_dist_str, mean_norm, stddev_norm, lambda_burst, prio_gen_str, lambda_arrival);
+              printf("        IO: Chance=%.2f, Dur=%d-%d\n", io_chance, min_io_duration, max_io_duration);
+              if (bursts_per_process > 1) printf("        Bursts por processo: %d\n", bursts_per_process);
+         } else if (strlen(input_filename) > 0) {
+             printf(" ('%s')\n", input_filename);
+         } else {
+             printf("\n");
+         }
+         if (open_trace) {
+             printf("        Sistema Aberto: chegadas de '%s'", open_trace);
+             if (open_config.arrivals > 0) printf(" (até %lld)", open_config.arrivals);
+             printf(", Lotes=%d\n", open_config.batches);
+         } else if (open_mode) {
+             printf("        Sistema Aberto: rho=%.2f, Chegadas=%lld, Lotes=%d\n",
+                    open_utilization, open_config.arrivals, open_config.batches);
          }
     }
 
-    if (actual_process_count == 0) {
-        fprintf(stderr, "Erro: Nenhum processo para simular.\n");
-        return 1;
+    OutputWriter *metrics_out = NULL;
+    OutputWriter *rows_out = NULL;
+    OutputWriter *classes_out = NULL;
+    if (!verbose) {
+        metrics_out = output_open(strlen(output_filename) > 0 ? output_filename : NULL, output_format,
+                                  sweep_spec ? OUTPUT_SWEEP : (tune_objective >= 0 ? OUTPUT_TUNE :
+                                  (whatif_spec ? OUTPUT_WHATIF : (open_mode ? OUTPUT_OPEN : OUTPUT_METRICS))));
+        if (!metrics_out) { perror("Erro ao criar ficheiro de resultados"); simctx_destroy(&arena); return 1; }
+    }
+    if (strlen(rows_filename) > 0) {
+        rows_out = output_open(rows_filename, output_format, OUTPUT_ROWS);
+        if (!rows_out) { perror("Erro ao criar ficheiro de linhas por processo"); output_close(metrics_out); simctx_destroy(&arena); return 1; }
+        config.on_process = output_process;
+        config.process_arg = rows_out;
+    }
+    if (strlen(classes_filename) > 0) {
+        classes_out = output_open(classes_filename, output_format, OUTPUT_CLASSES);
+        if (!classes_out) {
+            perror("Erro ao criar ficheiro de métricas por classe");
+            output_close(rows_out); output_close(metrics_out); simctx_destroy(&arena);
+            return 1;
+        }
     }
 
-    print_process_list(process_list, actual_process_count);
-
-
-    printf("\nA executar algoritmo: %s\n", algorithm);
-    if (strcmp(algorithm, "fcfs") == 0) {
-        schedule_fcfs(process_list, actual_process_count, max_simulation_time);
-    } else if (strcmp(algorithm, "sjf") == 0) {
-        schedule_sjf(process_list, actual_process_count, max_simulation_time);
-    } else if (strcmp(algorithm, "rr") == 0) {
-        schedule_rr(process_list, actual_process_count, quantum, max_simulation_time);
-    } else if (strcmp(algorithm, "prio-np") == 0) {
-        schedule_priority(process_list, actual_process_count, 0, 0, max_simulation_time);
-    } else if (strcmp(algorithm, "prio-p") == 0) {
-        schedule_priority(process_list, actual_process_count, 1, 1, max_simulation_time);
-    } else if (strcmp(algorithm, "edf") == 0) {
-        schedule_edf_preemptive(process_list, actual_process_count, max_simulation_time);
-    } else if (strcmp(algorithm, "rm") == 0) {
-        schedule_rm_preemptive(process_list, actual_process_count, max_simulation_time);
-    } else if (strcmp(algorithm, "mlq") == 0) {
-         schedule_mlq(process_list, actual_process_count, quantum, max_simulation_time);
-    } else {
-        fprintf(stderr, "Erro: Algoritmo '%s' desconhecido.\n", algorithm);
-        free(process_list);
-        return 1;
+    // A cache só serve execuções cujo único produto são as métricas globais:
+    // o texto, o trace, o Gantt, as linhas por processo e --stats precisam
+    // da simulação em si.
+    ResultCache result_cache;
+    ResultCache *cache = NULL;
+    int metrics_only = !verbose && !rows_out && strlen(trace_filename) == 0 && strlen(series_filename) == 0 && !gantt_ascii &&
+                       strlen(gantt_csv_filename) == 0 && !show_stats;
+    if (use_cache && !open_mode && (sweep_spec || tune_objective >= 0 || metrics_only) && cache_open(&result_cache, cache_dir)) {
+        cache = &result_cache;
     }
 
+    int exit_code = 0;
+    clock_t replications_start = clock();
+    for (int rep = 0; rep < replications; rep++) {
+        int rep_seed = seed + rep;
+        // Cada replicação reutiliza a arena e as fases da anterior.
+        simctx_reset(&arena);
+        phase_arena_reset();
+        if (verbose && replications > 1) printf("\n=== Replicação %d/%d (Seed=%d) ===\n", rep + 1, replications, rep_seed);
+
+        srand(rep_seed);
+
+        if (open_mode) {
+            config.seed = (unsigned long long)rep_seed;
+            OpenResults open_results;
+            if (verbose) printf("\nA executar algoritmo: %s (sistema aberto)\n", algorithm);
+            STAT_PHASE_BEGIN(PHASE_SIMULATION);
+            int status = open_simulate(&config, &open_config, &open_results);
+            STAT_PHASE_END(PHASE_SIMULATION);
+            if (status != SIM_OK) {
+                // Sem ficheiro de chegadas, open_simulate já explicou o erro.
+                if (status != SIM_ERR_ARGS) fprintf(stderr, "Erro: Simulação falhou (%s).\n", sim_status_name(status));
+                exit_code = 1;
+                break;
+            }
+            if (open_results.in_system > open_config.max_live) {
+                fprintf(stderr, "Aviso: mais de %d processos em sistema em t=%lld: a fila não é estável (rho >= 1?); simulação interrompida.\n",
+                        open_config.max_live, open_results.final_time);
+            } else if (open_results.unstable) {
+                fprintf(stderr, "Aviso: o aquecimento ocupa metade da série (MSER-5); o regime estacionário pode não ter sido atingido (aumente --arrivals).\n");
+            }
+            if (verbose) print_open_report(&open_results);
+            if (metrics_out) {
+                output_begin_run(metrics_out, rep, rep_seed, algorithm);
+                output_open_results(metrics_out, &open_results);
+            }
+            continue;
+        }
+
+        ProcessSpec* process_list = NULL;
+        int actual_process_count = 0;
+
+        STAT_PHASE_BEGIN(PHASE_GENERATION);
+        if (strlen(input_filename) > 0) {
+            process_list = read_processes_from_file(&arena, input_filename, &actual_process_count);
+            if (!process_list) { exit_code = 1; break; }
+            num_processes = actual_process_count;
+        } else {
+            actual_process_count = num_processes;
+            if (strcmp(generation_mode, "static") == 0) {
+                 process_list = generate_static_processes(&arena, actual_process_count);
+            } else {
+                 double p1_burst = (burst_dist_type == 1) ? lambda_burst : mean_norm;
+                 double p2_burst = (burst_dist_type == 1) ? 0.0 : stddev_norm;
+                 process_list = generate_random_processes(&arena, actual_process_count, lambda_arrival, p1_burst, p2_burst, burst_dist_type, prio_type, io_chance, min_io_duration, max_io_duration, bursts_per_process);
+            }
+             if (!process_list) {
+                 fprintf(stderr, "Erro: Falha ao gerar lista de processos.\n");
+                 exit_code = 1;
+                 break;
+             }
+        }
+
+        STAT_PHASE_END(PHASE_GENERATION);
+
+        if (actual_process_count == 0) {
+            fprintf(stderr, "Erro: Nenhum processo para simular.\n");
+            exit_code = 1;
+            break;
+        }
+
+        if (verbose) print_process_list(process_list, actual_process_count);
+
+        if (analyze) {
+            SchedAnalysis analysis;
+            analyze_task_set(process_list, actual_process_count, switch_cost, &analysis);
+            if (verbose) print_schedulability_report(&analysis);
+            if (analyze_skip && analysis_decides(&analysis, algorithm)) {
+                if (verbose) printf("\nSimulação de '%s' ignorada: a análise garante que nenhum deadline é perdido.\n", algorithm);
+                simctx_free(&arena, process_list);
+                continue;
+            }
+        }
+
+        if (sweep_spec) {
+            config.seed = (unsigned long long)rep_seed;
+            SimWorkload workload = { process_list, actual_process_count, g_phase_arena.phases };
+            double wall_ms = 0.0;
+            ShardFile *shard = NULL;
+            ShardSummary summary = { 0 };
+            int status;
+            if (verbose) printf("\nA executar varrimento de '%s': %d pontos\n", algorithm, grid.count);
+            if (sharded && !sim_algorithm_valid(algorithm)) {
+                status = SIM_ERR_ALGORITHM;
+            } else if (sharded) {
+                shard = shard_open(strlen(sweep_filename) > 0 ? sweep_filename : NULL, &grid, &workload, &config);
+                status = shard ? shard_run(shard, &grid, &workload, &config, workers, cache, &summary) : SIM_ERR_ARGS;
+                wall_ms = summary.wall_ms;
+                for (int k = 0; shard && k < grid.count; k++) sweep_rows[k] = shard_result(shard, k);
+            } else {
+                long long hits_before = cache ? cache->hits : 0;
+                status = sweep_run(&grid, &workload, &config, jobs, cache, sweep_results, &wall_ms);
+                summary.cached = cache ? (int)(cache->hits - hits_before) : 0;
+                for (int k = 0; k < grid.count; k++) sweep_rows[k] = &sweep_results[k];
+            }
+            if (status == SIM_ERR_ALGORITHM) {
+                fprintf(stderr, "Erro: Algoritmo '%s' desconhecido.\n", algorithm);
+            } else if (status != SIM_OK && (shard || !sharded)) {
+                // Sem ficheiro, shard_open já explicou o erro.
+                fprintf(stderr, "Erro: Varrimento falhou (%s).\n", sim_status_name(status));
+            }
+            if (status != SIM_OK) {
+                shard_close(shard);
+                simctx_free(&arena, process_list);
+                exit_code = 1;
+                break;
+            }
+
+            if (verbose) {
+                print_sweep_table(&grid, sweep_rows, sharded ? workers : jobs, sharded ? "processos" : "threads", wall_ms,
+                                  (sim_algorithm_params(algorithm) & SIM_PARAM_MLQ_QUANTA) != 0);
+                if (cache) printf("Cache de Resultados:           %d de %d pontos lidos de '%s'\n", summary.cached, grid.count, cache->dir);
+                if (sharded) {
+                    printf("Ficheiro de Resultados:        %s\n", strlen(sweep_filename) > 0 ? sweep_filename : "(temporário)");
+                    printf("Pontos Calculados:             %d de %d (%d retomados; %d perdidos, %d workers substituídos)\n",
+                           summary.done, summary.total, summary.resumed, summary.lost, summary.respawns);
+                }
+            }
+            if (metrics_out) {
+                output_begin_run(metrics_out, rep, rep_seed, algorithm);
+                for (int k = 0; k < grid.count; k++) {
+                    if (!sweep_rows[k]) continue;
+                    SimConfig point_config;
+                    sweep_apply(&config, &grid.points[k], &point_config);
+                    output_sweep_point(metrics_out, k, &point_config, sweep_rows[k]);
+                }
+            }
+            if (sharded && summary.done < summary.total) {
+                fprintf(stderr, "Aviso: %d pontos do varrimento sem resultado.\n", summary.total - summary.done);
+                exit_code = 1;
+            }
+            shard_close(shard);
+            simctx_free(&arena, process_list);
+            continue;
+        }
+
+        if (whatif_spec) {
+            config.seed = (unsigned long long)rep_seed;
+            SimWorkload workload = { process_list, actual_process_count, g_phase_arena.phases };
+            WhatIfSummary summary;
+            if (verbose) printf("\nA executar '%s' com ramificação em t=%d\n", algorithm, whatif_time);
+            int status = whatif_run(&workload, &config, whatif_time, &whatif_grid, whatif_results, &summary);
+            simctx_free(&arena, process_list);
+            if (status == SIM_ERR_ALGORITHM) {
+                fprintf(stderr, "Erro: Algoritmo '%s' desconhecido.\n", algorithm);
+            } else if (status != SIM_OK) {
+                fprintf(stderr, "Erro: Simulação falhou (%s).\n", sim_status_name(status));
+            }
+            if (status != SIM_OK) {
+                exit_code = 1;
+                break;
+            }
+
+            SweepPoint base_point;
+            whatif_base_point(&config, &base_point);
+            if (verbose) print_whatif_table(&whatif_grid, &base_point, whatif_results, &summary,
+                                           (sim_algorithm_params(algorithm) & SIM_PARAM_MLQ_QUANTA) != 0);
+            if (metrics_out) {
+                output_begin_run(metrics_out, rep, rep_seed, algorithm);
+                output_whatif_variant(metrics_out, 0, summary.reached_time, &config, &whatif_results[0]);
+                for (int k = 0; k < whatif_grid.count; k++) {
+                    if (whatif_results[1 + k].status != SIM_OK) continue;
+                    SimConfig variant_config;
+                    sweep_apply(&config, &whatif_grid.points[k], &variant_config);
+                    output_whatif_variant(metrics_out, 1 + k, summary.reached_time, &variant_config, &whatif_results[1 + k]);
+                }
+            }
+            if (summary.lost > 0) {
+                fprintf(stderr, "Aviso: %d variantes do what-if sem resultado.\n", summary.lost);
+                exit_code = 1;
+            }
+            continue;
+        }
+
+        if (tune_objective >= 0) {
+            config.seed = (unsigned long long)rep_seed;
+            SimWorkload workload = { process_list, actual_process_count, g_phase_arena.phases };
+            TuneOptions options = { tune_objective, tune_budget, jobs, cache };
+            long long hits_before = cache ? cache->hits : 0;
+            TuneReport report;
+            if (verbose) printf("\nA afinar '%s' (objetivo: %s)\n", algorithm, tune_objective_name(tune_objective));
+            int status = tune_run(&workload, &config, &options, &report);
+            simctx_free(&arena, process_list);
+            if (status != SIM_OK) {
+                fprintf(stderr, "Erro: Afinação falhou (%s).\n", sim_status_name(status));
+                tune_free(&report);
+                exit_code = 1;
+                break;
+            }
+
+            if (verbose) {
+                print_tune_report(&report, algorithm, &options);
+                if (cache) printf("Cache de Resultados:           %lld avaliações lidas de '%s'\n", cache->hits - hits_before, cache->dir);
+            }
+            if (metrics_out) {
+                output_begin_run(metrics_out, rep, rep_seed, algorithm);
+                for (int k = 0; k < report.count; k++) {
+                    const TuneCandidate *c = &report.candidates[k];
+                    if (c->rung == report.rungs - 1) output_tune_candidate(metrics_out, c, k == report.best);
+                }
+            }
+            tune_free(&report);
+            continue;
+        }
+
+        // Com replicações, só a primeira é exportada para o trace e para a série.
+        config.trace_path = (rep == 0 && strlen(trace_filename) > 0) ? trace_filename : NULL;
+        config.series_path = (rep == 0 && strlen(series_filename) > 0) ? series_filename : NULL;
+        config.series_window = series_window;
+        config.seed = (unsigned long long)rep_seed;
+        SimWorkload workload = { process_list, actual_process_count, g_phase_arena.phases };
+        SimResults results;
+        if (rows_out) output_begin_run(rows_out, rep, rep_seed, algorithm);
+
+        if (verbose) printf("\nA executar algoritmo: %s\n", algorithm);
+        STAT_PHASE_BEGIN(PHASE_SIMULATION);
+        int status = metrics_only ? cache_simulate(cache, cache ? cache_hash_workload(&workload) : 0, &workload, &config, &results)
+                                  : simulate(&workload, &config, &results);
+        STAT_PHASE_END(PHASE_SIMULATION);
+        if (status == SIM_ERR_ALGORITHM) {
+            fprintf(stderr, "Erro: Algoritmo '%s' desconhecido.\n", algorithm);
+        } else if (status != SIM_OK && status != SIM_ERR_TRACE && status != SIM_ERR_SERIES &&
+                   status != SIM_ERR_CHECKPOINT) {
+            fprintf(stderr, "Erro: Simulação falhou (%s).\n", sim_status_name(status));
+        }
+        if (status != SIM_OK) {
+            simctx_free(&arena, process_list);
+            exit_code = 1;
+            break;
+        }
+
+        if (metrics_out) {
+            output_begin_run(metrics_out, rep, rep_seed, algorithm);
+            output_metrics(metrics_out, &results);
+        }
+        if (classes_out) {
+            output_begin_run(classes_out, rep, rep_seed, algorithm);
+            output_classes(classes_out, &results);
+            if (verbose) print_class_table(&results);
+        }
+        if (verbose && config.trace_path) {
+            printf("\nTrace escrito em '%s' (%lld eventos).\n", trace_filename, results.trace_events);
+        }
+        if (verbose && config.series_path) {
+            printf("Série temporal escrita em '%s' (%lld janelas de %d).\n", series_filename, results.series_windows, series_window);
+        }
+        if (verbose && config.checkpoint_path) {
+            printf("Checkpoints:                   %lld escritos em '%s'", results.checkpoints_written, config.checkpoint_path);
+            if (results.checkpoints_skipped > 0) printf(" (%lld saltados com a escrita ocupada)", results.checkpoints_skipped);
+            printf("\n");
+        }
+
+        simctx_free(&arena, process_list);
+    }
+
+    output_close(metrics_out);
+    output_close(rows_out);
+    output_close(classes_out);
+
+    if (verbose && exit_code == 0 && replications > 1) {
+        double elapsed_ms = 1000.0 * (clock() - replications_start) / CLOCKS_PER_SEC;
+        printf("\n--- Replicações ---\n");
+        printf("Execuções:                     %d (Seeds %d..%d)\n", replications, seed, seed + replications - 1);
+        printf("Tempo de CPU Total:            %.3f ms (%.3f ms por execução)\n", elapsed_ms, elapsed_ms / replications);
+        print_arena_report(&arena);
+    }
+
+    if (show_stats) {
+        stats_print();
+        if (replications == 1) print_arena_report(&arena);
+    }
 
-    free(process_list);
-    printf("\n--- Simulação Concluída ---\n");
-    return 0;
+    free(sweep_results);
+    free(sweep_rows);
+    sweep_free(&grid);
+    free(whatif_results);
+    sweep_free(&whatif_grid);
+    phase_arena_free();
+    simctx_destroy(&arena);
+    if (verbose && exit_code == 0) printf("\n--- Simulação Concluída ---\n");
+    return exit_code;
 }
\ No newline at end of file
@@ -0,0 +1,316 @@
+#include "opensys.h"
+#include "heap.h"
+#include "workload.h"
+#include "stats.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define OPEN_INITIAL_SLOTS 1024
+
+enum { OPEN_FCFS, OPEN_SJF, OPEN_SRTF, OPEN_RR, OPEN_PRIO_NP, OPEN_PRIO_P, OPEN_DISCIPLINES };
+static const char *open_algorithms[OPEN_DISCIPLINES] = { "fcfs", "sjf", "srtf", "rr", "prio-np", "prio-p" };
+
+// Trabalho em sistema. As posições livres formam uma lista ligada por
+// next_free e são reutilizadas pelas chegadas seguintes.
+typedef struct {
+    long long id;               // ordem de chegada
+    long long arrival;
+    long long service;
+    long long remaining;
+    int priority;
+    int next_free;
+} OpenJob;
+
+typedef struct {
+    long long arrival;
+    long long service;
+    int priority;
+} OpenArrival;
+
+typedef struct {
+    const SimConfig *cfg;
+    const OpenConfig *open;
+    int discipline;
+    unsigned long long rng;
+    FILE *trace;
+    double clock;               // relógio contínuo das chegadas Poisson
+    double lambda;
+    long long generated;
+    long long last_arrival;
+    long long clamped;          // chegadas do trace fora de ordem
+
+    OpenJob *jobs;
+    int slots;
+    int free_head;
+    long long live;
+    IndexedHeap ready;
+    long long enqueues;
+
+    SteadySeries response;
+    SteadySeries waiting;
+} OpenSim;
+
+void open_config_defaults(OpenConfig *open) {
+    memset(open, 0, sizeof(*open));
+    open->utilization = 0.7;
+    open->mean_norm = 10.0;
+    open->stddev_norm = 3.0;
+    open->lambda_burst = 0.1;
+    open->arrivals = OPEN_DEFAULT_ARRIVALS;
+    open->batches = OPEN_DEFAULT_BATCHES;
+    open->max_live = OPEN_DEFAULT_MAX_LIVE;
+}
+
+static int open_discipline(const char *algorithm) {
+    for (int k = 0; algorithm && k < OPEN_DISCIPLINES; k++) {
+        if (strcmp(algorithm, open_algorithms[k]) == 0) return k;
+    }
+    return -1;
+}
+
+int open_algorithm_supported(const char *algorithm) {
+    return open_discipline(algorithm) >= 0;
+}
+
+// Uniforme em (0, 1), do splitmix64 da execução.
+static double open_uniform(OpenSim *sim) {
+    unsigned long long z = (sim->rng += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return ((z >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+static long long sample_service(OpenSim *sim) {
+    const OpenConfig *open = sim->open;
+    double s;
+    if (open->burst_dist_type == 1) {
+        s = -log(open_uniform(sim)) / (open->lambda_burst > 0 ? open->lambda_burst : 0.1);
+    } else {
+        double z = sqrt(-2.0 * log(open_uniform(sim))) * cos(2.0 * M_PI * open_uniform(sim));
+        s = open->mean_norm + z * open->stddev_norm;
+    }
+    long long service = llround(s);
+    return service <= 0 ? 1 : service;
+}
+
+// Mesmas distribuições de prioridade que generate_random_processes.
+static int sample_priority(OpenSim *sim) {
+    int dice = (int)(open_uniform(sim) * 100.0);
+    if (sim->open->prio_type == 1) return 1 + dice % 5;
+    if (dice < 40) return 1;
+    if (dice < 70) return 2;
+    if (dice < 90) return 3;
+    if (dice < 97) return 4;
+    return 5;
+}
+
+// Próxima chegada; 0 quando acabam.
+static int next_arrival(OpenSim *sim, OpenArrival *a) {
+    const OpenConfig *open = sim->open;
+    if (open->arrivals > 0 && sim->generated >= open->arrivals) return 0;
+    if (sim->trace) {
+        int arrival, burst, priority;
+        if (!read_next_process_line(sim->trace, &arrival, &burst, &priority)) return 0;
+        a->arrival = arrival;
+        a->service = burst;
+        a->priority = priority;
+        if (a->arrival < sim->last_arrival) {
+            a->arrival = sim->last_arrival;
+            sim->clamped++;
+        }
+    } else {
+        sim->clock += -log(open_uniform(sim)) / sim->lambda;
+        a->arrival = llround(sim->clock);
+        a->service = sample_service(sim);
+        a->priority = sample_priority(sim);
+    }
+    sim->last_arrival = a->arrival;
+    sim->generated++;
+    return 1;
+}
+
+static int grow_slots(OpenSim *sim) {
+    int capacity = sim->slots * 2;
+    OpenJob *jobs = sim_realloc(sim->jobs, sizeof(OpenJob) * capacity);
+    if (!jobs) return 0;
+    sim->jobs = jobs;
+    if (!heap_reserve(&sim->ready, capacity)) return 0;
+    for (int i = sim->slots; i < capacity; i++) sim->jobs[i].next_free = (i + 1 < capacity) ? i + 1 : -1;
+    sim->free_head = sim->slots;
+    sim->slots = capacity;
+    return 1;
+}
+
+static void ready_push(OpenSim *sim, int slot) {
+    const OpenJob *job = &sim->jobs[slot];
+    switch (sim->discipline) {
+        case OPEN_FCFS:    heap_push(&sim->ready, slot, job->id, 0); break;
+        case OPEN_SJF:     heap_push(&sim->ready, slot, job->service, job->id); break;
+        case OPEN_SRTF:    heap_push(&sim->ready, slot, job->remaining, job->id); break;
+        case OPEN_RR:      heap_push(&sim->ready, slot, sim->enqueues++, 0); break;
+        default:           heap_push(&sim->ready, slot, job->priority, job->id); break;
+    }
+}
+
+// O trabalho que chegou passa à frente do que está a executar?
+static int preempts(const OpenSim *sim, const OpenJob *arrived, const OpenJob *running) {
+    if (sim->discipline == OPEN_SRTF) return arrived->remaining < running->remaining;
+    if (sim->discipline == OPEN_PRIO_P) return arrived->priority < running->priority;
+    return 0;
+}
+
+static void open_run(OpenSim *sim, OpenResults *res) {
+    const SimConfig *cfg = sim->cfg;
+    long long now = 0;
+    long long busy = 0, switching = 0, offered = 0;
+    long long last_id = -1;
+    int running = -1;
+    long long slice_left = 0;
+    OpenArrival next;
+    int have_next = next_arrival(sim, &next);
+
+    for (;;) {
+        STAT_INC(loop_iterations);
+        // Chegadas até agora.
+        while (have_next && next.arrival <= now) {
+            if (sim->free_head < 0 && !grow_slots(sim)) {
+                res->status = SIM_ERR_MEMORY;
+                return;
+            }
+            int slot = sim->free_head;
+            OpenJob *job = &sim->jobs[slot];
+            sim->free_head = job->next_free;
+            job->id = res->arrivals++;
+            job->arrival = next.arrival;
+            job->service = next.service;
+            job->remaining = next.service;
+            job->priority = next.priority;
+            offered += next.service;
+            if (++sim->live > res->max_in_system) res->max_in_system = sim->live;
+            if (running >= 0 && preempts(sim, job, &sim->jobs[running])) {
+                ready_push(sim, running);
+                running = -1;
+            }
+            ready_push(sim, slot);
+            have_next = next_arrival(sim, &next);
+        }
+        if (sim->live > sim->open->max_live) {
+            res->unstable = 1;
+            break;
+        }
+        // Sem fase de escoamento: termina na última chegada.
+        if (!have_next) break;
+
+        if (running < 0) {
+            if (sim->ready.size == 0) {
+                now = next.arrival;
+                continue;
+            }
+            running = heap_pop(&sim->ready);
+            const OpenJob *job = &sim->jobs[running];
+            if (last_id >= 0 && job->id != last_id) {
+                res->context_switches++;
+                switching += cfg->context_switch_cost;
+                now += cfg->context_switch_cost;
+            }
+            last_id = job->id;
+            slice_left = job->remaining;
+            if (sim->discipline == OPEN_RR && cfg->quantum < slice_left) slice_left = cfg->quantum;
+            if (cfg->context_switch_cost > 0) continue;
+        }
+
+        OpenJob *job = &sim->jobs[running];
+        long long run_for = slice_left;
+        if (next.arrival - now < run_for) run_for = next.arrival - now;
+        job->remaining -= run_for;
+        slice_left -= run_for;
+        busy += run_for;
+        now += run_for;
+        if (job->remaining == 0) {
+            long long response = now - job->arrival;
+            steady_add(&sim->response, (double)response);
+            steady_add(&sim->waiting, (double)(response - job->service));
+            res->completed++;
+            sim->live--;
+            job->next_free = sim->free_head;
+            sim->free_head = running;
+            running = -1;
+        } else if (slice_left == 0) {
+            // Fim do quantum (rr): volta para o fim da fila.
+            ready_push(sim, running);
+            running = -1;
+        }
+    }
+
+    res->final_time = now;
+    res->in_system = sim->live;
+    if (now > 0) {
+        res->offered_load = (double)offered / now;
+        res->utilization = 100.0 * busy / now;
+        res->switch_overhead = 100.0 * switching / now;
+        res->throughput = (double)res->completed / now;
+    }
+}
+
+int open_simulate(const SimConfig *cfg, const OpenConfig *open, OpenResults *results) {
+    memset(results, 0, sizeof(*results));
+    results->status = SIM_OK;
+    int discipline = open_discipline(cfg->algorithm);
+    if (discipline < 0) return results->status = SIM_ERR_ALGORITHM;
+    if (!open->trace_path && open->utilization <= 0.0) return results->status = SIM_ERR_ARGS;
+
+    OpenSim *sim = sim_calloc(1, sizeof(OpenSim));
+    if (!sim) return results->status = SIM_ERR_MEMORY;
+    sim->cfg = cfg;
+    sim->open = open;
+    sim->discipline = discipline;
+    sim->rng = cfg->seed;
+    double mean_service = (open->burst_dist_type == 1) ? 1.0 / (open->lambda_burst > 0 ? open->lambda_burst : 0.1)
+                                                         : open->mean_norm;
+    sim->lambda = open->utilization / (mean_service > 0 ? mean_service : 1.0);
+    steady_init(&sim->response);
+    steady_init(&sim->waiting);
+    if (open->trace_path) {
+        sim->trace = fopen(open->trace_path, "r");
+        if (!sim->trace) {
+            fprintf(stderr, "Erro ao abrir ficheiro de chegadas '%s': %s\n", open->trace_path, strerror(errno));
+            sim_free(sim);
+            return results->status = SIM_ERR_ARGS;
+        }
+    }
+    sim->slots = OPEN_INITIAL_SLOTS;
+    sim->jobs = sim_malloc(sizeof(OpenJob) * sim->slots);
+    if (!sim->jobs || !heap_init(&sim->ready, NULL, sim->slots)) {
+        results->status = SIM_ERR_MEMORY;
+    } else {
+        for (int i = 0; i < sim->slots; i++) sim->jobs[i].next_free = (i + 1 < sim->slots) ? i + 1 : -1;
+        sim->free_head = 0;
+        open_run(sim, results);
+        heap_free(&sim->ready);
+    }
+    results->slots = sim->slots;
+    if (sim->trace) fclose(sim->trace);
+    if (sim->clamped > 0) {
+        fprintf(stderr, "Aviso: %lld chegadas do ficheiro fora de ordem foram adiadas para a chegada anterior.\n",
+                sim->clamped);
+    }
+
+    if (results->status == SIM_OK) {
+        int cut = steady_mser(&sim->response);
+        steady_estimate(&sim->response, cut, open->batches, &results->response);
+        steady_estimate(&sim->waiting, cut, open->batches, &results->waiting);
+        results->warmup = cut * sim->response.bucket_size;
+        // Corte no limite do MSER: a série não chegou a estabilizar.
+        if (sim->response.buckets >= 4 && cut >= sim->response.buckets / 2) results->unstable = 1;
+    }
+    sim_free(sim->jobs);
+    sim_free(sim);
+    return results->status;
+}
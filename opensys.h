@@ -0,0 +1,61 @@
+#ifndef OPENSYS_H
+#define OPENSYS_H
+
+#include "probsched.h"
+#include "steady.h"
+
+// Sistema aberto (--open / --open-trace): em vez de uma carga fechada que
+// termina quando todos os processos completam, os trabalhos chegam sem parar
+// (Poisson com utilização alvo rho = lambda * E[S], ou lidos em fluxo de um
+// ficheiro) e saem do sistema ao terminar. O motor é orientado a eventos e
+// só guarda os trabalhos presentes: as posições dos que terminam são
+// reutilizadas, pelo que a memória depende do número em sistema e não do
+// número de chegadas. Os tempos de resposta e de espera, pela ordem de
+// conclusão, alimentam séries de memória constante (steady.h) que descartam
+// o aquecimento (MSER-5) e dão intervalos de confiança por médias de lotes.
+//
+// Disciplinas: fcfs, sjf, srtf, rr, prio-np e prio-p (sem aging). A
+// simulação para na última chegada: os trabalhos ainda em sistema não contam
+// para as médias (não há fase de escoamento).
+#define OPEN_DEFAULT_ARRIVALS 1000000LL
+#define OPEN_DEFAULT_BATCHES  20
+#define OPEN_DEFAULT_MAX_LIVE (1 << 22)
+
+typedef struct {
+    double utilization;          // rho alvo (chegadas Poisson); ignorado com trace_path
+    int burst_dist_type;         // 0 normal, 1 exponencial (como --burst-dist)
+    double mean_norm;
+    double stddev_norm;
+    double lambda_burst;
+    int prio_type;               // 0 ponderada, 1 uniforme (como --prio-gen)
+    const char *trace_path;      // chegadas lidas do ficheiro, por ordem
+    long long arrivals;          // chegadas a simular (0 = todo o trace)
+    int batches;                 // lotes do intervalo de confiança
+    int max_live;                // trabalhos em sistema a partir dos quais a fila é instável
+} OpenConfig;
+
+typedef struct {
+    int status;                  // SimStatus
+    long long arrivals;
+    long long completed;
+    long long warmup;            // conclusões descartadas pelo MSER-5
+    long long in_system;         // trabalhos em sistema no fim
+    long long final_time;
+    double offered_load;         // sum(S) / final_time das chegadas
+    double utilization;          // % do tempo a executar trabalho
+    double switch_overhead;      // % do tempo em trocas de contexto
+    double throughput;
+    long long context_switches;
+    long long max_in_system;
+    int slots;                   // posições reservadas (memória do motor)
+    int unstable;                // fila a crescer sem limite ou sem regime estacionário
+    SteadyEstimate response;
+    SteadyEstimate waiting;
+} OpenResults;
+
+void open_config_defaults(OpenConfig *open);
+int  open_algorithm_supported(const char *algorithm);
+// Usa de cfg o algoritmo, o quantum, o custo das trocas e a semente.
+int  open_simulate(const SimConfig *cfg, const OpenConfig *open, OpenResults *results);
+
+#endif
@@ -0,0 +1,313 @@
+#include "output.h"
+#include "stats.h"
+#include <stdio.h>
+#include <string.h>
+
+#define OUTPUT_FILE_BUFFER (1 << 20)
+
+struct OutputWriter {
+    FILE *file;
+    char *file_buffer;
+    OutputFormat format;
+    OutputKind kind;
+    long long records;
+    int rep;
+    int seed;
+    const char *algorithm;
+};
+
+#define OPEN_COLUMNS \
+    "rep,seed,algorithm,arrivals,completed,warmup,in_system,final_time,offered_load," \
+    "utilization,switch_overhead,throughput,context_switches,max_in_system,slots," \
+    "avg_response,response_ci,avg_waiting,waiting_ci,batches,batch_size,unstable"
+
+#define METRIC_COLUMNS \
+    "processes,final_time,idle_time,context_switches,context_switch_cost," \
+    "completed,avg_waiting,avg_turnaround,cpu_utilization,throughput,deadline_misses," \
+    "bursts_done,bursts_total,avg_burst_wait,avg_burst_turnaround,max_burst_wait," \
+    "jobs_released,jobs_completed,jobs_missed,p99_waiting,jain_index,max_ready_wait," \
+    "admitted,admission_rejected,deferred,deferred_admitted,deferred_pending"
+
+#define LATENCY_COLUMNS(m) "avg_" m ",p50_" m ",p95_" m ",p99_" m
+
+#define CLASS_COLUMNS \
+    "rep,seed,algorithm,class,level,completed," LATENCY_COLUMNS("waiting") "," \
+    LATENCY_COLUMNS("turnaround") "," LATENCY_COLUMNS("response") "," \
+    "deadline_misses,cpu_share,max_ready_wait,jain_index"
+
+static const char *format_names[] = { "text", "csv", "json", "ndjson" };
+
+int output_parse_format(const char *name) {
+    for (int k = 0; k <= OUTPUT_NDJSON; k++) {
+        if (strcmp(name, format_names[k]) == 0) return k;
+    }
+    return -1;
+}
+
+static const char *process_status(const SimProcessResult *row) {
+    if (row->rejected) return "rejeitado";
+    if (row->completed || row->state == STATE_TERMINATED) return "completo";
+    switch (row->state) {
+        case STATE_RUNNING:  return "executando";
+        case STATE_READY:    return "pronto";
+        case STATE_BLOCKED:  return "bloqueado";
+        case STATE_DEFERRED: return "adiado";
+        case STATE_NEW:      return "pendente";
+        default:             return "desconhecido";
+    }
+}
+
+OutputWriter *output_open(const char *path, OutputFormat format, OutputKind kind) {
+    OutputWriter *w = sim_calloc(1, sizeof(OutputWriter));
+    if (!w) return NULL;
+    w->format = (format == OUTPUT_TEXT) ? OUTPUT_CSV : format;
+    w->kind = kind;
+    if (path) {
+        w->file_buffer = sim_malloc(OUTPUT_FILE_BUFFER);
+        w->file = w->file_buffer ? fopen(path, "w") : NULL;
+        if (!w->file) {
+            sim_free(w->file_buffer);
+            sim_free(w);
+            return NULL;
+        }
+        setvbuf(w->file, w->file_buffer, _IOFBF, OUTPUT_FILE_BUFFER);
+    } else {
+        w->file = stdout;
+    }
+
+    if (w->format == OUTPUT_CSV && kind == OUTPUT_ROWS) {
+        fputs("rep,algorithm,pid,arrival,burst,priority,deadline,io_dur,start,finish,"
+              "turnaround,waiting,deadline_met,bursts_done,bursts_total,remaining,status\n", w->file);
+    } else if (w->format == OUTPUT_CSV && kind == OUTPUT_OPEN) {
+        fputs(OPEN_COLUMNS "\n", w->file);
+    } else if (w->format == OUTPUT_CSV && kind == OUTPUT_CLASSES) {
+        fputs(CLASS_COLUMNS "\n", w->file);
+    } else if (w->format == OUTPUT_CSV) {
+        if (kind == OUTPUT_SWEEP) fputs("rep,point,algorithm,quantum,cs,aging,aging_interval,mlq_q0,mlq_q1,", w->file);
+        else if (kind == OUTPUT_TUNE) fputs("rep,algorithm,quantum,aging,mlq_q0,mlq_q1,objective,switch_overhead,feasible,pareto,best,", w->file);
+        else if (kind == OUTPUT_WHATIF) fputs("rep,variant,branch_time,algorithm,quantum,cs,aging,aging_interval,mlq_q0,mlq_q1,", w->file);
+        else fputs("rep,seed,algorithm,", w->file);
+        fputs(METRIC_COLUMNS "\n", w->file);
+    } else if (w->format == OUTPUT_JSON) {
+        fputs("[", w->file);
+    }
+    return w;
+}
+
+void output_begin_run(OutputWriter *w, int rep, int seed, const char *algorithm) {
+    w->rep = rep;
+    w->seed = seed;
+    w->algorithm = algorithm;
+}
+
+// Separador entre registos: vírgula no array JSON, nada nos outros formatos.
+static void begin_record(OutputWriter *w) {
+    if (w->format == OUTPUT_JSON) fputs(w->records > 0 ? ",\n" : "\n", w->file);
+    w->records++;
+}
+
+// Campo inteiro opcional (-1 = não aplicável): vazio em CSV, null em JSON.
+static void put_opt(FILE *f, int csv, int value) {
+    if (value >= 0) fprintf(f, "%d", value);
+    else if (!csv) fputs("null", f);
+}
+
+void output_process(void *arg, const SimProcessResult *row) {
+    OutputWriter *w = (OutputWriter *)arg;
+    FILE *f = w->file;
+    begin_record(w);
+    if (w->format == OUTPUT_CSV) {
+        fprintf(f, "%d,%s,%d,%d,%d,%d,%d,%d,", w->rep, w->algorithm, row->id, row->arrival_time,
+                row->burst_time, row->priority, row->deadline, row->io_burst_duration);
+        put_opt(f, 1, row->start_time); fputc(',', f);
+        put_opt(f, 1, row->finish_time); fputc(',', f);
+        put_opt(f, 1, row->turnaround_time); fputc(',', f);
+        put_opt(f, 1, row->waiting_time); fputc(',', f);
+        put_opt(f, 1, row->deadline_met);
+        fprintf(f, ",%d,%d,%d,%s\n", row->bursts_done, row->bursts_total, row->remaining_time, process_status(row));
+        return;
+    }
+    fprintf(f, "{\"rep\":%d,\"algorithm\":\"%s\",\"pid\":%d,\"arrival\":%d,\"burst\":%d,\"priority\":%d,"
+               "\"deadline\":%d,\"io_dur\":%d,\"start\":", w->rep, w->algorithm, row->id, row->arrival_time,
+            row->burst_time, row->priority, row->deadline, row->io_burst_duration);
+    put_opt(f, 0, row->start_time);
+    fputs(",\"finish\":", f);
+    put_opt(f, 0, row->finish_time);
+    fputs(",\"turnaround\":", f);
+    put_opt(f, 0, row->turnaround_time);
+    fputs(",\"waiting\":", f);
+    put_opt(f, 0, row->waiting_time);
+    fprintf(f, ",\"deadline_met\":%s,\"bursts_done\":%d,\"bursts_total\":%d,\"remaining\":%d,\"status\":\"%s\"}",
+            row->deadline_met < 0 ? "null" : (row->deadline_met ? "true" : "false"),
+            row->bursts_done, row->bursts_total, row->remaining_time, process_status(row));
+    if (w->format == OUTPUT_NDJSON) fputc('\n', f);
+}
+
+// Campos comuns a output_metrics e output_sweep_point, depois dos que
+// identificam a execução (o objeto JSON já está aberto).
+static void write_metric_fields(OutputWriter *w, const SimResults *res) {
+    FILE *f = w->file;
+    if (w->format == OUTPUT_CSV) {
+        fprintf(f, "%d,%d,%d,%d,%d,%d,%.4f,%.4f,%.4f,%.6f,%d,%lld,%lld,%.4f,%.4f,%d,%lld,%lld,%lld,%.4f,%.4f,%d,%d,%d,%d,%d,%d\n",
+                res->process_count, res->final_time, res->idle_time,
+                res->context_switches, res->context_switch_cost, res->completed,
+                res->avg_waiting_time, res->avg_turnaround_time, res->cpu_utilization, res->throughput,
+                res->deadline_misses, res->bursts_done, res->bursts_total,
+                res->avg_burst_wait, res->avg_burst_turnaround, res->max_burst_wait,
+                res->jobs_released, res->jobs_completed, res->jobs_missed, res->p99_waiting_time,
+                res->jain_index, res->max_ready_wait,
+                res->admission_admitted, res->admission_rejected, res->admission_deferred,
+                res->admission_deferred_admitted, res->admission_deferred_pending);
+        return;
+    }
+    fprintf(f, "\"processes\":%d,\"final_time\":%d,\"idle_time\":%d,"
+               "\"context_switches\":%d,\"context_switch_cost\":%d,\"completed\":%d,"
+               "\"avg_waiting\":%.4f,\"avg_turnaround\":%.4f,\"cpu_utilization\":%.4f,\"throughput\":%.6f,"
+               "\"deadline_misses\":%d,\"bursts_done\":%lld,\"bursts_total\":%lld,"
+               "\"avg_burst_wait\":%.4f,\"avg_burst_turnaround\":%.4f,\"max_burst_wait\":%d,"
+               "\"jobs_released\":%lld,\"jobs_completed\":%lld,\"jobs_missed\":%lld,\"p99_waiting\":%.4f,"
+               "\"jain_index\":%.4f,\"max_ready_wait\":%d,"
+               "\"admission\":{\"admitted\":%d,\"rejected\":%d,\"deferred\":%d,\"deferred_admitted\":%d,"
+               "\"deferred_pending\":%d},\"io\":[",
+            res->process_count, res->final_time, res->idle_time,
+            res->context_switches, res->context_switch_cost, res->completed,
+            res->avg_waiting_time, res->avg_turnaround_time, res->cpu_utilization, res->throughput,
+            res->deadline_misses, res->bursts_done, res->bursts_total,
+            res->avg_burst_wait, res->avg_burst_turnaround, res->max_burst_wait,
+            res->jobs_released, res->jobs_completed, res->jobs_missed, res->p99_waiting_time,
+            res->jain_index, res->max_ready_wait,
+            res->admission_admitted, res->admission_rejected, res->admission_deferred,
+            res->admission_deferred_admitted, res->admission_deferred_pending);
+    for (int k = 0; k < res->io_device_count; k++) {
+        const SimIoDeviceResult *d = &res->io[k];
+        fprintf(f, "%s{\"device\":%d,\"requests\":%lld,\"utilization\":%.4f,\"avg_queue_delay\":%.4f,"
+                   "\"max_queue_delay\":%d,\"max_queue_length\":%d}",
+                k > 0 ? "," : "", k, d->requests, d->utilization, d->avg_queue_delay,
+                d->max_queue_delay, d->max_queue_length);
+    }
+    fputs("]}", f);
+    if (w->format == OUTPUT_NDJSON) fputc('\n', f);
+}
+
+void output_metrics(OutputWriter *w, const SimResults *res) {
+    begin_record(w);
+    if (w->format == OUTPUT_CSV) fprintf(w->file, "%d,%d,%s,", w->rep, w->seed, w->algorithm);
+    else fprintf(w->file, "{\"rep\":%d,\"seed\":%d,\"algorithm\":\"%s\",", w->rep, w->seed, w->algorithm);
+    write_metric_fields(w, res);
+}
+
+static void write_latency(FILE *f, int csv, const char *name, const SimLatency *l) {
+    if (csv) fprintf(f, "%.4f,%.4f,%.4f,%.4f,", l->avg, l->p50, l->p95, l->p99);
+    else fprintf(f, "\"avg_%s\":%.4f,\"p50_%s\":%.4f,\"p95_%s\":%.4f,\"p99_%s\":%.4f,",
+                 name, l->avg, name, l->p50, name, l->p95, name, l->p99);
+}
+
+static void write_class(OutputWriter *w, const char *cls, int level, const SimClassResult *c) {
+    FILE *f = w->file;
+    int csv = (w->format == OUTPUT_CSV);
+    begin_record(w);
+    if (csv) fprintf(f, "%d,%d,%s,%s,%d,%lld,", w->rep, w->seed, w->algorithm, cls, level, c->completed);
+    else fprintf(f, "{\"rep\":%d,\"seed\":%d,\"algorithm\":\"%s\",\"class\":\"%s\",\"level\":%d,\"completed\":%lld,",
+                 w->rep, w->seed, w->algorithm, cls, level, c->completed);
+    write_latency(f, csv, "waiting", &c->waiting);
+    write_latency(f, csv, "turnaround", &c->turnaround);
+    write_latency(f, csv, "response", &c->response);
+    if (csv) {
+        fprintf(f, "%lld,%.4f,%d,%.4f\n", c->deadline_misses, c->cpu_share, c->max_ready_wait, c->jain_index);
+        return;
+    }
+    fprintf(f, "\"deadline_misses\":%lld,\"cpu_share\":%.4f,\"max_ready_wait\":%d,\"jain_index\":%.4f}",
+            c->deadline_misses, c->cpu_share, c->max_ready_wait, c->jain_index);
+    if (w->format == OUTPUT_NDJSON) fputc('\n', f);
+}
+
+void output_classes(OutputWriter *w, const SimResults *res) {
+    for (int k = 0; k < SIM_PRIORITY_CLASSES; k++) write_class(w, "priority", k + 1, &res->priority_class[k]);
+    for (int k = 0; res->queue_classes && k < SIM_QUEUE_CLASSES; k++) write_class(w, "queue", k, &res->queue_class[k]);
+}
+
+void output_sweep_point(OutputWriter *w, int point, const SimConfig *cfg, const SimResults *res) {
+    begin_record(w);
+    if (w->format == OUTPUT_CSV) {
+        fprintf(w->file, "%d,%d,%s,%d,%d,%d,%d,%d,%d,", w->rep, point, w->algorithm, cfg->quantum,
+                cfg->context_switch_cost, cfg->aging_threshold, cfg->aging_interval,
+                cfg->mlq_quantum[0], cfg->mlq_quantum[1]);
+    } else {
+        fprintf(w->file, "{\"rep\":%d,\"point\":%d,\"algorithm\":\"%s\",\"quantum\":%d,\"cs\":%d,"
+                         "\"aging\":%d,\"aging_interval\":%d,\"mlq_q0\":%d,\"mlq_q1\":%d,", w->rep, point,
+                w->algorithm, cfg->quantum, cfg->context_switch_cost, cfg->aging_threshold, cfg->aging_interval,
+                cfg->mlq_quantum[0], cfg->mlq_quantum[1]);
+    }
+    write_metric_fields(w, res);
+}
+
+void output_tune_candidate(OutputWriter *w, const TuneCandidate *c, int best) {
+    const SweepPoint *pt = &c->point;
+    begin_record(w);
+    if (w->format == OUTPUT_CSV) {
+        fprintf(w->file, "%d,%s,%d,%d,%d,%d,%.4f,%.4f,%d,%d,%d,", w->rep, w->algorithm, pt->quantum,
+                pt->aging_threshold, pt->mlq_quantum[0], pt->mlq_quantum[1], c->objective, c->overhead,
+                c->feasible, c->front == 0, best);
+    } else {
+        fprintf(w->file, "{\"rep\":%d,\"algorithm\":\"%s\",\"quantum\":%d,\"aging\":%d,\"mlq_q0\":%d,"
+                         "\"mlq_q1\":%d,\"objective\":%.4f,\"switch_overhead\":%.4f,\"feasible\":%s,"
+                         "\"pareto\":%s,\"best\":%s,", w->rep, w->algorithm, pt->quantum, pt->aging_threshold,
+                pt->mlq_quantum[0], pt->mlq_quantum[1], c->objective, c->overhead,
+                c->feasible ? "true" : "false", c->front == 0 ? "true" : "false", best ? "true" : "false");
+    }
+    write_metric_fields(w, &c->result);
+}
+
+void output_whatif_variant(OutputWriter *w, int variant, int branch_time, const SimConfig *cfg, const SimResults *res) {
+    begin_record(w);
+    if (w->format == OUTPUT_CSV) {
+        fprintf(w->file, "%d,%d,%d,%s,%d,%d,%d,%d,%d,%d,", w->rep, variant, branch_time, w->algorithm, cfg->quantum,
+                cfg->context_switch_cost, cfg->aging_threshold, cfg->aging_interval,
+                cfg->mlq_quantum[0], cfg->mlq_quantum[1]);
+    } else {
+        fprintf(w->file, "{\"rep\":%d,\"variant\":%d,\"branch_time\":%d,\"algorithm\":\"%s\",\"quantum\":%d,\"cs\":%d,"
+                         "\"aging\":%d,\"aging_interval\":%d,\"mlq_q0\":%d,\"mlq_q1\":%d,", w->rep, variant, branch_time,
+                w->algorithm, cfg->quantum, cfg->context_switch_cost, cfg->aging_threshold, cfg->aging_interval,
+                cfg->mlq_quantum[0], cfg->mlq_quantum[1]);
+    }
+    write_metric_fields(w, res);
+}
+
+void output_open_results(OutputWriter *w, const OpenResults *res) {
+    FILE *f = w->file;
+    begin_record(w);
+    if (w->format == OUTPUT_CSV) {
+        fprintf(f, "%d,%d,%s,%lld,%lld,%lld,%lld,%lld,%.4f,%.2f,%.2f,%.6f,%lld,%lld,%d,%.4f,%.4f,%.4f,%.4f,%d,%lld,%d\n",
+                w->rep, w->seed, w->algorithm, res->arrivals, res->completed, res->warmup, res->in_system,
+                res->final_time, res->offered_load, res->utilization, res->switch_overhead, res->throughput,
+                res->context_switches, res->max_in_system, res->slots, res->response.mean, res->response.half_width,
+                res->waiting.mean, res->waiting.half_width, res->response.batches, res->response.batch_size,
+                res->unstable);
+        return;
+    }
+    fprintf(f, "{\"rep\":%d,\"seed\":%d,\"algorithm\":\"%s\",\"arrivals\":%lld,\"completed\":%lld,\"warmup\":%lld,"
+               "\"in_system\":%lld,\"final_time\":%lld,\"offered_load\":%.4f,\"utilization\":%.2f,"
+               "\"switch_overhead\":%.2f,\"throughput\":%.6f,\"context_switches\":%lld,\"max_in_system\":%lld,"
+               "\"slots\":%d,\"avg_response\":%.4f,\"response_ci\":%.4f,\"avg_waiting\":%.4f,\"waiting_ci\":%.4f,"
+               "\"batches\":%d,\"batch_size\":%lld,\"unstable\":%s}",
+            w->rep, w->seed, w->algorithm, res->arrivals, res->completed, res->warmup, res->in_system,
+            res->final_time, res->offered_load, res->utilization, res->switch_overhead, res->throughput,
+            res->context_switches, res->max_in_system, res->slots, res->response.mean, res->response.half_width,
+            res->waiting.mean, res->waiting.half_width, res->response.batches, res->response.batch_size,
+            res->unstable ? "true" : "false");
+    if (w->format == OUTPUT_NDJSON) fputc('\n', f);
+}
+
+long long output_close(OutputWriter *w) {
+    if (!w) return 0;
+    if (w->format == OUTPUT_JSON) fputs(w->records > 0 ? "\n]\n" : "]\n", w->file);
+    long long records = w->records;
+    if (w->file == stdout) {
+        fflush(stdout);
+    } else {
+        fclose(w->file);
+        sim_free(w->file_buffer);
+    }
+    sim_free(w);
+    return records;
+}
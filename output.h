@@ -0,0 +1,57 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include "probsched.h"
+#include "tune.h"
+#include "opensys.h"
+
+// Saída estruturada dos resultados (--format csv|json|ndjson) em vez das
+// tabelas de texto. Cada escritor é um ficheiro com buffer grande: as
+// métricas globais saem uma linha/objeto por execução, e as linhas por
+// processo (--rows) são escritas à medida que os processos terminam, pelo
+// callback on_process de SimConfig.
+typedef enum {
+    OUTPUT_TEXT,
+    OUTPUT_CSV,
+    OUTPUT_JSON,
+    OUTPUT_NDJSON
+} OutputFormat;
+
+typedef enum {
+    OUTPUT_METRICS,      // uma linha por execução (métricas globais)
+    OUTPUT_ROWS,         // uma linha por processo
+    OUTPUT_SWEEP,        // uma linha por ponto de um varrimento (--sweep)
+    OUTPUT_TUNE,         // uma linha por candidato da ronda final da afinação (--tune)
+    OUTPUT_WHATIF,       // uma linha por continuação de uma ramificação (--whatif)
+    OUTPUT_OPEN,         // uma linha por execução em sistema aberto (--open)
+    OUTPUT_CLASSES       // uma linha por classe de prioridade/fila de cada execução (--classes)
+} OutputKind;
+
+typedef struct OutputWriter OutputWriter;
+
+// Devolve o formato ou -1 se o nome for desconhecido.
+int  output_parse_format(const char *name);
+
+// path == NULL escreve no stdout. Devolve NULL se o ficheiro não abrir.
+OutputWriter *output_open(const char *path, OutputFormat format, OutputKind kind);
+// Identifica as linhas seguintes (replicação, semente e algoritmo).
+void output_begin_run(OutputWriter *w, int rep, int seed, const char *algorithm);
+// Compatível com SimProcessFn: arg é o OutputWriter de linhas.
+void output_process(void *arg, const SimProcessResult *row);
+void output_metrics(OutputWriter *w, const SimResults *res);
+// Métricas por classe de uma execução: as prioridades 1..5 e, no mlq, as
+// filas Q0..Q2.
+void output_classes(OutputWriter *w, const SimResults *res);
+// Ponto 'point' de um varrimento, com os parâmetros que o definem.
+void output_sweep_point(OutputWriter *w, int point, const SimConfig *cfg, const SimResults *res);
+// Candidato da ronda final da afinação; 'best' marca o escolhido.
+void output_tune_candidate(OutputWriter *w, const TuneCandidate *c, int best);
+// Continuação 'variant' de uma ramificação (0 = sem alterações) no instante
+// 'branch_time' (-1 = não aconteceu).
+void output_whatif_variant(OutputWriter *w, int variant, int branch_time, const SimConfig *cfg, const SimResults *res);
+// Execução em sistema aberto, com as médias em regime estacionário.
+void output_open_results(OutputWriter *w, const OpenResults *res);
+// Fecha o documento e o ficheiro; devolve o número de registos escritos.
+long long output_close(OutputWriter *w);
+
+#endif
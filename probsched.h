@@ -0,0 +1,247 @@
+#ifndef PROBSCHED_H
+#define PROBSCHED_H
+
+#include "process.h"
+#include "simctx.h"
+#include "iodev.h"
+
+// API embebível do simulador (libprobsched). simulate() é reentrante: todo o
+// estado de uma execução (cópia local dos processos, dispositivos de I/O,
+// trace, gerador aleatório) vive na própria chamada, pelo que várias
+// simulações podem correr em paralelo sobre a mesma carga, desde que cada
+// uma use a sua arena. Nada é escrito no stdout; as mensagens do motor só
+// são produzidas se for indicado um destino de registo (log).
+
+#define ADMISSION_NONE 0
+#define ADMISSION_REJECT 1
+#define ADMISSION_DEFER 2
+#define SJF_PRED_DEFAULT_ALPHA 0.5
+#define SJF_PRED_DEFAULT_TAU0 10.0
+#define MLQ_RR_LEVELS 2          // filas RR do mlq (Q0, Q1); Q2 é FCFS
+#define SIM_PRIORITY_CLASSES 5   // classes por prioridade da carga (1..5)
+#define SIM_QUEUE_CLASSES 3      // classes por fila do mlq (Q0..Q2)
+// Versão dos resultados do motor: incrementar sempre que uma alteração mude
+// o SimResults de alguma simulação (invalida a cache de resultados).
+#define SIM_RESULTS_VERSION 5
+
+typedef enum {
+    SIM_OK = 0,
+    SIM_ERR_ARGS,          // carga ou configuração inválida
+    SIM_ERR_ALGORITHM,     // algoritmo desconhecido
+    SIM_ERR_MEMORY,        // falha de alocação
+    SIM_ERR_TRACE,         // não foi possível criar o ficheiro de trace
+    SIM_ERR_CHECKPOINT,    // checkpoint a retomar ilegível ou de outra simulação
+    SIM_ERR_SERIES         // não foi possível escrever a série temporal
+} SimStatus;
+
+typedef enum {
+    SIM_PARAM_QUANTUM = 1,       // quantum (no mlq, por omissão dos quanta das filas)
+    SIM_PARAM_AGING = 2,         // limiar e intervalo do aging
+    SIM_PARAM_MLQ_QUANTA = 4     // quanta das filas Q0/Q1 do mlq
+} SimParam;
+
+typedef enum {
+    SIM_LOG_INFO,          // eventos da simulação e relatórios
+    SIM_LOG_ERROR          // erros e avisos
+} SimLogLevel;
+
+// Recebe cada mensagem já formatada (pode conter várias linhas).
+typedef void (*SimLogFn)(void *arg, int level, const char *text);
+
+// Resultado de um processo, entregue quando o processo termina (ou no fim da
+// simulação, com o estado em que ficou). Campos -1 = não aplicável.
+typedef struct {
+    int id;
+    int arrival_time;
+    int burst_time;
+    int priority;
+    int deadline;
+    int io_burst_duration;
+    int start_time;
+    int finish_time;
+    int turnaround_time;
+    int waiting_time;
+    int deadline_met;            // 1 / 0, -1 se não completou
+    int bursts_done;
+    int bursts_total;
+    int remaining_time;
+    int completed;
+    int rejected;                // rejeitado pelo controlo de admissão
+    int state;                   // ProcessState final
+} SimProcessResult;
+
+typedef void (*SimProcessFn)(void *arg, const SimProcessResult *row);
+
+// Parâmetros de execução no ponto de ramificação; o callback pode alterá-los
+// e a simulação continua com os novos valores (mlq_quantum já resolvidos).
+typedef struct {
+    int time;                    // instante em que a ramificação aconteceu (só leitura)
+    int quantum;
+    int context_switch_cost;
+    int aging_threshold;
+    int aging_interval;
+    int mlq_quantum[MLQ_RR_LEVELS];
+} SimParams;
+
+// Chamado uma vez, no primeiro passo do motor com tempo >= branch_time; é o
+// ponto onde um chamador pode fazer fork() para explorar continuações a
+// partir do mesmo estado (ver whatif.h).
+typedef void (*SimBranchFn)(void *arg, SimParams *params);
+
+// Carga a simular. Não é alterada; phases é o vetor a que phase_offset de
+// cada processo se refere (g_phase_arena.phases nas cargas geradas).
+typedef struct {
+    const ProcessSpec *processes;
+    int count;
+    const Phase *phases;
+} SimWorkload;
+
+typedef struct {
+    const char *algorithm;       // fcfs, sjf, srtf, sjf-pred, rr, lottery, stride,
+                                 // prio-np, prio-p, edf, rm, mlq
+    int quantum;
+    int max_simulation_time;     // -1 = sem limite
+    unsigned long long seed;     // gerador interno (sorteios da lottery)
+    double pred_alpha;
+    double pred_tau0;
+    int admission_mode;          // ADMISSION_NONE / _REJECT / _DEFER
+    int context_switch_cost;     // custo de cada troca de contexto (>= 0)
+    int aging_threshold;         // prio-p: ticks em READY até subir a prioridade
+    int aging_interval;          // prio-p: período das verificações de aging
+    int mlq_quantum[MLQ_RR_LEVELS]; // mlq: quantum de Q0/Q1 (0 = quantum e 2*quantum)
+
+    IoDeviceSpec io_devices[IODEV_MAX];
+    int io_device_count;         // 0 = I/O sem contenção
+
+    SimLogFn log;                // NULL = execução silenciosa
+    void *log_arg;
+    int log_level;               // nível mínimo entregue ao log (SIM_LOG_INFO)
+
+    SimProcessFn on_process;     // NULL = sem resultados por processo
+    void *process_arg;
+
+    const char *trace_path;      // NULL = sem trace
+    const char *series_path;     // NULL = sem série temporal (--timeseries)
+    int series_window;           // largura das janelas da série
+    int gantt_ascii;             // só com log
+    const char *gantt_csv_path;  // NULL = sem CSV
+
+    SimContext *arena;           // NULL = malloc
+
+    SimBranchFn on_branch;       // NULL = sem ramificação
+    void *branch_arg;
+    int branch_time;
+
+    // Checkpoints do estado completo do motor (ver checkpoint.h): a cada
+    // checkpoint_every unidades de tempo simulado e/ou checkpoint_every_ms
+    // de tempo real. resume_path retoma um checkpoint da mesma simulação.
+    const char *checkpoint_path; // NULL = sem checkpoints
+    int checkpoint_every;        // 0 = sem disparo por tempo simulado
+    int checkpoint_every_ms;     // 0 = sem disparo por tempo real
+    const char *resume_path;     // NULL = desde o início
+} SimConfig;
+
+typedef struct {
+    long long requests;
+    double utilization;          // %
+    double avg_queue_delay;
+    int max_queue_delay;
+    int max_queue_length;
+} SimIoDeviceResult;
+
+// Média e percentis de uma latência. Os percentis vêm de um histograma
+// logarítmico (valores < 8 exatos, depois 8 baldes por oitava: erro relativo
+// até ~6%).
+typedef struct {
+    double avg;
+    double p50;
+    double p95;
+    double p99;
+} SimLatency;
+
+// Métricas de uma classe (prioridade ou fila do mlq). Nas tarefas periódicas
+// cada job conta como uma conclusão, com a latência medida desde a sua
+// libertação.
+typedef struct {
+    long long completed;
+    SimLatency waiting;
+    SimLatency turnaround;
+    SimLatency response;         // primeiro início - chegada
+    long long deadline_misses;
+    double cpu_share;            // % do CPU entregue a todas as classes
+    int max_ready_wait;          // fome: maior espera de um burst em READY
+    double jain_index;           // equidade de Jain dentro da classe
+} SimClassResult;
+
+typedef struct {
+    int status;                  // SimStatus
+
+    int process_count;
+    int final_time;
+    int idle_time;
+    int context_switches;
+    int context_switch_cost;
+
+    int completed;
+    double avg_waiting_time;
+    double avg_turnaround_time;
+    // P99 da espera de todos os processos que chegaram; os que não terminaram
+    // contam com a espera acumulada até ao fim (0 nas tarefas periódicas).
+    double p99_waiting_time;
+    double cpu_utilization;      // %
+    double throughput;           // processos por unidade de tempo
+    int deadline_misses;
+
+    long long bursts_total;
+    long long bursts_done;
+    double avg_burst_wait;
+    double avg_burst_turnaround;
+    int max_burst_wait;
+
+    // Tarefas periódicas (rm/edf com Period > 0).
+    long long jobs_released;
+    long long jobs_completed;
+    long long jobs_missed;
+
+    // Controlo de admissão EDF (--admission; tudo a 0 sem admissão).
+    int admission_admitted;
+    int admission_rejected;
+    int admission_deferred;          // adiamentos (cada processo conta uma vez)
+    int admission_deferred_admitted; // adiados admitidos mais tarde
+    int admission_deferred_pending;  // ainda adiados no fim
+
+    int io_device_count;
+    SimIoDeviceResult io[IODEV_MAX];
+
+    // Por classe, atualizado a cada conclusão; os processos por terminar
+    // contam no CPU, na fome e na equidade. Jain sobre x = CPU / (CPU +
+    // espera) de cada processo (ou job): 1 = todos progridem ao mesmo ritmo.
+    SimClassResult priority_class[SIM_PRIORITY_CLASSES];
+    SimClassResult queue_class[SIM_QUEUE_CLASSES];
+    int queue_classes;           // 1 se queue_class se aplica (mlq)
+    double jain_index;           // equidade de Jain entre todos os processos
+    int max_ready_wait;          // fome: maior espera de um burst em READY
+
+    long long trace_events;
+    long long series_windows;
+
+    long long checkpoints_written;
+    long long checkpoints_skipped;  // saltados por a escrita anterior não ter acabado
+    int resumed_time;               // instante do checkpoint retomado (-1 = desde o início)
+} SimResults;
+
+void sim_config_defaults(SimConfig *cfg);
+int  sim_algorithm_valid(const char *algorithm);
+// Parâmetros de execução que o algoritmo usa (SIM_PARAM_*, 0 se nenhum ou
+// desconhecido); o custo da troca de contexto conta em todos.
+int  sim_algorithm_params(const char *algorithm);
+// 0 quando o quantum não altera o escalonamento do algoritmo (só a lottery,
+// o stride e o mlq o usam; o rr corre sempre com fatia efetiva de 1 tick).
+int  sim_quantum_effective(const char *algorithm);
+const char *sim_status_name(int status);
+
+// Devolve o estado (também em results->status). Os resultados são
+// preenchidos mesmo quando a simulação termina por limite de tempo.
+int  simulate(const SimWorkload *workload, const SimConfig *config, SimResults *results);
+
+#endif
@@ -1,194 +1,97 @@
-#define _USE_MATH_DEFINES
-#include <math.h>
 #include "process.h"
-#include <time.h>
-#include <stdlib.h>
-#include <stdio.h>
-#include <string.h>
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+#include <limits.h>
 
 void initialize_process_state(Process *p) {
-    p->remaining_time = p->burst_time;
+    p->remaining_time = p->spec->burst_time;
     p->start_time = -1;
     p->finish_time = -1;
     p->waiting_time = 0;
     p->turnaround_time = 0;
     p->state = STATE_NEW;
-    p->current_priority = p->priority;
+    p->current_priority = p->spec->priority;
     p->time_in_ready_queue = 0;
     p->io_completion_time = -1;
     p->current_queue = -1;
     p->time_slice_remaining = 0;
+    p->predicted_burst = 0.0;
+    p->cpu_burst_executed = 0;
+    p->admission_rejected = 0;
+    p->result_reported = 0;
+    p->phase_next = 0;
+    p->io_pending_duration = 0;
+    p->burst_ready_time = p->spec->arrival_time;
+    p->bursts_done = 0;
+    p->burst_wait_sum = 0;
+    p->burst_turnaround_sum = 0;
+    p->burst_wait_max = 0;
 }
 
-// --- Distribuição exponencial ---
-double rand_exponential(double lambda) {
-    if (lambda <= 0) return 1.0;
-    double u;
-    do {
-        u = (double)rand() / (RAND_MAX + 1.0);
-    } while (u == 0.0 || u == 1.0);
-    return -log(u) / lambda;
+// Liga o estado de uma execução à descrição partilhada e repõe-no.
+// 'phases' é o vetor de fases da carga a que spec->phase_offset se refere.
+void process_bind(Process *p, const ProcessSpec *spec, const Phase *phases) {
+    p->spec = spec;
+    p->phases = phases + spec->phase_offset;
+    initialize_process_state(p);
 }
 
-// --- Distribuição normal (Box-Muller) ---
-double rand_normal(double mean, double stddev) {
-    if (stddev < 0) stddev = 0;
-    double u1, u2;
-    do {
-        u1 = (double)rand() / (RAND_MAX + 1.0);
-    } while (u1 == 0.0);
-    u2 = (double)rand() / (RAND_MAX + 1.0);
-    double z = sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
-    return z * stddev + mean;
+int process_burst_length(const Process *p, int phase) {
+    const Phase *ph = p->phases;
+    return ph[phase].cpu_end - (phase > 0 ? ph[phase - 1].cpu_end : 0);
 }
 
-Process* generate_static_processes(int count) {
-    if (count <= 0) return NULL;
-    Process* list = malloc(sizeof(Process) * count);
-    if (!list) {
-        fprintf(stderr, "Erro: Falha ao alocar memória em generate_static_processes\n");
-        return NULL;
-    }
-    for (int i = 0; i < count; i++) {
-        list[i].id = i + 1;
-        list[i].arrival_time = i * 2;
-        list[i].burst_time = 5 + (i % 3);
-        if (list[i].burst_time <=0) list[i].burst_time = 1;
-        list[i].priority = 1 + (i % 5);
-        list[i].deadline = list[i].arrival_time + 10 + (rand() % 5);
-        list[i].period = 0;
-        list[i].io_burst_duration = (rand() % 2 == 0) ? (2 + rand() % 4) : 0;
-        initialize_process_state(&list[i]);
-    }
-    return list;
+// I/O entre bursts (exclui o I/O terminal), que não conta como espera.
+int process_io_between(const Process *p) {
+    int total = 0;
+    for (int k = 0; k + 1 < p->spec->phase_count; k++) total += p->phases[k].io;
+    return total;
 }
 
-Process* generate_random_processes(int count, double lambda_arrival, double p1, double p2, int burst_dist_type, int prio_type,
-                                   double io_chance, int min_io_duration, int max_io_duration) {
-    if (count <= 0) return NULL;
-    Process* list = malloc(sizeof(Process) * count);
-     if (!list) {
-        fprintf(stderr, "Erro: Falha ao alocar memória em generate_random_processes\n");
-        return NULL;
-    }
-    double current_time = 0.0;
-
-    for (int i = 0; i < count; i++) {
-        list[i].id = i + 1;
-
-        current_time += rand_exponential(lambda_arrival);
-        list[i].arrival_time = (int)round(current_time);
-        if (list[i].arrival_time < 0) list[i].arrival_time = 0;
-
-        double burst_val;
-        if (burst_dist_type == 1) {
-            double lambda_burst = p1;
-             if (lambda_burst <= 0) lambda_burst = 0.1;
-            burst_val = rand_exponential(lambda_burst);
-        } else {
-            double mean = p1;
-            double stddev = p2;
-            burst_val = rand_normal(mean, stddev);
-        }
-        list[i].burst_time = (int)round(burst_val);
-        if (list[i].burst_time <= 0) list[i].burst_time = 1;
-
-        if (prio_type == 1) {
-             list[i].priority = 1 + rand() % 5;
-        } else {
-            int dice = rand() % 100;
-            if (dice < 40) list[i].priority = 1;
-            else if (dice < 70) list[i].priority = 2;
-            else if (dice < 90) list[i].priority = 3;
-            else if (dice < 97) list[i].priority = 4;
-            else list[i].priority = 5;
-        }
-
-        double avg_burst = (burst_dist_type == 1 && p1 > 0) ? (1.0 / p1) : ((burst_dist_type == 0) ? p1 : 5.0);
-        int slack = (int)round(avg_burst * 1.5) + (rand() % ((int)avg_burst + 1));
-        list[i].deadline = list[i].arrival_time + list[i].burst_time + slack;
-         if (list[i].deadline <= list[i].arrival_time) {
-             list[i].deadline = list[i].arrival_time + list[i].burst_time + 1;
-         }
-
-        list[i].period = 0;
-
-        list[i].io_burst_duration = 0;
-        if (((double)rand() / RAND_MAX) < io_chance) {
-            if (max_io_duration > min_io_duration) {
-                 list[i].io_burst_duration = min_io_duration + rand() % (max_io_duration - min_io_duration + 1);
-            } else if (max_io_duration >= 0) {
-                list[i].io_burst_duration = min_io_duration;
-            }
-             if (list[i].io_burst_duration <= 0) list[i].io_burst_duration = 1;
-        }
-
-        initialize_process_state(&list[i]);
+// Espera acumulada até 'now' de um processo que chegou mas não terminou: a
+// dos bursts já concluídos mais, se estiver pronto ou a executar, o tempo
+// desde que o burst corrente ficou pronto menos a CPU que já recebeu nele.
+int process_waiting_so_far(const Process *p, int now) {
+    long long wait = p->burst_wait_sum;
+    if (p->state == STATE_READY || p->state == STATE_RUNNING) {
+        int burst_start = p->phase_next > 0 ? p->phases[p->phase_next - 1].cpu_end : 0;
+        int executed = p->spec->burst_time - p->remaining_time - burst_start;
+        int current = now - p->burst_ready_time - executed;
+        if (current > 0) wait += current;
     }
-    return list;
+    return wait < INT_MAX ? (int)wait : INT_MAX;
 }
 
+// Ticks de CPU até ao fim do burst corrente, se este for seguido de I/O
+// (INT_MAX no último burst, cujo I/O é terminal).
+int process_ticks_to_io(const Process *p) {
+    if (p->phase_next >= p->spec->phase_count - 1) return INT_MAX;
+    int executed = p->spec->burst_time - p->remaining_time;
+    return p->phases[p->phase_next].cpu_end - executed;
+}
 
-Process* read_processes_from_file(const char* filename, int* count_ptr) {
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        perror("Erro ao abrir ficheiro de processos");
-        *count_ptr = 0;
-        return NULL;
-    }
-    int count = 0;
-    char buffer[256];
-    while (fgets(buffer, sizeof(buffer), file)) {
-        if (buffer[0] == '\n' || buffer[0] == '\r' || buffer[0] == '#' || buffer[0] == ' ') continue;
-        int id, arr, bur, pri, dead, per, io_dur=0;
-        if (sscanf(buffer, "%d %d %d %d %d %d %d", &id, &arr, &bur, &pri, &dead, &per, &io_dur) >= 6) {
-             count++;
-        } else {
-            fprintf(stderr, "Aviso: Linha mal formatada ignorada no ficheiro: %s", buffer);
-        }
-    }
-
-    if (count == 0) {
-        fprintf(stderr, "Erro: Nenhum processo válido encontrado no ficheiro '%s'.\n", filename);
-        fclose(file);
-        *count_ptr = 0;
-        return NULL;
-    }
-
-    Process* list = malloc(sizeof(Process) * count);
-    if (!list) {
-        fprintf(stderr, "Erro: Falha ao alocar memória para %d processos do ficheiro.\n", count);
-        fclose(file);
-        *count_ptr = 0;
-        return NULL;
-    }
-
-    rewind(file);
-    int current_process_index = 0;
-    while (fgets(buffer, sizeof(buffer), file) && current_process_index < count) {
-         if (buffer[0] == '\n' || buffer[0] == '\r' || buffer[0] == '#' || buffer[0] == ' ') continue;
-        int id, arr, bur, pri, dead, per, io_dur = 0;
-        int fields_read = sscanf(buffer, "%d %d %d %d %d %d %d", &id, &arr, &bur, &pri, &dead, &per, &io_dur);
+// Espera de um burst = tempo desde que ficou pronto até terminar, menos o
+// próprio burst (não há I/O dentro de um burst).
+static void record_burst(Process *p, int current_time) {
+    int turnaround = current_time - p->burst_ready_time;
+    int wait = turnaround - process_burst_length(p, p->phase_next);
+    if (wait < 0) wait = 0;
+    p->bursts_done++;
+    p->burst_turnaround_sum += turnaround;
+    p->burst_wait_sum += wait;
+    if (wait > p->burst_wait_max) p->burst_wait_max = wait;
+}
 
-        if (fields_read >= 6) {
-            list[current_process_index].id = id;
-            list[current_process_index].arrival_time = arr;
-            list[current_process_index].burst_time = (bur > 0) ? bur : 1;
-            list[current_process_index].priority = pri;
-            list[current_process_index].deadline = dead;
-            list[current_process_index].period = per;
-            list[current_process_index].io_burst_duration = (fields_read == 7 && io_dur > 0) ? io_dur : 0;
+// Se o processo acabou de terminar um burst seguido de I/O, regista-o,
+// avança para a fase seguinte e deixa a duração do I/O em io_pending_duration.
+int process_io_due(Process *p, int current_time) {
+    if (p->remaining_time <= 0 || process_ticks_to_io(p) != 0) return 0;
+    record_burst(p, current_time);
+    p->io_pending_duration = p->phases[p->phase_next].io;
+    p->phase_next++;
+    return 1;
+}
 
-            initialize_process_state(&list[current_process_index]);
-            current_process_index++;
-        }
-    }
-    fclose(file);
-    *count_ptr = count;
-    printf("Lidos %d processos do ficheiro '%s'.\n", count, filename);
-    return list;
+// Último burst concluído (remaining_time == 0).
+void process_burst_done(Process *p, int current_time) {
+    if (p->spec->phase_count == 0 || p->bursts_done >= p->spec->phase_count) return;
+    record_burst(p, current_time);
 }
\ No newline at end of file
@@ -3,24 +3,42 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include "simctx.h"
 
 typedef enum {
     STATE_NEW,
     STATE_READY,
     STATE_RUNNING,
     STATE_BLOCKED,
-    STATE_TERMINATED
+    STATE_TERMINATED,
+    STATE_DEFERRED      // à espera de admissão (EDF com --admission defer)
 } ProcessState;
 
 
+// Descrição imutável de um processo na carga. É partilhada, só para leitura,
+// por todas as execuções (algoritmos, replicações) sobre a mesma carga.
 typedef struct {
     int id;
     int arrival_time;
     int burst_time;
-    int remaining_time;
     int priority;
     int deadline;
     int period;
+    int tickets;
+    int io_burst_duration;
+
+    // Sequência de fases CPU/I/O da carga: phases[phase_offset ..] do
+    // vetor de fases da carga (g_phase_arena nas cargas geradas pelo CLI).
+    int phase_offset;
+    int phase_count;
+} ProcessSpec;
+
+// Estado de um processo numa execução: só os campos que o motor altera,
+// mais a referência para a descrição partilhada.
+typedef struct {
+    const ProcessSpec *spec;
+    const struct Phase *phases;   // fases deste processo (já deslocadas)
+    int remaining_time;
 
     int start_time;
     int finish_time;
@@ -30,19 +48,41 @@ typedef struct {
     ProcessState state;
     int current_priority;
     int time_in_ready_queue;
-    int io_burst_duration;
     int io_completion_time;
     int current_queue;
     int time_slice_remaining;
+    double predicted_burst;
+    int cpu_burst_executed;
+    int admission_rejected;
+    int result_reported;         // linha de resultado já entregue
 
-} Process;
+    // Estado dinâmico das fases e métricas por burst.
+    int phase_next;
+    int io_pending_duration;
+    int burst_ready_time;
+    int bursts_done;
+    long long burst_wait_sum;
+    long long burst_turnaround_sum;
+    int burst_wait_max;
 
-Process* generate_static_processes(int count);
+} Process;
 
-Process* generate_random_processes(int count, double lambda_arrival, double p1, double p2, int burst_dist_type, int prio_type,
-                                   double io_chance, int min_io_duration, int max_io_duration);
+// Fase k de um processo: burst de CPU que termina quando o CPU executado
+// acumulado atinge cpu_end, seguido de 'io' unidades de I/O. O I/O da última
+// fase é o I/O terminal (io_burst_duration). Todas as fases de todos os
+// processos vivem num único vetor contíguo, indexado por phase_offset.
+typedef struct Phase {
+    int cpu_end;
+    int io;
+} Phase;
 
-Process* read_processes_from_file(const char* filename, int* count_ptr);
+void process_bind(Process *p, const ProcessSpec *spec, const Phase *phases);
 void initialize_process_state(Process *p);
+int  process_ticks_to_io(const Process *p);
+int  process_io_due(Process *p, int current_time);
+void process_burst_done(Process *p, int current_time);
+int  process_burst_length(const Process *p, int phase);
+int  process_io_between(const Process *p);
+int  process_waiting_so_far(const Process *p, int now);
 
 #endif
\ No newline at end of file
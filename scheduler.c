@@ -1,20 +1,31 @@
 #include "scheduler.h"
+#include "checkpoint.h"
+#include "active.h"
+#include "series.h"
+#include "classes.h"
+#include "stats.h"
+#include "timeline.h"
+#include "heap.h"
+#include "fenwick.h"
+#include "admission.h"
+#include "iodev.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
 #include <string.h>
+#include <math.h>
 
 int compare_arrival(const void *a, const void *b) {
     Process *p1 = (Process *)a;
     Process *p2 = (Process *)b;
-    return p1->arrival_time - p2->arrival_time;
+    return p1->spec->arrival_time - p2->spec->arrival_time;
 }
 
 int compare_priority(const void *a, const void *b) {
     Process *p1 = (Process *)a;
     Process *p2 = (Process *)b;
     if (p1->current_priority == p2->current_priority) {
-        return p1->arrival_time - p2->arrival_time;
+        return p1->spec->arrival_time - p2->spec->arrival_time;
     }
     return p1->current_priority - p2->current_priority;
 }
@@ -22,18 +33,18 @@ int compare_priority(const void *a, const void *b) {
 int compare_deadline(const void *a, const void *b) {
     Process *p1 = (Process *)a;
     Process *p2 = (Process *)b;
-    if (p1->deadline == p2->deadline) {
-        return p1->arrival_time - p2->arrival_time;
+    if (p1->spec->deadline == p2->spec->deadline) {
+        return p1->spec->arrival_time - p2->spec->arrival_time;
     }
-    return p1->deadline - p2->deadline;
+    return p1->spec->deadline - p2->spec->deadline;
 }
 
 int find_min_arrival_time(Process *list, int count) {
     int min_arrival = INT_MAX;
     int found = 0;
     for (int i = 0; i < count; i++) {
-        if (list[i].state == STATE_NEW && list[i].arrival_time >= 0 && list[i].arrival_time < min_arrival) {
-            min_arrival = list[i].arrival_time;
+        if (list[i].state == STATE_NEW && list[i].spec->arrival_time >= 0 && list[i].spec->arrival_time < min_arrival) {
+            min_arrival = list[i].spec->arrival_time;
             found = 1;
         }
     }
@@ -45,12 +56,12 @@ int find_highest_priority_process_ready(Process *processes, int count, int curre
     int best_idx = -1;
     int min_priority = INT_MAX;
     for (int i = 0; i < count; i++) {
-        if (processes[i].state == STATE_READY && processes[i].arrival_time <= current_time) {
+        if (processes[i].state == STATE_READY && processes[i].spec->arrival_time <= current_time) {
              if (processes[i].current_priority < min_priority) {
                 min_priority = processes[i].current_priority;
                 best_idx = i;
             } else if (processes[i].current_priority == min_priority) {
-                if (best_idx == -1 || processes[i].arrival_time < processes[best_idx].arrival_time) {
+                if (best_idx == -1 || processes[i].spec->arrival_time < processes[best_idx].spec->arrival_time) {
                     best_idx = i;
                 }
             }
@@ -63,12 +74,12 @@ int find_earliest_deadline_process_ready(Process *processes, int count, int curr
     int best_idx = -1;
     int min_deadline = INT_MAX;
     for (int i = 0; i < count; i++) {
-         if (processes[i].state == STATE_READY && processes[i].arrival_time <= current_time) {
-            if (processes[i].deadline < min_deadline) {
-                min_deadline = processes[i].deadline;
+         if (processes[i].state == STATE_READY && processes[i].spec->arrival_time <= current_time) {
+            if (processes[i].spec->deadline < min_deadline) {
+                min_deadline = processes[i].spec->deadline;
                 best_idx = i;
-            } else if (processes[i].deadline == min_deadline) {
-                 if (best_idx == -1 || processes[i].arrival_time < processes[best_idx].arrival_time) {
+            } else if (processes[i].spec->deadline == min_deadline) {
+                 if (best_idx == -1 || processes[i].spec->arrival_time < processes[best_idx].spec->arrival_time) {
                     best_idx = i;
                 }
             }
@@ -81,12 +92,12 @@ int find_shortest_job_process_ready(Process *processes, int count, int current_t
     int best_idx = -1;
     int min_burst = INT_MAX;
     for (int i = 0; i < count; i++) {
-        if (processes[i].state == STATE_READY && processes[i].arrival_time <= current_time) {
-            if (processes[i].burst_time < min_burst) {
-                min_burst = processes[i].burst_time;
+        if (processes[i].state == STATE_READY && processes[i].spec->arrival_time <= current_time) {
+            if (processes[i].spec->burst_time < min_burst) {
+                min_burst = processes[i].spec->burst_time;
                 best_idx = i;
-            } else if (processes[i].burst_time == min_burst) {
-                 if (best_idx == -1 || processes[i].arrival_time < processes[best_idx].arrival_time) {
+            } else if (processes[i].spec->burst_time == min_burst) {
+                 if (best_idx == -1 || processes[i].spec->arrival_time < processes[best_idx].spec->arrival_time) {
                     best_idx = i;
                 }
             }
@@ -95,13 +106,14 @@ int find_shortest_job_process_ready(Process *processes, int count, int current_t
     return best_idx;
 }
 
-void apply_aging(Process *list, int count, int current_time) {
-    for (int i = 0; i < count; i++) {
+void apply_aging(SimRun *run, Process *list, const ActiveSet *active, int current_time) {
+    for (int k = 0; k < active->size; k++) {
+        int i = active->idx[k];
         if (list[i].state == STATE_READY && list[i].current_priority > 1) {
             list[i].time_in_ready_queue++;
-            if (list[i].time_in_ready_queue >= AGING_THRESHOLD) {
-                 printf("        Aging: P%d (Prio %d -> %d) at time %d\n",
-                        list[i].id, list[i].current_priority, list[i].current_priority - 1, current_time);
+            if (list[i].time_in_ready_queue >= run->aging_threshold) {
+                 sim_log(run, "        Aging: P%d (Prio %d -> %d) at time %d\n",
+                        list[i].spec->id, list[i].current_priority, list[i].current_priority - 1, current_time);
                 list[i].current_priority--;
                 list[i].time_in_ready_queue = 0;
             }
@@ -111,78 +123,224 @@ void apply_aging(Process *list, int count, int current_time) {
     }
 }
 
-int check_io_completions(Process *list, int count, int current_time) {
+// Turnaround e espera de um processo completo. A espera exclui o próprio
+// burst e o I/O entre bursts.
+static void process_final_times(Process *p) {
+    p->turnaround_time = p->finish_time - p->spec->arrival_time;
+    p->waiting_time = p->turnaround_time - p->spec->burst_time - process_io_between(p);
+    if (p->waiting_time < 0) p->waiting_time = 0;
+}
+
+// Entrega a linha de resultado do processo ao destino configurado (uma vez).
+static void report_process(SimRun *run, Process *p) {
+    if (!run->config->on_process || p->result_reported) return;
+
+    SimProcessResult row;
+    const ProcessSpec *spec = p->spec;
+    row.id = spec->id;
+    row.arrival_time = spec->arrival_time;
+    row.burst_time = spec->burst_time;
+    row.priority = spec->priority;
+    row.deadline = spec->deadline;
+    row.io_burst_duration = spec->io_burst_duration;
+    row.start_time = p->start_time;
+    row.finish_time = p->finish_time;
+    row.completed = p->finish_time != -1;
+    row.rejected = p->admission_rejected;
+    if (row.completed) {
+        process_final_times(p);
+        row.turnaround_time = p->turnaround_time;
+        row.waiting_time = p->waiting_time;
+        row.deadline_met = !(spec->deadline > 0 && p->finish_time > spec->deadline);
+    } else {
+        row.turnaround_time = -1;
+        row.waiting_time = -1;
+        row.deadline_met = -1;
+    }
+    row.bursts_done = p->bursts_done;
+    row.bursts_total = spec->phase_count;
+    row.remaining_time = p->remaining_time;
+    row.state = p->state;
+    p->result_reported = 1;
+    run->config->on_process(run->config->process_arg, &row);
+}
+
+// Amostra do processo para as métricas por classe: completo, ou ainda por
+// terminar em 'now' (no fim da simulação).
+static void class_process(SimRun *run, Process *p, int now) {
+    ClassSample s;
+    s.priority = p->spec->priority;
+    s.queue = p->current_queue;
+    if (p->finish_time != -1) {
+        process_final_times(p);
+        s.cpu = p->spec->burst_time;
+        s.waiting = p->waiting_time;
+        s.turnaround = p->turnaround_time;
+        s.response = (p->start_time >= 0) ? p->start_time - p->spec->arrival_time : -1;
+        s.max_ready = p->burst_wait_max;
+        s.missed = p->spec->deadline > 0 && p->finish_time > p->spec->deadline;
+    } else {
+        s.cpu = p->spec->burst_time - p->remaining_time;
+        s.waiting = process_waiting_so_far(p, now);
+        s.turnaround = s.response = -1;
+        long long current = s.waiting - p->burst_wait_sum;
+        s.max_ready = (current > p->burst_wait_max) ? (int)current : p->burst_wait_max;
+        s.missed = 0;
+    }
+    class_record(run->classes, &s);
+}
+
+// Saída do sistema (conclusão ou rejeição na admissão): regista-a na série
+// temporal e nas classes e entrega a linha de resultado.
+static void process_exit(SimRun *run, Process *p, int current_time) {
+    series_exit(run->series, current_time, !p->admission_rejected);
+    if (!p->admission_rejected) class_process(run, p, current_time);
+    report_process(run, p);
+}
+
+// Chamado a cada fim de burst: só entrega se o processo terminou de vez (um
+// processo à espera do I/O terminal é entregue quando este terminar).
+static void report_if_terminated(SimRun *run, Process *p) {
+    if (p->state == STATE_TERMINATED) process_exit(run, p, p->finish_time);
+}
+
+int check_io_completions(SimRun *run, Process *list, const ActiveSet *active, int current_time) {
     int moved_count = 0;
-    for (int i = 0; i < count; i++) {
+    STAT_INC(io_checks);
+    STAT_PHASE_BEGIN(PHASE_IO_CHECKS);
+    iodev_advance(&run->io, current_time, NULL);
+    for (int k = 0; k < active->size; k++) {
+        int i = active->idx[k];
         if (list[i].state == STATE_BLOCKED && current_time >= list[i].io_completion_time) {
-            printf("        I/O Complete: P%d at time %d\n", list[i].id, current_time);
+            sim_log(run, "        I/O Complete: P%d at time %d\n", list[i].spec->id, current_time);
+            series_io_end(run->series, current_time);
 
             if (list[i].remaining_time <= 0) {
-                printf("        P%d TERMINOU após I/O\n", list[i].id);
+                sim_log(run, "        P%d TERMINOU após I/O\n", list[i].spec->id);
                 list[i].state = STATE_TERMINATED;
                 list[i].finish_time = current_time;
+                process_exit(run, &list[i], current_time);
             } else {
                 list[i].state = STATE_READY;
                 list[i].time_in_ready_queue = 0;
+                list[i].burst_ready_time = current_time;
             }
 
             list[i].io_completion_time = -1;
             moved_count++;
         }
     }
+    STAT_ADD(io_fired, moved_count);
+    STAT_PHASE_END(PHASE_IO_CHECKS);
     return moved_count;
 }
 
-int check_new_arrivals(Process *list, int count, int current_time) {
+int check_new_arrivals(SimRun *run, Process *list, const ActiveSet *active, int current_time) {
      int arrived_count = 0;
-    for (int i = 0; i < count; i++) {
-        if (list[i].state == STATE_NEW && list[i].arrival_time <= current_time) {
-             printf("        Arrival: P%d at time %d\n", list[i].id, current_time);
+    STAT_INC(arrival_checks);
+    STAT_PHASE_BEGIN(PHASE_ARRIVAL_CHECKS);
+    for (int k = 0; k < active->size; k++) {
+        int i = active->idx[k];
+        if (list[i].state == STATE_NEW && list[i].spec->arrival_time <= current_time) {
+             sim_log(run, "        Arrival: P%d at time %d\n", list[i].spec->id, current_time);
+             trace_arrival(run->trace, list[i].spec->id, current_time);
+             series_arrival(run->series, current_time);
             list[i].state = STATE_READY;
             list[i].time_in_ready_queue = 0;
              if (list[i].current_queue == -1) {
-                 if (list[i].priority <= 2) list[i].current_queue = 0;
-                 else if (list[i].priority <= 4) list[i].current_queue = 1;
+                 if (list[i].spec->priority <= 2) list[i].current_queue = 0;
+                 else if (list[i].spec->priority <= 4) list[i].current_queue = 1;
                  else list[i].current_queue = 2;
              }
             arrived_count++;
         }
     }
+    STAT_ADD(arrivals_fired, arrived_count);
+    STAT_PHASE_END(PHASE_ARRIVAL_CHECKS);
     return arrived_count;
 }
 
-void calculate_final_metrics(Process *list, int count, int final_time, int total_idle_time, int total_context_switches) {
+static int compare_int(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// P99 (ordem mais próxima) da espera dos processos que chegaram e não foram
+// rejeitados; os que não terminaram entram com a espera acumulada.
+static double waiting_p99(SimRun *run, const Process *list, int count, int final_time) {
+    int *waits = simctx_alloc(run->arena, sizeof(int) * count);
+    if (!waits) return 0.0;
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        const Process *p = &list[i];
+        if (p->admission_rejected || p->state == STATE_NEW) continue;
+        waits[n++] = (p->finish_time != -1) ? p->waiting_time : process_waiting_so_far(p, final_time);
+    }
+    double p99 = 0.0;
+    if (n > 0) {
+        qsort(waits, n, sizeof(int), compare_int);
+        p99 = waits[(99 * n + 99) / 100 - 1];
+    }
+    simctx_free(run->arena, waits);
+    return p99;
+}
+
+void calculate_final_metrics(SimRun *run, Process *list, int count, int final_time, int total_idle_time, int total_context_switches) {
     long long total_waiting = 0;
     long long total_turnaround = 0;
     int completed_count = 0;
     int deadline_misses = 0;
+    long long bursts_total = 0, bursts_done = 0;
+    long long burst_wait_total = 0, burst_turnaround_total = 0;
+    int burst_wait_max = 0;
 
-    printf("\n--- Resultados Finais ---\n");
-    printf("ID | Chegada | Burst | Prio | Dead | IO Dur | Start | Finish | Turnar | Wait | D.Met?| Estado Final (R:Tempo Restante)\n");
-    printf("----------------------------------------------------------------------------------------------------------------------\n");
+    STAT_PHASE_BEGIN(PHASE_METRICS);
+    sim_log(run, "\n--- Resultados Finais ---\n");
+    sim_log(run, "ID | Chegada | Burst | Prio | Dead | IO Dur | Start | Finish | Turnar | Wait | D.Met?| Bursts | Estado Final (R:Tempo Restante)\n");
+    sim_log(run, "-------------------------------------------------------------------------------------------------------------------------------\n");
 
     for (int i = 0; i < count; i++) {
         const char* status_str;
         int missed = 0;
-        char start_str[6], finish_str[7], wait_str[5], turn_str[7];
-
+        char start_str[6], finish_str[7], wait_str[5], turn_str[7], bursts_str[12];
+
+        bursts_total += list[i].spec->phase_count;
+        bursts_done += list[i].bursts_done;
+        burst_wait_total += list[i].burst_wait_sum;
+        burst_turnaround_total += list[i].burst_turnaround_sum;
+        if (list[i].burst_wait_max > burst_wait_max) burst_wait_max = list[i].burst_wait_max;
+        snprintf(bursts_str, sizeof(bursts_str), "%d/%d", list[i].bursts_done, list[i].spec->phase_count);
+
+        // Os motores que param na última conclusão de CPU deixam por processar
+        // o I/O terminal que acaba no instante final: na série o processo sai aí.
+        if (list[i].state == STATE_BLOCKED && list[i].remaining_time <= 0 && list[i].finish_time != -1 &&
+            list[i].io_completion_time <= final_time) {
+            series_io_end(run->series, list[i].io_completion_time);
+            series_exit(run->series, list[i].io_completion_time, 1);
+        }
+        // Quem não saiu pelo process_exit (I/O terminal por acabar ou por
+        // terminar) entra nas classes aqui.
+        if (!list[i].admission_rejected && list[i].state != STATE_NEW && list[i].state != STATE_TERMINATED) {
+            class_process(run, &list[i], final_time);
+        }
         if (list[i].state == STATE_TERMINATED || list[i].finish_time != -1) {
-            status_str = "Completo";
+            status_str = list[i].admission_rejected ? "Rejeitado" : "Completo";
             if (list[i].finish_time != -1) {
                 completed_count++;
-                list[i].turnaround_time = list[i].finish_time - list[i].arrival_time;
-                list[i].waiting_time = list[i].turnaround_time - list[i].burst_time;
-                if (list[i].waiting_time < 0) list[i].waiting_time = 0;
+                process_final_times(&list[i]);
 
                 total_turnaround += list[i].turnaround_time;
                 total_waiting += list[i].waiting_time;
 
-                if (list[i].deadline > 0 && list[i].finish_time > list[i].deadline) {
+                if (list[i].spec->deadline > 0 && list[i].finish_time > list[i].spec->deadline) {
                     deadline_misses++;
                     missed = 1;
                 }
                 snprintf(wait_str, 5, "%d", list[i].waiting_time);
                 snprintf(turn_str, 7, "%d", list[i].turnaround_time);
+            } else if (list[i].admission_rejected) {
+                 strcpy(wait_str, "----");
+                 strcpy(turn_str, "------");
             } else {
                  strcpy(wait_str, "ERR");
                  strcpy(turn_str, "ERR");
@@ -195,6 +353,7 @@ void calculate_final_metrics(Process *list, int count, int final_time, int total
              if (list[i].state == STATE_RUNNING) status_str = "Executando";
              else if (list[i].state == STATE_READY) status_str = "Pronto";
              else if (list[i].state == STATE_BLOCKED) status_str = "Bloqueado";
+             else if (list[i].state == STATE_DEFERRED) status_str = "Adiado";
              else if (list[i].state == STATE_NEW) status_str = "Pendente";
              else status_str = "Desconhecido";
 
@@ -204,14 +363,15 @@ void calculate_final_metrics(Process *list, int count, int final_time, int total
              strcpy(turn_str, "------");
         }
 
-        printf("P%-2d| %-7d | %-5d | %-4d | %-4d | %-6d | %-5s | %-6s | %-6s | %-4s | %-5s | %s (R:%d)\n",
-               list[i].id, list[i].arrival_time, list[i].burst_time, list[i].priority, list[i].deadline,
-               list[i].io_burst_duration,
+        sim_log(run, "P%-2d| %-7d | %-5d | %-4d | %-4d | %-6d | %-5s | %-6s | %-6s | %-4s | %-5s | %-6s | %s (R:%d)\n",
+               list[i].spec->id, list[i].spec->arrival_time, list[i].spec->burst_time, list[i].spec->priority, list[i].spec->deadline,
+               list[i].spec->io_burst_duration,
                start_str, finish_str, turn_str, wait_str,
                (list[i].finish_time != -1) ? (missed ? "NAO" : "Sim") : "-----",
-               status_str, list[i].remaining_time);
+               bursts_str, status_str, list[i].remaining_time);
+        report_process(run, &list[i]);
     }
-    printf("----------------------------------------------------------------------------------------------------------------------\n");
+    sim_log(run, "-------------------------------------------------------------------------------------------------------------------------------\n");
 
     float avg_waiting = (completed_count > 0) ? (float)total_waiting / completed_count : 0;
     float avg_turnaround = (completed_count > 0) ? (float)total_turnaround / completed_count : 0;
@@ -221,38 +381,64 @@ void calculate_final_metrics(Process *list, int count, int final_time, int total
     if (cpu_utilization < 0.0f) cpu_utilization = 0.0f;
     float throughput = (final_time > 0) ? (float)completed_count / final_time : 0;
 
-    printf("\n--- Métricas Globais ---\n");
-    printf("Tempo Final da Simulação:      %d\n", final_time);
-    printf("Tempo Ocioso da CPU:           %d\n", total_idle_time);
-    printf("Tempo Ocupado da CPU (estim.):  %.0f\n", cpu_busy_time);
-    printf("Número de Trocas de Contexto:  %d\n", total_context_switches);
-    printf("Custo Total Trocas Contexto:   %d\n", total_context_switches * CONTEXT_SWITCH_COST);
-    printf("--------------------------------------------------\n");
-    printf("Processos Completos (CPU burst): %d de %d\n", completed_count, count);
-    printf("Média Tempo Espera (completos):    %.2f\n", avg_waiting);
-    printf("Média Tempo Turnaround (completos):%.2f\n", avg_turnaround);
-    printf("Utilização da CPU:             %.2f %%\n", cpu_utilization);
-    printf("Throughput (completos/tempo):  %.4f processos/unidade de tempo\n", throughput);
-    printf("Deadlines Perdidos (completos):%d\n", deadline_misses);
-    printf("--------------------------------------------------\n");
+    sim_log(run, "\n--- Métricas Globais ---\n");
+    sim_log(run, "Tempo Final da Simulação:      %d\n", final_time);
+    sim_log(run, "Tempo Ocioso da CPU:           %d\n", total_idle_time);
+    sim_log(run, "Tempo Ocupado da CPU (estim.):  %.0f\n", cpu_busy_time);
+    sim_log(run, "Número de Trocas de Contexto:  %d\n", total_context_switches);
+    sim_log(run, "Custo Total Trocas Contexto:   %d\n", total_context_switches * run->switch_cost);
+    sim_log(run, "--------------------------------------------------\n");
+    sim_log(run, "Processos Completos (CPU burst): %d de %d\n", completed_count, count);
+    sim_log(run, "Média Tempo Espera (completos):    %.2f\n", avg_waiting);
+    sim_log(run, "Média Tempo Turnaround (completos):%.2f\n", avg_turnaround);
+    sim_log(run, "Utilização da CPU:             %.2f %%\n", cpu_utilization);
+    sim_log(run, "Throughput (completos/tempo):  %.4f processos/unidade de tempo\n", throughput);
+    sim_log(run, "Deadlines Perdidos (completos):%d\n", deadline_misses);
+    sim_log(run, "--------------------------------------------------\n");
+    sim_log(run, "Bursts de CPU Concluídos:      %lld de %lld\n", bursts_done, bursts_total);
+    sim_log(run, "Média Espera por Burst:        %.2f\n", bursts_done > 0 ? (double)burst_wait_total / bursts_done : 0.0);
+    sim_log(run, "Média Turnaround por Burst:    %.2f\n", bursts_done > 0 ? (double)burst_turnaround_total / bursts_done : 0.0);
+    sim_log(run, "Espera Máxima num Burst:       %d\n", burst_wait_max);
+    sim_log(run, "--------------------------------------------------\n");
+
+    SimResults *res = run->results;
+    res->final_time = final_time;
+    res->idle_time = total_idle_time;
+    res->context_switches = total_context_switches;
+    res->context_switch_cost = total_context_switches * run->switch_cost;
+    res->completed = completed_count;
+    res->avg_waiting_time = avg_waiting;
+    res->avg_turnaround_time = avg_turnaround;
+    res->p99_waiting_time = waiting_p99(run, list, count, final_time);
+    res->cpu_utilization = cpu_utilization;
+    res->throughput = throughput;
+    res->deadline_misses = deadline_misses;
+    res->bursts_total = bursts_total;
+    res->bursts_done = bursts_done;
+    res->avg_burst_wait = bursts_done > 0 ? (double)burst_wait_total / bursts_done : 0.0;
+    res->avg_burst_turnaround = bursts_done > 0 ? (double)burst_turnaround_total / bursts_done : 0.0;
+    res->max_burst_wait = burst_wait_max;
+    iodev_report(&run->io, final_time);
+    STAT_PHASE_END(PHASE_METRICS);
 }
 
 
 // ---------------------- FCFS (First-Come, First-Served) ----------------------
-void schedule_fcfs(Process *list, int count, int max_simulation_time) {
-    printf("\n--- FCFS (First-Come, First-Served) ---\n");
-    if (max_simulation_time != -1) printf("Tempo Máximo de Simulação: %d\n", max_simulation_time);
-    printf("Custo Troca de Contexto: %d\n", CONTEXT_SWITCH_COST);
+void schedule_fcfs(SimRun *run, const ProcessSpec *list, int count, int max_simulation_time) {
+    sim_log(run, "\n--- FCFS (First-Come, First-Served) ---\n");
+    if (max_simulation_time != -1) sim_log(run, "Tempo Máximo de Simulação: %d\n", max_simulation_time);
+    sim_log(run, "Custo Troca de Contexto: %d\n", run->switch_cost);
 
     if (count <= 0) { return; }
 
-    Process *local_list = malloc(count * sizeof(Process));
-    if (!local_list) { fprintf(stderr, "Erro malloc FCFS\n"); return; }
+    Process *local_list = simctx_alloc(run->arena, count * sizeof(Process));
+    if (!local_list) { sim_fail(run, SIM_ERR_MEMORY, "Erro malloc FCFS\n"); return; }
     for (int i = 0; i < count; i++) {
-        local_list[i] = list[i];
-        initialize_process_state(&local_list[i]);
+        process_bind(&local_list[i], &list[i], run->phases);
     }
     qsort(local_list, count, sizeof(Process), compare_arrival);
+    ActiveSet active;
+    if (!active_init(&active, run->arena, count)) { sim_fail(run, SIM_ERR_MEMORY, "Erro malloc FCFS\n"); simctx_free(run->arena, local_list); return; }
 
     int current_time = 0;
     int completed_count = 0;
@@ -264,50 +450,72 @@ void schedule_fcfs(Process *list, int count, int max_simulation_time) {
     current_time = find_min_arrival_time(local_list, count);
     if (current_time > 0) {
         total_idle_time = current_time;
+        trace_idle(run->trace, 0, current_time);
     }
 
-    printf("\nTempo | Evento\n");
-    printf("------------------------------------------\n");
+    Timeline timeline;
+    timeline_init(&timeline, run, count);
+    iodev_reset(&run->io, local_list, count);
+    sim_log(run, "\nTempo | Evento\n");
+    sim_log(run, "------------------------------------------\n");
 
+    sim_state_processes(run, local_list, count);
+    SIM_STATE(run, current_time); SIM_STATE(run, completed_count); SIM_STATE(run, total_idle_time);
+    SIM_STATE(run, total_context_switches); SIM_STATE(run, current_running_idx); SIM_STATE(run, last_process_id);
+    if (!sim_state_ready(run)) max_simulation_time = current_time;
     while (completed_count < count && (max_simulation_time == -1 || current_time < max_simulation_time)) {
+        STAT_INC(loop_iterations);
+        sim_checkpoint(run, current_time);
+        active_compact(&active, local_list, completed_count);
 
-        (void)check_new_arrivals(local_list, count, current_time);
-        (void)check_io_completions(local_list, count, current_time);
+        (void)check_new_arrivals(run, local_list, &active, current_time);
+        (void)check_io_completions(run, local_list, &active, current_time);
 
         if (current_running_idx == -1) {
              int next_ready_idx = -1;
-             for (int i = 0; i < count; i++){
+             int examined = 0;
+             STAT_PHASE_BEGIN(PHASE_PICK);
+             for (int k = 0; k < active.size; k++) {
+                 int i = active.idx[k];
+                 examined++;
                  if (local_list[i].state == STATE_READY) {
                      next_ready_idx = i;
                      break;
                  }
              }
+             STAT_INC(picks); STAT_ADD(procs_examined, examined);
+             (void)examined;
+             STAT_PHASE_END(PHASE_PICK);
 
             if (next_ready_idx != -1) {
 
                 current_running_idx = next_ready_idx;
                 Process *p = &local_list[current_running_idx];
 
-                if (CONTEXT_SWITCH_COST > 0 && last_process_id != p->id && last_process_id != -1) {
+                if (run->switch_cost > 0 && last_process_id != p->spec->id && last_process_id != -1) {
                      char from_str[10];
                      if (last_process_id == -1) strcpy(from_str, "Idle"); else snprintf(from_str, sizeof(from_str), "P%d", last_process_id);
-                     printf("%-5d | Context Switch (%s to P%d) - Custo: %d\n", current_time, from_str, p->id, CONTEXT_SWITCH_COST);
+                     sim_log(run, "%-5d | Context Switch (%s to P%d) - Custo: %d\n", current_time, from_str, p->spec->id, run->switch_cost);
 
-                     current_time += CONTEXT_SWITCH_COST;
+                     trace_context_switch(run->trace, last_process_id, p->spec->id, current_time, run->switch_cost);
+                     series_switch(run->series, current_time, run->switch_cost);
+                     current_time += run->switch_cost;
                      total_context_switches++;
 
-                     (void)check_new_arrivals(local_list, count, current_time);
-                     (void)check_io_completions(local_list, count, current_time);
+                     (void)check_new_arrivals(run, local_list, &active, current_time);
+                     (void)check_io_completions(run, local_list, &active, current_time);
                      if (max_simulation_time != -1 && current_time >= max_simulation_time) break;
                 }
 
                 p->state = STATE_RUNNING;
                 if (p->start_time == -1) p->start_time = current_time;
-                last_process_id = p->id;
+                last_process_id = p->spec->id;
 
-                printf("%-5d | P%d inicia execução (Burst Total: %d, Restante: %d)\n", current_time, p->id, p->burst_time, p->remaining_time);
+                sim_log(run, "%-5d | P%d inicia execução (Burst Total: %d, Restante: %d)\n", current_time, p->spec->id, p->spec->burst_time, p->remaining_time);
 
                  int time_to_execute = p->remaining_time;
+                 int ticks_to_io = process_ticks_to_io(p);
+                 if (ticks_to_io < time_to_execute) time_to_execute = ticks_to_io;
                  int execution_end_time = current_time + time_to_execute;
                  int time_limit_reached = 0;
 
@@ -315,7 +523,7 @@ void schedule_fcfs(Process *list, int count, int max_simulation_time) {
                      execution_end_time = max_simulation_time;
                      time_to_execute = max_simulation_time - current_time;
                      time_limit_reached = 1;
-                     printf("        Execução de P%d limitada a %d unidades pelo T Max\n", p->id, time_to_execute);
+                     sim_log(run, "        Execução de P%d limitada a %d unidades pelo T Max\n", p->spec->id, time_to_execute);
                  }
 
                  if (time_to_execute <= 0 && time_limit_reached) {
@@ -329,39 +537,50 @@ void schedule_fcfs(Process *list, int count, int max_simulation_time) {
                       current_time++;
                       exec_step++;
                       p->remaining_time--;
-                      (void)check_new_arrivals(local_list, count, current_time);
-                      (void)check_io_completions(local_list, count, current_time);
+                      timeline_run(&timeline, p->spec->id, current_time - 1, current_time);
+                      (void)check_new_arrivals(run, local_list, &active, current_time);
+                      (void)check_io_completions(run, local_list, &active, current_time);
                  }
 
                  if (p->remaining_time == 0) {
-                     printf("%-5d | P%d TERMINOU CPU Burst\n", current_time, p->id);
+                     timeline_stop(&timeline, TL_END_FINISHED);
+                     process_burst_done(p, current_time);
+                     sim_log(run, "%-5d | P%d TERMINOU CPU Burst\n", current_time, p->spec->id);
                      p->state = STATE_TERMINATED;
                      p->finish_time = current_time;
                      completed_count++;
 
-                     if (p->io_burst_duration > 0) {
-                         printf("        P%d iniciando I/O (%d unidades) apos termino do burst\n", p->id, p->io_burst_duration);
-                         p->state = STATE_BLOCKED;
-                         p->io_completion_time = current_time + p->io_burst_duration;
+                     if (p->spec->io_burst_duration > 0) {
+                         sim_log(run, "        P%d iniciando I/O (%d unidades) apos termino do burst\n", p->spec->id, p->spec->io_burst_duration);
+                         iodev_submit(&run->io, p, current_time, p->spec->io_burst_duration, NULL);
                      }
+                     report_if_terminated(run, p);
+                     current_running_idx = -1;
+                 } else if (process_io_due(p, current_time)) {
+                     timeline_stop(&timeline, TL_END_IO);
+                     sim_log(run, "%-5d | P%d iniciando I/O (%d unidades) durante execução\n", current_time, p->spec->id, p->io_pending_duration);
+                     iodev_submit(&run->io, p, current_time, p->io_pending_duration, NULL);
                      current_running_idx = -1;
                  } else if (time_limit_reached) {
-                      printf("%-5d | Simulação INTERROMPIDA (T Max) enquanto P%d executava.\n", current_time, p->id);
+                      timeline_stop(&timeline, TL_END_TIME_LIMIT);
+                      sim_log(run, "%-5d | Simulação INTERROMPIDA (T Max) enquanto P%d executava.\n", current_time, p->spec->id);
                       p->state = STATE_READY;
                       current_running_idx = -1;
                  } else {
-                       fprintf(stderr, "Erro lógico em FCFS: P%d parou inesperadamente.\n", p->id);
+                       sim_warn(run, "Erro lógico em FCFS: P%d parou inesperadamente.\n", p->spec->id);
                        p->state = STATE_TERMINATED;
                        p->finish_time = current_time;
                        completed_count++;
+                       process_exit(run, p, current_time);
                        current_running_idx = -1;
                  }
 
             } else {
                 int next_event_time = INT_MAX;
-                for (int i = 0; i < count; i++) {
-                    if (local_list[i].state == STATE_NEW && local_list[i].arrival_time < next_event_time) {
-                         next_event_time = local_list[i].arrival_time;
+                for (int k = 0; k < active.size; k++) {
+                    int i = active.idx[k];
+                    if (local_list[i].state == STATE_NEW && local_list[i].spec->arrival_time < next_event_time) {
+                         next_event_time = local_list[i].spec->arrival_time;
                     }
                     if (local_list[i].state == STATE_BLOCKED && local_list[i].io_completion_time < next_event_time) {
                          next_event_time = local_list[i].io_completion_time;
@@ -374,42 +593,49 @@ void schedule_fcfs(Process *list, int count, int max_simulation_time) {
                       if (idle_until <= current_time) {
                            break;
                       }
-                       printf("%-5d | CPU Ociosa até %d (Fim da Simulação)\n", current_time, idle_until);
+                       sim_log(run, "%-5d | CPU Ociosa até %d (Fim da Simulação)\n", current_time, idle_until);
                  } else {
                       idle_until = next_event_time;
-                      printf("%-5d | CPU Ociosa até t=%d (Próximo evento)\n", current_time, idle_until);
+                      sim_log(run, "%-5d | CPU Ociosa até t=%d (Próximo evento)\n", current_time, idle_until);
                  }
 
                  if (idle_until > current_time) {
+                    STAT_INC(idle_fastforwards); STAT_ADD(idle_time_skipped, idle_until - current_time);
+                    trace_idle(run->trace, current_time, idle_until);
                     total_idle_time += (idle_until - current_time);
                     current_time = idle_until;
                  }
             }
         } else {
-             fprintf(stderr, "Erro: Estado inesperado em FCFS (CPU ocupada sem processamento).\n");
+             sim_warn(run, "Erro: Estado inesperado em FCFS (CPU ocupada sem processamento).\n");
              current_running_idx = -1;
         }
     }
 
-    printf("------------------------------------------\n");
-    calculate_final_metrics(local_list, count, current_time, total_idle_time, total_context_switches);
-    free(local_list);
+    timeline_finish(&timeline);
+    sim_log(run, "------------------------------------------\n");
+    calculate_final_metrics(run, local_list, count, current_time, total_idle_time, total_context_switches);
+    timeline_report(&timeline, local_list, count);
+    timeline_free(&timeline);
+    active_free(&active);
+    simctx_free(run->arena, local_list);
 }
 
 
 // ---------------------- Round Robin (RR) ----------------------
-void schedule_rr(Process *list, int count, int quantum, int max_simulation_time) {
-     printf("\n--- Round Robin (q = %d) ---\n", quantum);
-     if (max_simulation_time != -1) printf("Tempo Máximo de Simulação: %d\n", max_simulation_time);
-     printf("Custo Troca de Contexto: %d\n", CONTEXT_SWITCH_COST);
+void schedule_rr(SimRun *run, const ProcessSpec *list, int count, int quantum, int max_simulation_time) {
+     sim_log(run, "\n--- Round Robin (q = %d) ---\n", quantum);
+     if (max_simulation_time != -1) sim_log(run, "Tempo Máximo de Simulação: %d\n", max_simulation_time);
+     sim_log(run, "Custo Troca de Contexto: %d\n", run->switch_cost);
      if (count <= 0 || quantum <=0) { return; }
 
-    Process *local_list = malloc(count * sizeof(Process));
-    if (!local_list) { return; }
+    Process *local_list = simctx_alloc(run->arena, count * sizeof(Process));
+    if (!local_list) { sim_fail(run, SIM_ERR_MEMORY, "Erro malloc RR\n"); return; }
     for(int i=0; i<count; i++) {
-        local_list[i] = list[i];
-        initialize_process_state(&local_list[i]);
+        process_bind(&local_list[i], &list[i], run->phases);
     }
+    ActiveSet active;
+    if (!active_init(&active, run->arena, count)) { sim_fail(run, SIM_ERR_MEMORY, "Erro malloc RR\n"); simctx_free(run->arena, local_list); return; }
 
     int current_time = 0;
     int completed_count = 0;
@@ -422,51 +648,72 @@ void schedule_rr(Process *list, int count, int quantum, int max_simulation_time)
     current_time = find_min_arrival_time(local_list, count);
     if (current_time > 0) {
         total_idle_time = current_time;
+        trace_idle(run->trace, 0, current_time);
     }
 
-    printf("\nTempo | Evento\n");
-    printf("------------------------------------------\n");
-
+    Timeline timeline;
+    timeline_init(&timeline, run, count);
+    iodev_reset(&run->io, local_list, count);
+    sim_log(run, "\nTempo | Evento\n");
+    sim_log(run, "------------------------------------------\n");
+
+    sim_state_processes(run, local_list, count);
+    SIM_STATE(run, current_time); SIM_STATE(run, completed_count); SIM_STATE(run, total_idle_time);
+    SIM_STATE(run, total_context_switches); SIM_STATE(run, current_running_idx); SIM_STATE(run, last_process_id);
+    SIM_STATE(run, last_ready_checked_idx); SIM_STATE(run, quantum);
+    if (!sim_state_ready(run)) max_simulation_time = current_time;
     while (completed_count < count && (max_simulation_time == -1 || current_time < max_simulation_time)) {
+        STAT_INC(loop_iterations);
+        if (sim_checkpoint(run, current_time)) quantum = run->quantum;
+        active_compact(&active, local_list, completed_count);
 
-        (void)check_new_arrivals(local_list, count, current_time);
-        (void)check_io_completions(local_list, count, current_time);
+        (void)check_new_arrivals(run, local_list, &active, current_time);
+        (void)check_io_completions(run, local_list, &active, current_time);
 
         if (current_running_idx == -1) {
              int next_ready_idx = -1;
-             int search_start_idx = (last_ready_checked_idx + 1);
-             for (int i = 0; i < count; ++i) {
-                 int check_idx = (search_start_idx + i) % count;
+             // Procura circular a seguir ao último escolhido, só entre os ativos.
+             int search_start_pos = active_after(&active, last_ready_checked_idx);
+             int examined = 0;
+             STAT_PHASE_BEGIN(PHASE_PICK);
+             for (int k = 0; k < active.size; ++k) {
+                 int check_idx = active.idx[(search_start_pos + k) % active.size];
+                 examined++;
                  if (local_list[check_idx].state == STATE_READY && local_list[check_idx].finish_time == -1) {
                      next_ready_idx = check_idx;
                      last_ready_checked_idx = check_idx;
                      break;
                  }
              }
+             STAT_INC(picks); STAT_ADD(procs_examined, examined);
+             STAT_PHASE_END(PHASE_PICK);
+             (void)examined;
 
             if (next_ready_idx != -1) {
                  current_running_idx = next_ready_idx;
                  Process *p = &local_list[current_running_idx];
 
-                 if (CONTEXT_SWITCH_COST > 0 && last_process_id != p->id && last_process_id != -1) {
+                 if (run->switch_cost > 0 && last_process_id != p->spec->id && last_process_id != -1) {
                      char from_str[10];
                      if (last_process_id == -1) strcpy(from_str, "Idle"); else snprintf(from_str, sizeof(from_str), "P%d", last_process_id);
-                     printf("%-5d | Context Switch (%s to P%d) - Custo: %d\n", current_time, from_str, p->id, CONTEXT_SWITCH_COST);
+                     sim_log(run, "%-5d | Context Switch (%s to P%d) - Custo: %d\n", current_time, from_str, p->spec->id, run->switch_cost);
 
-                     current_time += CONTEXT_SWITCH_COST;
+                     trace_context_switch(run->trace, last_process_id, p->spec->id, current_time, run->switch_cost);
+                     series_switch(run->series, current_time, run->switch_cost);
+                     current_time += run->switch_cost;
                      total_context_switches++;
 
-                     (void)check_new_arrivals(local_list, count, current_time);
-                     (void)check_io_completions(local_list, count, current_time);
+                     (void)check_new_arrivals(run, local_list, &active, current_time);
+                     (void)check_io_completions(run, local_list, &active, current_time);
                      if (max_simulation_time != -1 && current_time >= max_simulation_time) break;
                  }
 
                  p->state = STATE_RUNNING;
                  p->time_slice_remaining = quantum;
                  if (p->start_time == -1) p->start_time = current_time;
-                 last_process_id = p->id;
+                 last_process_id = p->spec->id;
 
-                 printf("%-5d | P%d inicia/continua execução (Quantum: %d, Restante: %d)\n", current_time, p->id, quantum, p->remaining_time);
+                 sim_log(run, "%-5d | P%d inicia/continua execução (Quantum: %d, Restante: %d)\n", current_time, p->spec->id, quantum, p->remaining_time);
             }
         }
 
@@ -482,39 +729,41 @@ void schedule_rr(Process *list, int count, int quantum, int max_simulation_time)
 
             current_time++;
             p->remaining_time--;
+            timeline_run(&timeline, p->spec->id, current_time - 1, current_time);
             p->time_slice_remaining = 0; // FALHA PROPOSITAL
             //p->time_slice_remaining--; (versao correta)
-            printf("P%d executa (R:%d, Q:%d)\n", p->id, p->remaining_time, p->time_slice_remaining);
 
 
-             (void)check_new_arrivals(local_list, count, current_time);
-             (void)check_io_completions(local_list, count, current_time);
+             (void)check_new_arrivals(run, local_list, &active, current_time);
+             (void)check_io_completions(run, local_list, &active, current_time);
 
 
             int process_stopped = 0;
             if (p->remaining_time == 0) {
-                printf("%-5d | P%d TERMINOU CPU Burst\n", current_time, p->id);
+                timeline_stop(&timeline, TL_END_FINISHED);
+                process_burst_done(p, current_time);
+                sim_log(run, "%-5d | P%d TERMINOU CPU Burst\n", current_time, p->spec->id);
                 p->state = STATE_TERMINATED;
                 p->finish_time = current_time;
                 completed_count++;
 
-                 if (p->io_burst_duration > 0) {
-                     printf("        P%d iniciando I/O (%d unidades) apos termino do burst\n", p->id, p->io_burst_duration);
-                     p->state = STATE_BLOCKED;
-                     p->io_completion_time = current_time + p->io_burst_duration;
+                 if (p->spec->io_burst_duration > 0) {
+                     sim_log(run, "        P%d iniciando I/O (%d unidades) apos termino do burst\n", p->spec->id, p->spec->io_burst_duration);
+                     iodev_submit(&run->io, p, current_time, p->spec->io_burst_duration, NULL);
                  }
+                 report_if_terminated(run, p);
                 process_stopped = 1;
 
+            } else if (process_io_due(p, current_time)) {
+                timeline_stop(&timeline, TL_END_IO);
+                sim_log(run, "%-5d | P%d iniciando I/O (%d unidades) durante execução\n", current_time, p->spec->id, p->io_pending_duration);
+                iodev_submit(&run->io, p, current_time, p->io_pending_duration, NULL);
+                process_stopped = 1;
             } else if (p->time_slice_remaining == 0) {
-                printf("%-5d | P%d fim do quantum, volta para READY\n", current_time, p->id);
-                 if (p->io_burst_duration > 0 && (rand() % 3 == 0) ) {
-                    printf("        P%d iniciando I/O (%d unidades) no fim do quantum\n", p->id, p->io_burst_duration);
-                    p->state = STATE_BLOCKED;
-                    p->io_completion_time = current_time + p->io_burst_duration;
-                } else {
-                    p->state = STATE_READY;
-                    p->time_in_ready_queue = 0;
-                }
+                timeline_stop(&timeline, TL_END_QUANTUM);
+                sim_log(run, "%-5d | P%d fim do quantum, volta para READY\n", current_time, p->spec->id);
+                p->state = STATE_READY;
+                p->time_in_ready_queue = 0;
                 process_stopped = 1;
             }
 
@@ -525,9 +774,10 @@ void schedule_rr(Process *list, int count, int quantum, int max_simulation_time)
         } else {
             int next_event_time = INT_MAX;
             int has_ready_process = 0;
-            for (int i = 0; i < count; i++) {
+            for (int k = 0; k < active.size; k++) {
+                int i = active.idx[k];
                  if(local_list[i].state == STATE_READY && local_list[i].finish_time == -1) has_ready_process = 1;
-                 if (local_list[i].state == STATE_NEW && local_list[i].arrival_time < next_event_time) next_event_time = local_list[i].arrival_time;
+                 if (local_list[i].state == STATE_NEW && local_list[i].spec->arrival_time < next_event_time) next_event_time = local_list[i].spec->arrival_time;
                  if (local_list[i].state == STATE_BLOCKED && local_list[i].io_completion_time < next_event_time) next_event_time = local_list[i].io_completion_time;
             }
 
@@ -537,13 +787,15 @@ void schedule_rr(Process *list, int count, int quantum, int max_simulation_time)
              if (next_event_time == INT_MAX || (max_simulation_time != -1 && next_event_time >= max_simulation_time)) {
                   idle_until = (max_simulation_time != -1) ? max_simulation_time : current_time;
                    if (idle_until <= current_time) { break; }
-                   printf("%-5d | CPU Ociosa até %d (Fim da Simulação)\n", current_time, idle_until);
+                   sim_log(run, "%-5d | CPU Ociosa até %d (Fim da Simulação)\n", current_time, idle_until);
              } else {
                   idle_until = next_event_time;
-                   printf("%-5d | CPU Ociosa até t=%d (Próximo evento)\n", current_time, idle_until);
+                   sim_log(run, "%-5d | CPU Ociosa até t=%d (Próximo evento)\n", current_time, idle_until);
              }
 
              if (idle_until > current_time) {
+                 STAT_INC(idle_fastforwards); STAT_ADD(idle_time_skipped, idle_until - current_time);
+                 trace_idle(run->trace, current_time, idle_until);
                  total_idle_time += (idle_until - current_time);
                  current_time = idle_until;
              }
@@ -551,29 +803,33 @@ void schedule_rr(Process *list, int count, int quantum, int max_simulation_time)
 
     }
 
-    printf("------------------------------------------\n");
-    calculate_final_metrics(local_list, count, current_time, total_idle_time, total_context_switches);
-    free(local_list);
+    timeline_finish(&timeline);
+    sim_log(run, "------------------------------------------\n");
+    calculate_final_metrics(run, local_list, count, current_time, total_idle_time, total_context_switches);
+    timeline_report(&timeline, local_list, count);
+    timeline_free(&timeline);
+    active_free(&active);
+    simctx_free(run->arena, local_list);
 }
 
 
 // ------------------ Priority Scheduling ------------------
-void schedule_priority(Process *list, int count, int preemptive, int enable_aging, int max_simulation_time) {
-    printf("\n--- Priority Scheduling (%s) ---\n", preemptive ? "Preemptive" : "Non-Preemptive");
-    if (enable_aging && preemptive) printf("    (Aging Habilitado: Threshold=%d, Interval=%d)\n", AGING_THRESHOLD, AGING_INTERVAL);
-    else if (preemptive) printf("    (Aging Desabilitado)\n");
-    else printf("    (Aging N/A para Non-Preemptive)\n");
-    if (max_simulation_time != -1) printf("Tempo Máximo de Simulação: %d\n", max_simulation_time);
-    printf("Custo Troca de Contexto: %d\n", CONTEXT_SWITCH_COST);
+void schedule_priority(SimRun *run, const ProcessSpec *list, int count, int preemptive, int enable_aging, int max_simulation_time) {
+    sim_log(run, "\n--- Priority Scheduling (%s) ---\n", preemptive ? "Preemptive" : "Non-Preemptive");
+    if (enable_aging && preemptive) sim_log(run, "    (Aging Habilitado: Threshold=%d, Interval=%d)\n", run->aging_threshold, run->aging_interval);
+    else if (preemptive) sim_log(run, "    (Aging Desabilitado)\n");
+    else sim_log(run, "    (Aging N/A para Non-Preemptive)\n");
+    if (max_simulation_time != -1) sim_log(run, "Tempo Máximo de Simulação: %d\n", max_simulation_time);
+    sim_log(run, "Custo Troca de Contexto: %d\n", run->switch_cost);
     if (count <= 0) { return; }
 
-    Process *local_list = malloc(count * sizeof(Process));
-    if (!local_list) { return; }
+    Process *local_list = simctx_alloc(run->arena, count * sizeof(Process));
+    if (!local_list) { sim_fail(run, SIM_ERR_MEMORY, "Erro malloc Prioridade\n"); return; }
     for(int i=0; i<count; i++) {
-        local_list[i] = list[i];
-        initialize_process_state(&local_list[i]);
-        local_list[i].current_priority = list[i].priority;
+        process_bind(&local_list[i], &list[i], run->phases);
     }
+    ActiveSet active;
+    if (!active_init(&active, run->arena, count)) { sim_fail(run, SIM_ERR_MEMORY, "Erro malloc Prioridade\n"); simctx_free(run->arena, local_list); return; }
 
     int current_time = 0;
     int completed_count = 0;
@@ -586,38 +842,54 @@ void schedule_priority(Process *list, int count, int preemptive, int enable_agin
     current_time = find_min_arrival_time(local_list, count);
     if (current_time > 0) {
         total_idle_time = current_time;
+        trace_idle(run->trace, 0, current_time);
     }
     last_aging_check = current_time;
 
-    printf("\nTempo | Evento\n");
-    printf("------------------------------------------\n");
-
+    Timeline timeline;
+    timeline_init(&timeline, run, count);
+    iodev_reset(&run->io, local_list, count);
+    sim_log(run, "\nTempo | Evento\n");
+    sim_log(run, "------------------------------------------\n");
+
+    sim_state_processes(run, local_list, count);
+    SIM_STATE(run, current_time); SIM_STATE(run, completed_count); SIM_STATE(run, total_idle_time);
+    SIM_STATE(run, total_context_switches); SIM_STATE(run, current_running_idx); SIM_STATE(run, last_process_id);
+    SIM_STATE(run, last_aging_check);
+    if (!sim_state_ready(run)) max_simulation_time = current_time;
     while (completed_count < count && (max_simulation_time == -1 || current_time < max_simulation_time)) {
+        STAT_INC(loop_iterations);
+        sim_checkpoint(run, current_time);
+        active_compact(&active, local_list, completed_count);
 
-        (void)check_new_arrivals(local_list, count, current_time);
-        (void)check_io_completions(local_list, count, current_time);
+        (void)check_new_arrivals(run, local_list, &active, current_time);
+        (void)check_io_completions(run, local_list, &active, current_time);
         int applied_aging = 0;
 
-        if (preemptive && enable_aging && (current_time >= last_aging_check + AGING_INTERVAL)) {
-             apply_aging(local_list, count, current_time);
+        if (preemptive && enable_aging && (current_time >= last_aging_check + run->aging_interval)) {
+             apply_aging(run, local_list, &active, current_time);
              last_aging_check = current_time;
              applied_aging = 1;
         }
 
         int highest_prio_idx = -1;
         int min_priority = INT_MAX;
-        for (int i = 0; i < count; i++) {
-            if (local_list[i].state == STATE_READY && local_list[i].finish_time == -1 && local_list[i].arrival_time <= current_time) {
+        STAT_INC(picks); STAT_ADD(procs_examined, active.size);
+        STAT_PHASE_BEGIN(PHASE_PICK);
+        for (int k = 0; k < active.size; k++) {
+            int i = active.idx[k];
+            if (local_list[i].state == STATE_READY && local_list[i].finish_time == -1 && local_list[i].spec->arrival_time <= current_time) {
                  if (local_list[i].current_priority < min_priority) {
                     min_priority = local_list[i].current_priority;
                     highest_prio_idx = i;
                 } else if (local_list[i].current_priority == min_priority) {
-                    if (highest_prio_idx == -1 || local_list[i].arrival_time < local_list[highest_prio_idx].arrival_time) {
+                    if (highest_prio_idx == -1 || local_list[i].spec->arrival_time < local_list[highest_prio_idx].spec->arrival_time) {
                         highest_prio_idx = i;
                     }
                 }
             }
         }
+        STAT_PHASE_END(PHASE_PICK);
 
 
         int preemption_occurred = 0;
@@ -628,72 +900,76 @@ void schedule_priority(Process *list, int count, int preemptive, int enable_agin
             if (current_running_idx == -1) {
                  current_running_idx = highest_prio_idx; Process *p = next_p;
 
-                 if (CONTEXT_SWITCH_COST > 0 && last_process_id != p->id && last_process_id != -1) {
+                 if (run->switch_cost > 0 && last_process_id != p->spec->id && last_process_id != -1) {
                      char from_str[10];
                      if (last_process_id == -1) strcpy(from_str, "Idle"); else snprintf(from_str, sizeof(from_str), "P%d", last_process_id);
-                     printf("%-5d | Context Switch (%s to P%d) - Custo: %d\n", current_time, from_str, p->id, CONTEXT_SWITCH_COST);
-                     current_time += CONTEXT_SWITCH_COST; total_context_switches++;
-                     (void)check_new_arrivals(local_list, count, current_time); (void)check_io_completions(local_list, count, current_time);
-                     if (preemptive && enable_aging && (current_time >= last_aging_check + AGING_INTERVAL)){ apply_aging(local_list, count, current_time); last_aging_check = current_time; }
+                     sim_log(run, "%-5d | Context Switch (%s to P%d) - Custo: %d\n", current_time, from_str, p->spec->id, run->switch_cost);
+                     trace_context_switch(run->trace, last_process_id, p->spec->id, current_time, run->switch_cost);
+                     series_switch(run->series, current_time, run->switch_cost);
+                     current_time += run->switch_cost; total_context_switches++;
+                     (void)check_new_arrivals(run, local_list, &active, current_time); (void)check_io_completions(run, local_list, &active, current_time);
+                     if (preemptive && enable_aging && (current_time >= last_aging_check + run->aging_interval)){ apply_aging(run, local_list, &active, current_time); last_aging_check = current_time; }
                      if (max_simulation_time != -1 && current_time >= max_simulation_time) break;
                  }
 
                  p->state = STATE_RUNNING; p->time_in_ready_queue = 0;
                  if (p->start_time == -1) p->start_time = current_time;
-                 last_process_id = p->id;
-                 printf("%-5d | P%d (Prio: %d) inicia execução (R: %d)\n", current_time, p->id, p->current_priority, p->remaining_time);
+                 last_process_id = p->spec->id;
+                 sim_log(run, "%-5d | P%d (Prio: %d) inicia execução (R: %d)\n", current_time, p->spec->id, p->current_priority, p->remaining_time);
 
             } else {
                  Process *running_p = &local_list[current_running_idx];
+                 if (preemptive) STAT_INC(preemption_checks);
                  if (preemptive && highest_prio_idx != current_running_idx &&
                      (next_p->current_priority < running_p->current_priority || (applied_aging && next_p->current_priority < running_p->current_priority)) )
                   {
                       preemption_occurred = 1;
-                      printf("%-5d | PREEMPÇÃO: P%d (Prio: %d) preempta P%d (Prio: %d)\n",
-                             current_time, next_p->id, next_p->current_priority, running_p->id, running_p->current_priority);
+                      STAT_INC(preemptions);
+                      sim_log(run, "%-5d | PREEMPÇÃO: P%d (Prio: %d) preempta P%d (Prio: %d)\n",
+                             current_time, next_p->spec->id, next_p->current_priority, running_p->spec->id, running_p->current_priority);
+                      timeline_stop(&timeline, TL_END_PREEMPTED);
+                      trace_preemption(run->trace, running_p->spec->id, next_p->spec->id, current_time);
 
 
-                      if (running_p->io_burst_duration > 0 && (rand() % 5 == 0) ) {
-                          printf("        P%d preemptido iniciando I/O (%d unidades)\n", running_p->id, running_p->io_burst_duration);
-                          running_p->state = STATE_BLOCKED; running_p->io_completion_time = current_time + running_p->io_burst_duration;
-                      } else {
-                          running_p->state = STATE_READY; running_p->time_in_ready_queue = 0;
-                      }
+                      running_p->state = STATE_READY; running_p->time_in_ready_queue = 0;
 
                       current_running_idx = highest_prio_idx; Process *p = next_p;
 
-                      if (CONTEXT_SWITCH_COST > 0) {
-                          printf("%-5d | Context Switch (P%d to P%d) - Custo: %d\n", current_time, running_p->id, p->id, CONTEXT_SWITCH_COST);
-                          current_time += CONTEXT_SWITCH_COST; total_context_switches++;
-                          (void)check_new_arrivals(local_list, count, current_time); (void)check_io_completions(local_list, count, current_time);
-                          if (preemptive && enable_aging && (current_time >= last_aging_check + AGING_INTERVAL)){ apply_aging(local_list, count, current_time); last_aging_check = current_time; }
+                      if (run->switch_cost > 0) {
+                          sim_log(run, "%-5d | Context Switch (P%d to P%d) - Custo: %d\n", current_time, running_p->spec->id, p->spec->id, run->switch_cost);
+                          trace_context_switch(run->trace, running_p->spec->id, p->spec->id, current_time, run->switch_cost);
+                          series_switch(run->series, current_time, run->switch_cost);
+                          current_time += run->switch_cost; total_context_switches++;
+                          (void)check_new_arrivals(run, local_list, &active, current_time); (void)check_io_completions(run, local_list, &active, current_time);
+                          if (preemptive && enable_aging && (current_time >= last_aging_check + run->aging_interval)){ apply_aging(run, local_list, &active, current_time); last_aging_check = current_time; }
                           if (max_simulation_time != -1 && current_time >= max_simulation_time) { running_p->state = STATE_READY; current_running_idx = -1; break; }
                           int current_best_idx = -1; min_priority = INT_MAX;
-                           for (int i = 0; i < count; i++) {
-                                if (local_list[i].state == STATE_READY && local_list[i].finish_time == -1 && local_list[i].arrival_time <= current_time) {
+                          STAT_INC(picks); STAT_ADD(procs_examined, active.size);
+                          STAT_PHASE_BEGIN(PHASE_PICK);
+                           for (int k = 0; k < active.size; k++) {
+                               int i = active.idx[k];
+                                if (local_list[i].state == STATE_READY && local_list[i].finish_time == -1 && local_list[i].spec->arrival_time <= current_time) {
                                      if (local_list[i].current_priority < min_priority) { min_priority = local_list[i].current_priority; current_best_idx = i; }
                                      else if (local_list[i].current_priority == min_priority) {
-                                          if (current_best_idx == -1 || local_list[i].arrival_time < local_list[current_best_idx].arrival_time) { current_best_idx = i; }
+                                          if (current_best_idx == -1 || local_list[i].spec->arrival_time < local_list[current_best_idx].spec->arrival_time) { current_best_idx = i; }
                                      }
                                 }
                            }
+                          STAT_PHASE_END(PHASE_PICK);
                           if (current_best_idx == -1) { current_running_idx = -1; goto check_idle_prio; }
                           current_running_idx = current_best_idx; p = &local_list[current_running_idx];
                       }
 
                       p->state = STATE_RUNNING; p->time_in_ready_queue = 0;
                       if (p->start_time == -1) p->start_time = current_time;
-                      last_process_id = p->id;
-                      printf("%-5d | P%d (Prio: %d) inicia execução PREEMPTIVA (R: %d)\n", current_time, p->id, p->current_priority, p->remaining_time);
+                      last_process_id = p->spec->id;
+                      sim_log(run, "%-5d | P%d (Prio: %d) inicia execução PREEMPTIVA (R: %d)\n", current_time, p->spec->id, p->current_priority, p->remaining_time);
                  }
             }
         } else {
-            if (current_running_idx != -1) {
-                 last_process_id = local_list[current_running_idx].id;
-                 current_running_idx = -1;
-            }
              int all_accounted = 1;
-             for(int i=0; i<count; ++i) {
+             for (int k = 0; k < active.size; k++) {
+                 int i = active.idx[k];
                  if(local_list[i].state != STATE_TERMINATED && local_list[i].state != STATE_BLOCKED && local_list[i].state != STATE_NEW) {
                       if(local_list[i].state == STATE_READY && local_list[i].finish_time == -1) {
                            all_accounted = 0;
@@ -718,35 +994,37 @@ void schedule_priority(Process *list, int count, int preemptive, int enable_agin
              }
 
              current_time++; p->remaining_time--;
-             printf("        P%d executa (R:%d)\n", p->id, p->remaining_time);
+             timeline_run(&timeline, p->spec->id, current_time - 1, current_time);
 
-             (void)check_new_arrivals(local_list, count, current_time);
-             (void)check_io_completions(local_list, count, current_time);
+             (void)check_new_arrivals(run, local_list, &active, current_time);
+             (void)check_io_completions(run, local_list, &active, current_time);
 
 
              int process_stopped = 0;
              if (p->remaining_time == 0) {
-                 printf("%-5d | P%d TERMINOU CPU Burst\n", current_time, p->id);
+                 timeline_stop(&timeline, TL_END_FINISHED);
+                 process_burst_done(p, current_time);
+                 sim_log(run, "%-5d | P%d TERMINOU CPU Burst\n", current_time, p->spec->id);
                  p->state = STATE_TERMINATED;
                  p->finish_time = current_time;
                  completed_count++;
 
-                 if (p->io_burst_duration > 0) {
-                     printf("        P%d iniciando I/O (%d unidades) apos termino do burst\n", p->id, p->io_burst_duration);
-                     p->state = STATE_BLOCKED; p->io_completion_time = current_time + p->io_burst_duration;
+                 if (p->spec->io_burst_duration > 0) {
+                     sim_log(run, "        P%d iniciando I/O (%d unidades) apos termino do burst\n", p->spec->id, p->spec->io_burst_duration);
+                     iodev_submit(&run->io, p, current_time, p->spec->io_burst_duration, NULL);
                  }
+                 report_if_terminated(run, p);
                  process_stopped = 1;
 
-             } else if (preemptive) {
-                 if (p->io_burst_duration > 0 && p->burst_time > 1 && (rand() % (p->burst_time * 2) < 1) ) {
-                       printf("%-5d | P%d iniciando I/O (%d unidades) durante execução\n", current_time, p->id, p->io_burst_duration);
-                       p->state = STATE_BLOCKED; p->io_completion_time = current_time + p->io_burst_duration;
-                       process_stopped = 1;
-                 }
+             } else if (process_io_due(p, current_time)) {
+                 timeline_stop(&timeline, TL_END_IO);
+                 sim_log(run, "%-5d | P%d iniciando I/O (%d unidades) durante execução\n", current_time, p->spec->id, p->io_pending_duration);
+                 iodev_submit(&run->io, p, current_time, p->io_pending_duration, NULL);
+                 process_stopped = 1;
              }
 
              if(process_stopped) {
-                last_process_id = p->id;
+                last_process_id = p->spec->id;
                 current_running_idx = -1;
              }
 
@@ -755,9 +1033,10 @@ void schedule_priority(Process *list, int count, int preemptive, int enable_agin
 
              int next_event_time = INT_MAX;
              int has_ready_process = 0;
-             for (int i = 0; i < count; i++) {
+             for (int k = 0; k < active.size; k++) {
+                 int i = active.idx[k];
                  if(local_list[i].state == STATE_READY && local_list[i].finish_time == -1) has_ready_process = 1;
-                 if (local_list[i].state == STATE_NEW && local_list[i].arrival_time < next_event_time) next_event_time = local_list[i].arrival_time;
+                 if (local_list[i].state == STATE_NEW && local_list[i].spec->arrival_time < next_event_time) next_event_time = local_list[i].spec->arrival_time;
                  if (local_list[i].state == STATE_BLOCKED && local_list[i].io_completion_time < next_event_time) next_event_time = local_list[i].io_completion_time;
              }
 
@@ -767,14 +1046,16 @@ void schedule_priority(Process *list, int count, int preemptive, int enable_agin
               if (next_event_time == INT_MAX || (max_simulation_time != -1 && next_event_time >= max_simulation_time)) {
                   idle_until = (max_simulation_time != -1) ? max_simulation_time : current_time;
                   if (idle_until <= current_time) { break; }
-                  printf("%-5d | CPU Ociosa até %d (Fim da Simulação ou Sem Eventos)\n", current_time, idle_until);
+                  sim_log(run, "%-5d | CPU Ociosa até %d (Fim da Simulação ou Sem Eventos)\n", current_time, idle_until);
                    if (next_event_time == INT_MAX && completed_count >= count) break;
               } else {
                    idle_until = next_event_time;
-                   printf("%-5d | CPU Ociosa até t=%d (Próximo evento)\n", current_time, idle_until);
+                   sim_log(run, "%-5d | CPU Ociosa até t=%d (Próximo evento)\n", current_time, idle_until);
               }
 
               if (idle_until > current_time) {
+                   STAT_INC(idle_fastforwards); STAT_ADD(idle_time_skipped, idle_until - current_time);
+                   trace_idle(run->trace, current_time, idle_until);
                    total_idle_time += (idle_until - current_time);
                    current_time = idle_until;
               }
@@ -782,24 +1063,29 @@ void schedule_priority(Process *list, int count, int preemptive, int enable_agin
 
     }
 
-    printf("------------------------------------------\n");
-    calculate_final_metrics(local_list, count, current_time, total_idle_time, total_context_switches);
-    free(local_list);
+    timeline_finish(&timeline);
+    sim_log(run, "------------------------------------------\n");
+    calculate_final_metrics(run, local_list, count, current_time, total_idle_time, total_context_switches);
+    timeline_report(&timeline, local_list, count);
+    timeline_free(&timeline);
+    active_free(&active);
+    simctx_free(run->arena, local_list);
 }
 
 // ---------------------- SJF (Non-Preemptive) ----------------------
-void schedule_sjf(Process *list, int count, int max_simulation_time) {
-    printf("\n--- SJF (Shortest Job First - Non-Preemptive) ---\n");
-    if (max_simulation_time != -1) printf("Tempo Máximo de Simulação: %d\n", max_simulation_time);
-    printf("Custo Troca de Contexto: %d\n", CONTEXT_SWITCH_COST);
+void schedule_sjf(SimRun *run, const ProcessSpec *list, int count, int max_simulation_time) {
+    sim_log(run, "\n--- SJF (Shortest Job First - Non-Preemptive) ---\n");
+    if (max_simulation_time != -1) sim_log(run, "Tempo Máximo de Simulação: %d\n", max_simulation_time);
+    sim_log(run, "Custo Troca de Contexto: %d\n", run->switch_cost);
     if (count <= 0) { return; }
 
-    Process *local_list = malloc(count * sizeof(Process));
-    if (!local_list) { return; }
+    Process *local_list = simctx_alloc(run->arena, count * sizeof(Process));
+    if (!local_list) { sim_fail(run, SIM_ERR_MEMORY, "Erro malloc SJF\n"); return; }
     for(int i=0; i<count; i++) {
-        local_list[i] = list[i];
-        initialize_process_state(&local_list[i]);
+        process_bind(&local_list[i], &list[i], run->phases);
     }
+    ActiveSet active;
+    if (!active_init(&active, run->arena, count)) { sim_fail(run, SIM_ERR_MEMORY, "Erro malloc SJF\n"); simctx_free(run->arena, local_list); return; }
 
     int current_time = 0;
     int completed_count = 0;
@@ -811,51 +1097,70 @@ void schedule_sjf(Process *list, int count, int max_simulation_time) {
     current_time = find_min_arrival_time(local_list, count);
     if (current_time > 0) {
         total_idle_time = current_time;
+        trace_idle(run->trace, 0, current_time);
     }
 
-    printf("\nTempo | Evento\n");
-    printf("------------------------------------------\n");
+    Timeline timeline;
+    timeline_init(&timeline, run, count);
+    iodev_reset(&run->io, local_list, count);
+    sim_log(run, "\nTempo | Evento\n");
+    sim_log(run, "------------------------------------------\n");
 
+    sim_state_processes(run, local_list, count);
+    SIM_STATE(run, current_time); SIM_STATE(run, completed_count); SIM_STATE(run, total_idle_time);
+    SIM_STATE(run, total_context_switches); SIM_STATE(run, current_running_idx); SIM_STATE(run, last_process_id);
+    if (!sim_state_ready(run)) max_simulation_time = current_time;
      while (completed_count < count && (max_simulation_time == -1 || current_time < max_simulation_time)) {
-         (void)check_new_arrivals(local_list, count, current_time);
-         (void)check_io_completions(local_list, count, current_time);
+         STAT_INC(loop_iterations);
+         sim_checkpoint(run, current_time);
+         active_compact(&active, local_list, completed_count);
+         (void)check_new_arrivals(run, local_list, &active, current_time);
+         (void)check_io_completions(run, local_list, &active, current_time);
 
          if (current_running_idx == -1) {
              int shortest_idx = -1;
              int min_burst = INT_MAX;
-             for (int i = 0; i < count; i++) {
-                if (local_list[i].state == STATE_READY && local_list[i].finish_time == -1 && local_list[i].arrival_time <= current_time) {
-                    if (local_list[i].burst_time < min_burst) {
-                        min_burst = local_list[i].burst_time;
+             STAT_INC(picks); STAT_ADD(procs_examined, active.size);
+             STAT_PHASE_BEGIN(PHASE_PICK);
+             for (int k = 0; k < active.size; k++) {
+                 int i = active.idx[k];
+                if (local_list[i].state == STATE_READY && local_list[i].finish_time == -1 && local_list[i].spec->arrival_time <= current_time) {
+                    if (local_list[i].spec->burst_time < min_burst) {
+                        min_burst = local_list[i].spec->burst_time;
                         shortest_idx = i;
-                    } else if (local_list[i].burst_time == min_burst) {
-                         if (shortest_idx == -1 || local_list[i].arrival_time < local_list[shortest_idx].arrival_time) {
+                    } else if (local_list[i].spec->burst_time == min_burst) {
+                         if (shortest_idx == -1 || local_list[i].spec->arrival_time < local_list[shortest_idx].spec->arrival_time) {
                             shortest_idx = i;
                         }
                     }
                 }
              }
+             STAT_PHASE_END(PHASE_PICK);
 
 
              if (shortest_idx != -1) {
                  current_running_idx = shortest_idx;
                  Process *p = &local_list[current_running_idx];
 
-                 if (CONTEXT_SWITCH_COST > 0 && last_process_id != p->id && last_process_id != -1) {
+                 if (run->switch_cost > 0 && last_process_id != p->spec->id && last_process_id != -1) {
                      char from_str[10];
                      if (last_process_id == -1) strcpy(from_str, "Idle"); else snprintf(from_str, sizeof(from_str), "P%d", last_process_id);
-                     printf("%-5d | Context Switch (%s to P%d) - Custo: %d\n", current_time, from_str, p->id, CONTEXT_SWITCH_COST);
-                     current_time += CONTEXT_SWITCH_COST; total_context_switches++;
-                     (void)check_new_arrivals(local_list, count, current_time); (void)check_io_completions(local_list, count, current_time);
+                     sim_log(run, "%-5d | Context Switch (%s to P%d) - Custo: %d\n", current_time, from_str, p->spec->id, run->switch_cost);
+                     trace_context_switch(run->trace, last_process_id, p->spec->id, current_time, run->switch_cost);
+                     series_switch(run->series, current_time, run->switch_cost);
+                     current_time += run->switch_cost; total_context_switches++;
+                     (void)check_new_arrivals(run, local_list, &active, current_time); (void)check_io_completions(run, local_list, &active, current_time);
                      if (max_simulation_time != -1 && current_time >= max_simulation_time) break;
                  }
 
                  p->state = STATE_RUNNING;
                  if (p->start_time == -1) p->start_time = current_time;
-                 last_process_id = p->id;
-                 printf("%-5d | P%d (Burst: %d) inicia execução (R: %d)\n", current_time, p->id, p->burst_time, p->remaining_time);
+                 last_process_id = p->spec->id;
+                 sim_log(run, "%-5d | P%d (Burst: %d) inicia execução (R: %d)\n", current_time, p->spec->id, p->spec->burst_time, p->remaining_time);
 
                  int time_to_execute = p->remaining_time;
+                 int ticks_to_io = process_ticks_to_io(p);
+                 if (ticks_to_io < time_to_execute) time_to_execute = ticks_to_io;
                  int execution_end_time = current_time + time_to_execute;
                  int time_limit_reached = 0;
 
@@ -863,7 +1168,7 @@ void schedule_sjf(Process *list, int count, int max_simulation_time) {
                      execution_end_time = max_simulation_time;
                      time_to_execute = max_simulation_time - current_time;
                      time_limit_reached = 1;
-                     printf("        Execução de P%d limitada a %d unidades pelo T Max\n", p->id, time_to_execute);
+                     sim_log(run, "        Execução de P%d limitada a %d unidades pelo T Max\n", p->spec->id, time_to_execute);
                  }
 
                  if (time_to_execute <= 0 && time_limit_reached) {
@@ -874,25 +1179,35 @@ void schedule_sjf(Process *list, int count, int max_simulation_time) {
                  int exec_step = 0;
                  while(exec_step < time_to_execute) {
                       current_time++; exec_step++; p->remaining_time--;
-                      (void)check_new_arrivals(local_list, count, current_time); (void)check_io_completions(local_list, count, current_time);
+                      timeline_run(&timeline, p->spec->id, current_time - 1, current_time);
+                      (void)check_new_arrivals(run, local_list, &active, current_time); (void)check_io_completions(run, local_list, &active, current_time);
                  }
 
                  if (p->remaining_time == 0) {
-                     printf("%-5d | P%d TERMINOU CPU Burst\n", current_time, p->id);
+                     timeline_stop(&timeline, TL_END_FINISHED);
+                     process_burst_done(p, current_time);
+                     sim_log(run, "%-5d | P%d TERMINOU CPU Burst\n", current_time, p->spec->id);
                      p->state = STATE_TERMINATED;
                      p->finish_time = current_time;
                      completed_count++;
 
-                      if (p->io_burst_duration > 0) {
-                           printf("        P%d iniciando I/O (%d unidades) apos termino do burst\n", p->id, p->io_burst_duration);
-                           p->state = STATE_BLOCKED; p->io_completion_time = current_time + p->io_burst_duration;
+                      if (p->spec->io_burst_duration > 0) {
+                           sim_log(run, "        P%d iniciando I/O (%d unidades) apos termino do burst\n", p->spec->id, p->spec->io_burst_duration);
+                           iodev_submit(&run->io, p, current_time, p->spec->io_burst_duration, NULL);
                       }
+                      report_if_terminated(run, p);
+                 } else if (process_io_due(p, current_time)) {
+                     timeline_stop(&timeline, TL_END_IO);
+                     sim_log(run, "%-5d | P%d iniciando I/O (%d unidades) durante execução\n", current_time, p->spec->id, p->io_pending_duration);
+                     iodev_submit(&run->io, p, current_time, p->io_pending_duration, NULL);
                  } else if (time_limit_reached) {
-                      printf("%-5d | Simulação INTERROMPIDA (T Max) enquanto P%d executava.\n", current_time, p->id);
+                      timeline_stop(&timeline, TL_END_TIME_LIMIT);
+                      sim_log(run, "%-5d | Simulação INTERROMPIDA (T Max) enquanto P%d executava.\n", current_time, p->spec->id);
                       p->state = STATE_READY;
                  } else {
-                     fprintf(stderr, "Erro lógico em SJF P%d\n", p->id);
+                     sim_warn(run, "Erro lógico em SJF P%d\n", p->spec->id);
                      p->state = STATE_TERMINATED; p->finish_time = current_time; completed_count++;
+                     process_exit(run, p, current_time);
                  }
                  current_running_idx = -1;
 
@@ -906,9 +1221,10 @@ void schedule_sjf(Process *list, int count, int max_simulation_time) {
          check_idle_sjf:
              int next_event_time = INT_MAX;
              int has_ready_process = 0;
-             for (int i = 0; i < count; i++) {
+             for (int k = 0; k < active.size; k++) {
+                 int i = active.idx[k];
                  if(local_list[i].state == STATE_READY && local_list[i].finish_time == -1) has_ready_process = 1;
-                 if (local_list[i].state == STATE_NEW && local_list[i].arrival_time < next_event_time) next_event_time = local_list[i].arrival_time;
+                 if (local_list[i].state == STATE_NEW && local_list[i].spec->arrival_time < next_event_time) next_event_time = local_list[i].spec->arrival_time;
                  if (local_list[i].state == STATE_BLOCKED && local_list[i].io_completion_time < next_event_time) next_event_time = local_list[i].io_completion_time;
              }
 
@@ -918,38 +1234,1146 @@ void schedule_sjf(Process *list, int count, int max_simulation_time) {
              if (next_event_time == INT_MAX || (max_simulation_time != -1 && next_event_time >= max_simulation_time)) {
                  idle_until = (max_simulation_time != -1) ? max_simulation_time : current_time;
                  if (idle_until <= current_time) { break; }
-                 printf("%-5d | CPU Ociosa até %d (Fim da Simulação ou Sem Eventos)\n", current_time, idle_until);
+                 sim_log(run, "%-5d | CPU Ociosa até %d (Fim da Simulação ou Sem Eventos)\n", current_time, idle_until);
                   if (next_event_time == INT_MAX && completed_count >= count) break;
              } else {
                  idle_until = next_event_time;
-                 printf("%-5d | CPU Ociosa até t=%d (Próximo evento)\n", current_time, idle_until);
+                 sim_log(run, "%-5d | CPU Ociosa até t=%d (Próximo evento)\n", current_time, idle_until);
              }
 
              if (idle_until > current_time) {
+                 STAT_INC(idle_fastforwards); STAT_ADD(idle_time_skipped, idle_until - current_time);
+                 trace_idle(run->trace, current_time, idle_until);
                  total_idle_time += (idle_until - current_time);
                  current_time = idle_until;
              }
          }
      }
 
-    printf("------------------------------------------\n");
-    calculate_final_metrics(local_list, count, current_time, total_idle_time, total_context_switches);
-    free(local_list);
+    timeline_finish(&timeline);
+    sim_log(run, "------------------------------------------\n");
+    calculate_final_metrics(run, local_list, count, current_time, total_idle_time, total_context_switches);
+    timeline_report(&timeline, local_list, count);
+    timeline_free(&timeline);
+    active_free(&active);
+    simctx_free(run->arena, local_list);
 }
 
 
+// ---------------------- SRTF / SJF Preditivo (heap indexado) ----------------------
+int compare_arrival_id(const void *a, const void *b) {
+    Process *p1 = (Process *)a;
+    Process *p2 = (Process *)b;
+    if (p1->spec->arrival_time == p2->spec->arrival_time) return p1->spec->id - p2->spec->id;
+    return p1->spec->arrival_time - p2->spec->arrival_time;
+}
+
+// Chave de ordenação na fila de prontos: tempo restante (SRTF) ou estimativa
+// tau do próximo burst (SJF preditivo, em milésimos de unidade).
+static long long shortest_key(const Process *p, int predictive) {
+    if (predictive) return (long long)llround(p->predicted_burst * 1000.0);
+    return p->remaining_time;
+}
+
+// tau(n+1) = alpha * t(n) + (1 - alpha) * tau(n)
+static void update_burst_prediction(Process *p, double alpha) {
+    if (p->cpu_burst_executed <= 0) return;
+    p->predicted_burst = alpha * p->cpu_burst_executed + (1.0 - alpha) * p->predicted_burst;
+    p->cpu_burst_executed = 0;
+}
+
+// Chamado sempre que um processo passa a READY nos motores orientados a
+// eventos, para que cada motor o insira na sua própria estrutura de prontos.
+typedef void (*ReadyCallback)(Process *local_list, int idx, void *arg);
+
+static void admit_ready_events(SimRun *run, Process *local_list, int count, int current_time, int *next_arrival,
+                               IndexedHeap *io_wait, ReadyCallback on_ready, void *arg) {
+    STAT_INC(arrival_checks);
+    STAT_PHASE_BEGIN(PHASE_ARRIVAL_CHECKS);
+    while (*next_arrival < count && local_list[*next_arrival].spec->arrival_time <= current_time) {
+        Process *p = &local_list[*next_arrival];
+        sim_log(run, "        Arrival: P%d at time %d\n", p->spec->id, current_time);
+        trace_arrival(run->trace, p->spec->id, current_time);
+        series_arrival(run->series, current_time);
+        p->state = STATE_READY;
+        p->time_in_ready_queue = 0;
+        on_ready(local_list, *next_arrival, arg);
+        (*next_arrival)++;
+        STAT_INC(arrivals_fired);
+    }
+    STAT_PHASE_END(PHASE_ARRIVAL_CHECKS);
+    STAT_INC(io_checks);
+    STAT_PHASE_BEGIN(PHASE_IO_CHECKS);
+    iodev_advance(&run->io, current_time, io_wait);
+    while (io_wait->size > 0 && heap_peek_key(io_wait) <= current_time) {
+        int idx = heap_pop(io_wait);
+        Process *p = &local_list[idx];
+        STAT_INC(io_fired);
+        sim_log(run, "        I/O Complete: P%d at time %d\n", p->spec->id, current_time);
+        series_io_end(run->series, current_time);
+        if (p->remaining_time <= 0) {
+            sim_log(run, "        P%d TERMINOU após I/O\n", p->spec->id);
+            p->state = STATE_TERMINATED;
+            p->finish_time = current_time;
+            process_exit(run, p, current_time);
+        } else {
+            p->state = STATE_READY;
+            p->time_in_ready_queue = 0;
+            p->burst_ready_time = current_time;
+            on_ready(local_list, idx, arg);
+        }
+        p->io_completion_time = -1;
+    }
+    STAT_PHASE_END(PHASE_IO_CHECKS);
+}
+
+typedef struct {
+    IndexedHeap *ready;
+    int predictive;
+} ShortestReadyArg;
+
+static void shortest_on_ready(Process *local_list, int idx, void *arg) {
+    ShortestReadyArg *sa = (ShortestReadyArg *)arg;
+    heap_push(sa->ready, idx, shortest_key(&local_list[idx], sa->predictive), local_list[idx].spec->arrival_time);
+}
+
+static void schedule_shortest_heap(SimRun *run, const ProcessSpec *list, int count, int max_simulation_time,
+                                   int preemptive, int predictive, double alpha, double tau0) {
+    if (count <= 0) { return; }
+
+    Process *local_list = simctx_alloc(run->arena, count * sizeof(Process));
+    if (!local_list) { sim_fail(run, SIM_ERR_MEMORY, "Erro malloc SRTF/SJF preditivo\n"); return; }
+    for (int i = 0; i < count; i++) {
+        process_bind(&local_list[i], &list[i], run->phases);
+        local_list[i].predicted_burst = tau0;
+    }
+    qsort(local_list, count, sizeof(Process), compare_arrival_id);
+
+    IndexedHeap ready, io_wait;
+    if (!heap_init(&ready, run->arena, count) || !heap_init(&io_wait, run->arena, count)) {
+        sim_fail(run, SIM_ERR_MEMORY, "Erro malloc SRTF/SJF preditivo\n");
+        heap_free(&ready); simctx_free(run->arena, local_list);
+        return;
+    }
+    ShortestReadyArg ready_arg = { &ready, predictive };
+
+    int current_time = 0;
+    int completed_count = 0;
+    int total_idle_time = 0;
+    int total_context_switches = 0;
+    int current_running_idx = -1;
+    int last_process_id = -1;
+    int next_arrival = 0;
+
+    current_time = find_min_arrival_time(local_list, count);
+    if (current_time > 0) {
+        total_idle_time = current_time;
+        trace_idle(run->trace, 0, current_time);
+    }
+
+    Timeline timeline;
+    timeline_init(&timeline, run, count);
+    iodev_reset(&run->io, local_list, count);
+    sim_log(run, "\nTempo | Evento\n");
+    sim_log(run, "------------------------------------------\n");
+
+    sim_state_processes(run, local_list, count);
+    SIM_STATE(run, current_time); SIM_STATE(run, completed_count); SIM_STATE(run, total_idle_time);
+    SIM_STATE(run, total_context_switches); SIM_STATE(run, current_running_idx); SIM_STATE(run, last_process_id);
+    SIM_STATE(run, next_arrival);
+    sim_state_heap(run, &ready); sim_state_heap(run, &io_wait);
+    if (!sim_state_ready(run)) max_simulation_time = current_time;
+    while (completed_count < count && (max_simulation_time == -1 || current_time < max_simulation_time)) {
+        STAT_INC(loop_iterations);
+        sim_checkpoint(run, current_time);
+        admit_ready_events(run, local_list, count, current_time, &next_arrival, &io_wait, shortest_on_ready, &ready_arg);
+
+        if (current_running_idx != -1 && preemptive && ready.size > 0) {
+            Process *running_p = &local_list[current_running_idx];
+            int best_idx = heap_peek(&ready);
+            STAT_INC(preemption_checks);
+            if (heap_peek_key(&ready) < shortest_key(running_p, predictive)) {
+                STAT_INC(preemptions);
+                Process *next_p = &local_list[best_idx];
+                sim_log(run, "%-5d | PREEMPÇÃO SRTF: P%d (R:%d) preempta P%d (R:%d)\n",
+                       current_time, next_p->spec->id, next_p->remaining_time, running_p->spec->id, running_p->remaining_time);
+                timeline_stop(&timeline, TL_END_PREEMPTED);
+                trace_preemption(run->trace, running_p->spec->id, next_p->spec->id, current_time);
+                running_p->state = STATE_READY;
+                heap_push(&ready, current_running_idx, shortest_key(running_p, predictive), running_p->spec->arrival_time);
+                current_running_idx = -1;
+            }
+        }
+
+        if (current_running_idx == -1) {
+            STAT_PHASE_BEGIN(PHASE_PICK);
+            int best_idx = heap_pop(&ready);
+            STAT_PHASE_END(PHASE_PICK);
+            STAT_INC(picks); STAT_INC(procs_examined);
+
+            if (best_idx == -1) {
+                long long next_event_time = LLONG_MAX;
+                if (next_arrival < count) next_event_time = local_list[next_arrival].spec->arrival_time;
+                if (io_wait.size > 0 && heap_peek_key(&io_wait) < next_event_time) next_event_time = heap_peek_key(&io_wait);
+
+                int idle_until;
+                if (next_event_time == LLONG_MAX || (max_simulation_time != -1 && next_event_time >= max_simulation_time)) {
+                    idle_until = (max_simulation_time != -1) ? max_simulation_time : current_time;
+                    if (idle_until <= current_time) { break; }
+                    sim_log(run, "%-5d | CPU Ociosa até %d (Fim da Simulação ou Sem Eventos)\n", current_time, idle_until);
+                } else {
+                    idle_until = (int)next_event_time;
+                    sim_log(run, "%-5d | CPU Ociosa até t=%d (Próximo evento)\n", current_time, idle_until);
+                }
+
+                if (idle_until > current_time) {
+                    STAT_INC(idle_fastforwards); STAT_ADD(idle_time_skipped, idle_until - current_time);
+                    trace_idle(run->trace, current_time, idle_until);
+                    total_idle_time += (idle_until - current_time);
+                    current_time = idle_until;
+                }
+                continue;
+            }
+
+            Process *p = &local_list[best_idx];
+            if (run->switch_cost > 0 && last_process_id != p->spec->id && last_process_id != -1) {
+                sim_log(run, "%-5d | Context Switch (P%d to P%d) - Custo: %d\n", current_time, last_process_id, p->spec->id, run->switch_cost);
+                trace_context_switch(run->trace, last_process_id, p->spec->id, current_time, run->switch_cost);
+                series_switch(run->series, current_time, run->switch_cost);
+                current_time += run->switch_cost; total_context_switches++;
+                last_process_id = p->spec->id;
+                admit_ready_events(run, local_list, count, current_time, &next_arrival, &io_wait, shortest_on_ready, &ready_arg);
+                if (max_simulation_time != -1 && current_time >= max_simulation_time) {
+                    p->state = STATE_READY;
+                    heap_push(&ready, best_idx, shortest_key(p, predictive), p->spec->arrival_time);
+                    break;
+                }
+                if (preemptive && ready.size > 0 && heap_peek_key(&ready) < shortest_key(p, predictive)) {
+                    heap_push(&ready, best_idx, shortest_key(p, predictive), p->spec->arrival_time);
+                    best_idx = heap_pop(&ready);
+                    p = &local_list[best_idx];
+                }
+            }
+
+            current_running_idx = best_idx;
+            p->state = STATE_RUNNING;
+            if (p->start_time == -1) p->start_time = current_time;
+            last_process_id = p->spec->id;
+            if (predictive) {
+                sim_log(run, "%-5d | P%d (Tau: %.2f) inicia execução (R: %d)\n", current_time, p->spec->id, p->predicted_burst, p->remaining_time);
+            } else {
+                sim_log(run, "%-5d | P%d inicia execução (R: %d)\n", current_time, p->spec->id, p->remaining_time);
+            }
+        }
+
+        Process *p = &local_list[current_running_idx];
+
+        // Executa até ao próximo evento relevante em vez de tick a tick.
+        long long run_until = (long long)current_time + p->remaining_time;
+        int ticks_to_io = process_ticks_to_io(p);
+        if (ticks_to_io != INT_MAX && (long long)current_time + ticks_to_io < run_until) run_until = (long long)current_time + ticks_to_io;
+        if (preemptive) {
+            if (next_arrival < count && local_list[next_arrival].spec->arrival_time < run_until) run_until = local_list[next_arrival].spec->arrival_time;
+            if (io_wait.size > 0 && heap_peek_key(&io_wait) < run_until) run_until = heap_peek_key(&io_wait);
+        }
+        if (max_simulation_time != -1 && run_until > max_simulation_time) run_until = max_simulation_time;
+        if (run_until <= current_time) run_until = current_time + 1;
+
+        int delta = (int)(run_until - current_time);
+        current_time += delta;
+        p->remaining_time -= delta;
+        timeline_run(&timeline, p->spec->id, current_time - delta, current_time);
+        p->cpu_burst_executed += delta;
+
+        if (p->remaining_time == 0) {
+            timeline_stop(&timeline, TL_END_FINISHED);
+            process_burst_done(p, current_time);
+            sim_log(run, "%-5d | P%d TERMINOU CPU Burst\n", current_time, p->spec->id);
+            update_burst_prediction(p, alpha);
+            p->state = STATE_TERMINATED;
+            p->finish_time = current_time;
+            completed_count++;
+            if (p->spec->io_burst_duration > 0) {
+                sim_log(run, "        P%d iniciando I/O (%d unidades) apos termino do burst\n", p->spec->id, p->spec->io_burst_duration);
+                iodev_submit(&run->io, p, current_time, p->spec->io_burst_duration, &io_wait);
+            }
+            report_if_terminated(run, p);
+            current_running_idx = -1;
+        } else if (process_io_due(p, current_time)) {
+            timeline_stop(&timeline, TL_END_IO);
+            sim_log(run, "%-5d | P%d iniciando I/O (%d unidades) durante execução\n", current_time, p->spec->id, p->io_pending_duration);
+            update_burst_prediction(p, alpha);
+            iodev_submit(&run->io, p, current_time, p->io_pending_duration, &io_wait);
+            current_running_idx = -1;
+        } else if (max_simulation_time != -1 && current_time >= max_simulation_time) {
+            p->state = STATE_READY;
+            current_running_idx = -1;
+        }
+    }
+
+    timeline_finish(&timeline);
+    sim_log(run, "------------------------------------------\n");
+    calculate_final_metrics(run, local_list, count, current_time, total_idle_time, total_context_switches);
+    timeline_report(&timeline, local_list, count);
+    timeline_free(&timeline);
+    heap_free(&ready);
+    heap_free(&io_wait);
+    simctx_free(run->arena, local_list);
+}
+
+void schedule_srtf(SimRun *run, const ProcessSpec *list, int count, int max_simulation_time) {
+    sim_log(run, "\n--- SRTF (Shortest Remaining Time First - Preemptive) ---\n");
+    if (max_simulation_time != -1) sim_log(run, "Tempo Máximo de Simulação: %d\n", max_simulation_time);
+    sim_log(run, "Custo Troca de Contexto: %d\n", run->switch_cost);
+    schedule_shortest_heap(run, list, count, max_simulation_time, 1, 0, 0.0, 0.0);
+}
+
+void schedule_sjf_predictive(SimRun *run, const ProcessSpec *list, int count, double alpha, double tau0, int max_simulation_time) {
+    sim_log(run, "\n--- SJF Preditivo (Média Exponencial, Non-Preemptive) ---\n");
+    sim_log(run, "    (tau = %.2f * t + %.2f * tau, tau0 = %.2f)\n", alpha, 1.0 - alpha, tau0);
+    if (max_simulation_time != -1) sim_log(run, "Tempo Máximo de Simulação: %d\n", max_simulation_time);
+    sim_log(run, "Custo Troca de Contexto: %d\n", run->switch_cost);
+    schedule_shortest_heap(run, list, count, max_simulation_time, 0, 1, alpha, tau0);
+}
+
+
+// ---------------------- Lottery / Stride (Partilha Proporcional) ----------------------
+#define SHARE_CLASSES 10
+#define STRIDE_ONE (1LL << 20)
+
+typedef struct {
+    int stride_mode;
+    Fenwick *lottery;       // bilhetes dos processos READY (lottery)
+    IndexedHeap *pass_heap; // processos READY ordenados por pass (stride)
+    long long *pass;
+    long long global_pass;
+    long long class_ready_tickets[SHARE_CLASSES];
+} ShareReadyArg;
+
+static int share_class(const Process *p) {
+    if (p->spec->priority < 0) return 0;
+    if (p->spec->priority >= SHARE_CLASSES) return SHARE_CLASSES - 1;
+    return p->spec->priority;
+}
+
+static long long process_stride(const Process *p) {
+    return STRIDE_ONE / (p->spec->tickets > 0 ? p->spec->tickets : 1);
+}
+
+static void share_on_ready(Process *local_list, int idx, void *arg) {
+    ShareReadyArg *sa = (ShareReadyArg *)arg;
+    Process *p = &local_list[idx];
+    sa->class_ready_tickets[share_class(p)] += p->spec->tickets;
+    if (sa->stride_mode) {
+        // Um processo que (re)entra não pode acumular crédito enquanto esteve fora.
+        if (sa->pass[idx] < sa->global_pass) sa->pass[idx] = sa->global_pass;
+        heap_push(sa->pass_heap, idx, sa->pass[idx], p->spec->arrival_time);
+    } else {
+        fenwick_set(sa->lottery, idx, p->spec->tickets);
+    }
+}
+
+static void share_leave_ready(Process *p, ShareReadyArg *sa) {
+    sa->class_ready_tickets[share_class(p)] -= p->spec->tickets;
+}
+
+static long long draw_ticket(SimRun *run, long long total) {
+    unsigned long long r = sim_rand(run);
+    return (long long)(r % (unsigned long long)total);
+}
+
+static void print_share_report(SimRun *run, Process *local_list, int count, const double *class_target,
+                               const long long *class_cpu, long long total_cpu) {
+    long long class_tickets[SHARE_CLASSES] = {0};
+    int class_procs[SHARE_CLASSES] = {0};
+    for (int i = 0; i < count; i++) {
+        class_tickets[share_class(&local_list[i])] += local_list[i].spec->tickets;
+        class_procs[share_class(&local_list[i])]++;
+    }
+
+    sim_log(run, "\n--- Partilha de CPU por Classe (Prioridade) ---\n");
+    sim_log(run, "Classe | Procs | Bilhetes | CPU Alvo (%%) | CPU Obtido (%%) | Desvio\n");
+    sim_log(run, "--------------------------------------------------------------------\n");
+    for (int c = 0; c < SHARE_CLASSES; c++) {
+        if (class_procs[c] == 0) continue;
+        double target = (total_cpu > 0) ? class_target[c] * 100.0 / total_cpu : 0.0;
+        double achieved = (total_cpu > 0) ? (double)class_cpu[c] * 100.0 / total_cpu : 0.0;
+        sim_log(run, "%-6d | %-5d | %-8lld | %-12.2f | %-14.2f | %+.2f\n",
+               c, class_procs[c], class_tickets[c], target, achieved, achieved - target);
+    }
+    sim_log(run, "--------------------------------------------------------------------\n");
+    sim_log(run, "(Alvo = quota de bilhetes entre os processos em competição em cada instante)\n");
+}
+
+static void schedule_proportional_share(SimRun *run, const ProcessSpec *list, int count, int quantum, int max_simulation_time, int stride_mode) {
+    if (count <= 0 || quantum <= 0) { return; }
+
+    Process *local_list = simctx_alloc(run->arena, count * sizeof(Process));
+    if (!local_list) { sim_fail(run, SIM_ERR_MEMORY, "Erro malloc Lottery/Stride\n"); return; }
+    for (int i = 0; i < count; i++) {
+        process_bind(&local_list[i], &list[i], run->phases);
+    }
+    qsort(local_list, count, sizeof(Process), compare_arrival_id);
+
+    IndexedHeap io_wait, pass_heap;
+    Fenwick lottery;
+    long long *pass = simctx_calloc(run->arena, count, sizeof(long long));
+    if (!pass || !heap_init(&io_wait, run->arena, count) || !heap_init(&pass_heap, run->arena, count) || !fenwick_init(&lottery, run->arena, count)) {
+        sim_fail(run, SIM_ERR_MEMORY, "Erro malloc Lottery/Stride\n");
+        simctx_free(run->arena, pass); heap_free(&io_wait); heap_free(&pass_heap); fenwick_free(&lottery); simctx_free(run->arena, local_list);
+        return;
+    }
+    ShareReadyArg share = { stride_mode, &lottery, &pass_heap, pass, 0, {0} };
+
+    double class_target[SHARE_CLASSES] = {0};
+    long long class_cpu[SHARE_CLASSES] = {0};
+    long long total_cpu = 0;
+
+    int current_time = 0;
+    int completed_count = 0;
+    int total_idle_time = 0;
+    int total_context_switches = 0;
+    int last_process_id = -1;
+    int next_arrival = 0;
+
+    current_time = find_min_arrival_time(local_list, count);
+    if (current_time > 0) {
+        total_idle_time = current_time;
+        trace_idle(run->trace, 0, current_time);
+    }
+
+    Timeline timeline;
+    timeline_init(&timeline, run, count);
+    iodev_reset(&run->io, local_list, count);
+    sim_log(run, "\nTempo | Evento\n");
+    sim_log(run, "------------------------------------------\n");
+
+    sim_state_processes(run, local_list, count);
+    SIM_STATE(run, current_time); SIM_STATE(run, completed_count); SIM_STATE(run, total_idle_time);
+    SIM_STATE(run, total_context_switches); SIM_STATE(run, last_process_id); SIM_STATE(run, next_arrival);
+    SIM_STATE(run, quantum); SIM_STATE(run, total_cpu); SIM_STATE(run, class_target); SIM_STATE(run, class_cpu);
+    SIM_STATE(run, share.global_pass); SIM_STATE(run, share.class_ready_tickets);
+    sim_state_bytes(run, pass, sizeof(long long) * count);
+    sim_state_heap(run, &io_wait); sim_state_heap(run, &pass_heap); sim_state_fenwick(run, &lottery);
+    if (!sim_state_ready(run)) max_simulation_time = current_time;
+    while (completed_count < count && (max_simulation_time == -1 || current_time < max_simulation_time)) {
+        STAT_INC(loop_iterations);
+        if (sim_checkpoint(run, current_time)) quantum = run->quantum;
+        admit_ready_events(run, local_list, count, current_time, &next_arrival, &io_wait, share_on_ready, &share);
+
+        int chosen_idx = -1;
+        STAT_INC(picks); STAT_INC(procs_examined);
+        STAT_PHASE_BEGIN(PHASE_PICK);
+        if (stride_mode) {
+            chosen_idx = heap_pop(&pass_heap);
+        } else {
+            long long total_tickets = fenwick_total(&lottery);
+            if (total_tickets > 0) {
+                long long ticket = draw_ticket(run, total_tickets);
+                chosen_idx = fenwick_find(&lottery, ticket);
+                if (chosen_idx != -1) fenwick_set(&lottery, chosen_idx, 0);
+            }
+        }
+        STAT_PHASE_END(PHASE_PICK);
+
+        if (chosen_idx == -1) {
+            long long next_event_time = LLONG_MAX;
+            if (next_arrival < count) next_event_time = local_list[next_arrival].spec->arrival_time;
+            if (io_wait.size > 0 && heap_peek_key(&io_wait) < next_event_time) next_event_time = heap_peek_key(&io_wait);
+
+            int idle_until;
+            if (next_event_time == LLONG_MAX || (max_simulation_time != -1 && next_event_time >= max_simulation_time)) {
+                idle_until = (max_simulation_time != -1) ? max_simulation_time : current_time;
+                if (idle_until <= current_time) { break; }
+                sim_log(run, "%-5d | CPU Ociosa até %d (Fim da Simulação ou Sem Eventos)\n", current_time, idle_until);
+            } else {
+                idle_until = (int)next_event_time;
+                sim_log(run, "%-5d | CPU Ociosa até t=%d (Próximo evento)\n", current_time, idle_until);
+            }
+
+            if (idle_until > current_time) {
+                STAT_INC(idle_fastforwards); STAT_ADD(idle_time_skipped, idle_until - current_time);
+                trace_idle(run->trace, current_time, idle_until);
+                total_idle_time += (idle_until - current_time);
+                current_time = idle_until;
+            }
+            continue;
+        }
+
+        Process *p = &local_list[chosen_idx];
+        if (run->switch_cost > 0 && last_process_id != p->spec->id && last_process_id != -1) {
+            sim_log(run, "%-5d | Context Switch (P%d to P%d) - Custo: %d\n", current_time, last_process_id, p->spec->id, run->switch_cost);
+            trace_context_switch(run->trace, last_process_id, p->spec->id, current_time, run->switch_cost);
+            series_switch(run->series, current_time, run->switch_cost);
+            current_time += run->switch_cost; total_context_switches++;
+            admit_ready_events(run, local_list, count, current_time, &next_arrival, &io_wait, share_on_ready, &share);
+            if (max_simulation_time != -1 && current_time >= max_simulation_time) {
+                p->state = STATE_READY;
+                break;
+            }
+        }
+
+        // O processo escolhido continua a contar como "em competição" durante a fatia.
+        long long competing_tickets = 0;
+        for (int c = 0; c < SHARE_CLASSES; c++) competing_tickets += share.class_ready_tickets[c];
+
+        p->state = STATE_RUNNING;
+        if (p->start_time == -1) p->start_time = current_time;
+        last_process_id = p->spec->id;
+        if (stride_mode) {
+            sim_log(run, "%-5d | P%d (Bilhetes: %d, Pass: %lld) inicia execução (R: %d)\n", current_time, p->spec->id, p->spec->tickets, pass[chosen_idx], p->remaining_time);
+        } else {
+            sim_log(run, "%-5d | P%d (Bilhetes: %d de %lld) ganha a lotaria (R: %d)\n", current_time, p->spec->id, p->spec->tickets, competing_tickets, p->remaining_time);
+        }
+
+        int slice = (p->remaining_time < quantum) ? p->remaining_time : quantum;
+        int ticks_to_io = process_ticks_to_io(p);
+        if (ticks_to_io < slice) slice = ticks_to_io;
+        if (max_simulation_time != -1 && current_time + slice > max_simulation_time) slice = max_simulation_time - current_time;
+        if (slice <= 0) slice = 1;
+
+        if (competing_tickets > 0) {
+            for (int c = 0; c < SHARE_CLASSES; c++) {
+                if (share.class_ready_tickets[c] > 0) {
+                    class_target[c] += (double)slice * share.class_ready_tickets[c] / competing_tickets;
+                }
+            }
+        }
+        class_cpu[share_class(p)] += slice;
+        total_cpu += slice;
+
+        current_time += slice;
+        p->remaining_time -= slice;
+        timeline_run(&timeline, p->spec->id, current_time - slice, current_time);
+
+        if (stride_mode) {
+            pass[chosen_idx] += process_stride(p) * slice / quantum;
+            share.global_pass = pass[chosen_idx];
+            if (pass_heap.size > 0 && heap_peek_key(&pass_heap) < share.global_pass) share.global_pass = heap_peek_key(&pass_heap);
+        }
+        share_leave_ready(p, &share);
+
+        if (p->remaining_time == 0) {
+            timeline_stop(&timeline, TL_END_FINISHED);
+            process_burst_done(p, current_time);
+            sim_log(run, "%-5d | P%d TERMINOU CPU Burst\n", current_time, p->spec->id);
+            p->state = STATE_TERMINATED;
+            p->finish_time = current_time;
+            completed_count++;
+            if (p->spec->io_burst_duration > 0) {
+                sim_log(run, "        P%d iniciando I/O (%d unidades) apos termino do burst\n", p->spec->id, p->spec->io_burst_duration);
+                iodev_submit(&run->io, p, current_time, p->spec->io_burst_duration, &io_wait);
+            }
+            report_if_terminated(run, p);
+        } else if (process_io_due(p, current_time)) {
+            timeline_stop(&timeline, TL_END_IO);
+            sim_log(run, "%-5d | P%d iniciando I/O (%d unidades) durante execução\n", current_time, p->spec->id, p->io_pending_duration);
+            iodev_submit(&run->io, p, current_time, p->io_pending_duration, &io_wait);
+        } else if (max_simulation_time != -1 && current_time >= max_simulation_time) {
+            timeline_stop(&timeline, TL_END_TIME_LIMIT);
+            p->state = STATE_READY;
+        } else {
+            timeline_stop(&timeline, TL_END_QUANTUM);
+            p->state = STATE_READY;
+            p->time_in_ready_queue = 0;
+            share_on_ready(local_list, chosen_idx, &share);
+        }
+    }
+
+    timeline_finish(&timeline);
+    sim_log(run, "------------------------------------------\n");
+    calculate_final_metrics(run, local_list, count, current_time, total_idle_time, total_context_switches);
+    timeline_report(&timeline, local_list, count);
+    timeline_free(&timeline);
+    print_share_report(run, local_list, count, class_target, class_cpu, total_cpu);
+    heap_free(&io_wait);
+    heap_free(&pass_heap);
+    fenwick_free(&lottery);
+    simctx_free(run->arena, pass);
+    simctx_free(run->arena, local_list);
+}
+
+void schedule_lottery(SimRun *run, const ProcessSpec *list, int count, int quantum, int max_simulation_time) {
+    sim_log(run, "\n--- Lottery Scheduling (q = %d) ---\n", quantum);
+    sim_log(run, "    (Bilhetes: coluna Tickets do ficheiro ou derivados da prioridade)\n");
+    if (max_simulation_time != -1) sim_log(run, "Tempo Máximo de Simulação: %d\n", max_simulation_time);
+    sim_log(run, "Custo Troca de Contexto: %d\n", run->switch_cost);
+    schedule_proportional_share(run, list, count, quantum, max_simulation_time, 0);
+}
+
+void schedule_stride(SimRun *run, const ProcessSpec *list, int count, int quantum, int max_simulation_time) {
+    sim_log(run, "\n--- Stride Scheduling (q = %d) ---\n", quantum);
+    sim_log(run, "    (Stride = %lld / Bilhetes, menor pass executa primeiro)\n", STRIDE_ONE);
+    if (max_simulation_time != -1) sim_log(run, "Tempo Máximo de Simulação: %d\n", max_simulation_time);
+    sim_log(run, "Custo Troca de Contexto: %d\n", run->switch_cost);
+    schedule_proportional_share(run, list, count, quantum, max_simulation_time, 1);
+}
+
+
+// ---------------------- Tarefas Periódicas (RM / EDF) ----------------------
+// Cada processo com period > 0 é uma tarefa periódica que liberta um job a cada
+// 'period' unidades a partir de arrival_time, com deadline relativo 'deadline'
+// (ou igual ao período se deadline <= 0). Processos com period == 0 libertam um
+// único job com deadline absoluto. Os jobs nunca são materializados: cada tarefa
+// guarda apenas o job corrente e o número de jobs libertados em atraso.
+#define PERIODIC_HORIZON_CAP 1000000000
+
+typedef struct {
+    int next_release;
+    int job_release;
+    int job_start;              // primeiro início do job corrente (-1 = ainda não)
+    int job_deadline;
+    int job_remaining;
+    int pending_jobs;
+    int rm_rank;
+    int jobs_released;
+    int jobs_completed;
+    int deadline_misses;
+    int response_max;
+    int response_min;
+    long long response_sum;
+} PeriodicTaskState;
+
+static int has_periodic_tasks(const ProcessSpec *list, int count) {
+    for (int i = 0; i < count; i++) {
+        if (list[i].period > 0) return 1;
+    }
+    return 0;
+}
+
+static int task_relative_deadline(const Process *p) {
+    if (p->spec->period > 0) return (p->spec->deadline > 0) ? p->spec->deadline : p->spec->period;
+    return (p->spec->deadline > 0) ? p->spec->deadline - p->spec->arrival_time : INT_MAX / 2;
+}
+
+static long long gcd_ll(long long a, long long b) {
+    while (b != 0) { long long r = a % b; a = b; b = r; }
+    return a;
+}
+
+// Hiperperíodo (mmc dos períodos), limitado a PERIODIC_HORIZON_CAP.
+static long long compute_hyperperiod(Process *list, int count, int *capped) {
+    long long h = 1;
+    *capped = 0;
+    for (int i = 0; i < count; i++) {
+        if (list[i].spec->period <= 0) continue;
+        h = h / gcd_ll(h, list[i].spec->period) * list[i].spec->period;
+        if (h > PERIODIC_HORIZON_CAP) { *capped = 1; return PERIODIC_HORIZON_CAP; }
+    }
+    return h;
+}
+
+typedef struct {
+    int period;
+    int idx;
+} RmOrder;
+
+static int compare_rm_rank(const void *a, const void *b) {
+    const RmOrder *r1 = (const RmOrder *)a;
+    const RmOrder *r2 = (const RmOrder *)b;
+    int p1 = r1->period > 0 ? r1->period : INT_MAX;
+    int p2 = r2->period > 0 ? r2->period : INT_MAX;
+    if (p1 != p2) return (p1 < p2) ? -1 : 1;
+    return r1->idx - r2->idx;
+}
+
+static long long periodic_key(const PeriodicTaskState *ts, int use_edf) {
+    return use_edf ? ts->job_deadline : ts->rm_rank;
+}
+
+static void periodic_push_ready(IndexedHeap *ready, PeriodicTaskState *tasks, int idx, int use_edf) {
+    heap_push(ready, idx, periodic_key(&tasks[idx], use_edf), tasks[idx].rm_rank);
+}
+
+static void periodic_start_job(Process *p, PeriodicTaskState *ts, int release) {
+    ts->job_release = release;
+    ts->job_start = -1;
+    ts->job_deadline = release + task_relative_deadline(p);
+    ts->job_remaining = p->spec->burst_time;
+}
+
+// Job para as métricas por classe: completo em 'now', ou (done = 0) ainda
+// por terminar no fim, com os deadlines perdidos que lhe cabem.
+static void class_periodic_job(SimRun *run, const Process *p, const PeriodicTaskState *ts, int now, int done, int missed) {
+    ClassSample s;
+    s.priority = p->spec->priority;
+    s.queue = -1;
+    s.cpu = p->spec->burst_time - ts->job_remaining;
+    s.waiting = now - ts->job_release - s.cpu;
+    if (s.waiting < 0) s.waiting = 0;
+    s.turnaround = done ? now - ts->job_release : -1;
+    s.response = done ? ts->job_start - ts->job_release : -1;
+    s.max_ready = s.waiting;
+    s.missed = missed;
+    class_record(run->classes, &s);
+}
+
+static void periodic_release_jobs(SimRun *run, Process *local_list, PeriodicTaskState *tasks, IndexedHeap *calendar,
+                                  IndexedHeap *ready, int current_time, int horizon, int use_edf) {
+    STAT_INC(arrival_checks);
+    STAT_PHASE_BEGIN(PHASE_ARRIVAL_CHECKS);
+    while (calendar->size > 0 && heap_peek_key(calendar) <= current_time) {
+        int idx = heap_pop(calendar);
+        Process *p = &local_list[idx];
+        PeriodicTaskState *ts = &tasks[idx];
+        int release = ts->next_release;
+        ts->jobs_released++;
+        trace_arrival(run->trace, p->spec->id, release);
+        series_arrival(run->series, release);
+        if (p->state == STATE_NEW) { p->state = STATE_READY; }
+
+        if (ts->job_remaining > 0 || p->state == STATE_RUNNING) {
+            ts->pending_jobs++;
+            sim_log(run, "        Release: P%d job %d at time %d (em atraso: %d)\n", p->spec->id, ts->jobs_released, release, ts->pending_jobs);
+        } else {
+            periodic_start_job(p, ts, release);
+            p->state = STATE_READY;
+            periodic_push_ready(ready, tasks, idx, use_edf);
+            sim_log(run, "        Release: P%d job %d at time %d (D:%d)\n", p->spec->id, ts->jobs_released, release, ts->job_deadline);
+        }
+
+        if (p->spec->period > 0 && (long long)release + p->spec->period < horizon) {
+            ts->next_release = release + p->spec->period;
+            heap_push(calendar, idx, ts->next_release, ts->rm_rank);
+        }
+        STAT_INC(arrivals_fired);
+    }
+    STAT_PHASE_END(PHASE_ARRIVAL_CHECKS);
+}
+
+static void print_periodic_report(SimRun *run, Process *local_list, PeriodicTaskState *tasks, int count, int final_time,
+                                  int horizon, long long hyperperiod, int total_idle_time, int total_context_switches) {
+    long long total_jobs = 0, total_done = 0, total_misses = 0;
+    double utilization = 0.0;
+
+    sim_log(run, "\n--- Resultados por Tarefa ---\n");
+    sim_log(run, "ID | C     | T      | D      | RM | Jobs   | Compl. | Perd. | R Max | R Min | R Med   | Jitter\n");
+    sim_log(run, "--------------------------------------------------------------------------------------------------\n");
+    for (int i = 0; i < count; i++) {
+        Process *p = &local_list[i];
+        PeriodicTaskState *ts = &tasks[i];
+        if (p->spec->period > 0) utilization += (double)p->spec->burst_time / p->spec->period;
+        total_jobs += ts->jobs_released;
+        total_done += ts->jobs_completed;
+        total_misses += ts->deadline_misses;
+        if (ts->jobs_completed > 0) {
+            sim_log(run, "P%-2d| %-5d | %-6d | %-6d | %-2d | %-6d | %-6d | %-5d | %-5d | %-5d | %-7.2f | %d\n",
+                   p->spec->id, p->spec->burst_time, p->spec->period, task_relative_deadline(p), ts->rm_rank + 1,
+                   ts->jobs_released, ts->jobs_completed, ts->deadline_misses,
+                   ts->response_max, ts->response_min, (double)ts->response_sum / ts->jobs_completed,
+                   ts->response_max - ts->response_min);
+        } else {
+            sim_log(run, "P%-2d| %-5d | %-6d | %-6d | %-2d | %-6d | %-6d | %-5d | ----- | ----- | ------- | -----\n",
+                   p->spec->id, p->spec->burst_time, p->spec->period, task_relative_deadline(p), ts->rm_rank + 1,
+                   ts->jobs_released, ts->jobs_completed, ts->deadline_misses);
+        }
+        report_process(run, p);
+    }
+    sim_log(run, "--------------------------------------------------------------------------------------------------\n");
+
+    float cpu_busy_time = (float)(final_time - total_idle_time);
+    float cpu_utilization = (final_time > 0) ? (cpu_busy_time / final_time) * 100.0f : 0;
+
+    sim_log(run, "\n--- Métricas Globais (Periódicas) ---\n");
+    sim_log(run, "Hiperperíodo:                  %lld\n", hyperperiod);
+    sim_log(run, "Horizonte Simulado:            %d\n", horizon);
+    sim_log(run, "Utilização Teórica (Soma C/T): %.4f\n", utilization);
+    sim_log(run, "Tempo Final da Simulação:      %d\n", final_time);
+    sim_log(run, "Tempo Ocioso da CPU:           %d\n", total_idle_time);
+    sim_log(run, "Número de Trocas de Contexto:  %d\n", total_context_switches);
+    sim_log(run, "Custo Total Trocas Contexto:   %d\n", total_context_switches * run->switch_cost);
+    sim_log(run, "--------------------------------------------------\n");
+    sim_log(run, "Jobs Libertados:               %lld\n", total_jobs);
+    sim_log(run, "Jobs Completos:                %lld\n", total_done);
+    sim_log(run, "Deadlines Perdidos:            %lld\n", total_misses);
+    sim_log(run, "Utilização da CPU:             %.2f %%\n", cpu_utilization);
+    sim_log(run, "--------------------------------------------------\n");
+
+    SimResults *res = run->results;
+    res->final_time = final_time;
+    res->idle_time = total_idle_time;
+    res->context_switches = total_context_switches;
+    res->context_switch_cost = total_context_switches * run->switch_cost;
+    res->cpu_utilization = cpu_utilization;
+    res->jobs_released = total_jobs;
+    res->jobs_completed = total_done;
+    res->jobs_missed = total_misses;
+    res->deadline_misses = (int)total_misses;
+}
+
+static void schedule_periodic(SimRun *run, const ProcessSpec *list, int count, int max_simulation_time, int use_edf) {
+    if (count <= 0) { return; }
+
+    Process *local_list = simctx_alloc(run->arena, count * sizeof(Process));
+    PeriodicTaskState *tasks = simctx_calloc(run->arena, count, sizeof(PeriodicTaskState));
+    RmOrder *order = simctx_alloc(run->arena, count * sizeof(RmOrder));
+    IndexedHeap calendar, ready;
+    if (!local_list || !tasks || !order || !heap_init(&calendar, run->arena, count)) {
+        sim_fail(run, SIM_ERR_MEMORY, "Erro malloc tarefas periódicas\n");
+        simctx_free(run->arena, local_list); simctx_free(run->arena, tasks); simctx_free(run->arena, order);
+        return;
+    }
+    if (!heap_init(&ready, run->arena, count)) {
+        sim_fail(run, SIM_ERR_MEMORY, "Erro malloc tarefas periódicas\n");
+        heap_free(&calendar); simctx_free(run->arena, local_list); simctx_free(run->arena, tasks); simctx_free(run->arena, order);
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        process_bind(&local_list[i], &list[i], run->phases);
+        order[i].period = list[i].period;
+        order[i].idx = i;
+    }
+    // Prioridades RM: menor período = maior prioridade (rank 0).
+    qsort(order, count, sizeof(RmOrder), compare_rm_rank);
+    for (int r = 0; r < count; r++) tasks[order[r].idx].rm_rank = r;
+
+    int capped = 0;
+    long long hyperperiod = compute_hyperperiod(local_list, count, &capped);
+    int max_offset = 0;
+    for (int i = 0; i < count; i++) {
+        if (local_list[i].spec->arrival_time > max_offset) max_offset = local_list[i].spec->arrival_time;
+    }
+    long long horizon_ll = (long long)max_offset + hyperperiod;
+    if (horizon_ll > PERIODIC_HORIZON_CAP) horizon_ll = PERIODIC_HORIZON_CAP;
+    if (max_simulation_time != -1 && max_simulation_time < horizon_ll) horizon_ll = max_simulation_time;
+    int horizon = (int)horizon_ll;
+
+    sim_log(run, "    Hiperperíodo: %lld%s, Horizonte: %d\n", hyperperiod, capped ? " (limitado)" : "", horizon);
+
+    for (int i = 0; i < count; i++) {
+        tasks[i].next_release = local_list[i].spec->arrival_time;
+        tasks[i].response_min = INT_MAX;
+        if (tasks[i].next_release < horizon) heap_push(&calendar, i, tasks[i].next_release, tasks[i].rm_rank);
+    }
+
+    int current_time = (calendar.size > 0) ? (int)heap_peek_key(&calendar) : 0;
+    int total_idle_time = current_time;
+    trace_idle(run->trace, 0, current_time);
+    int total_context_switches = 0;
+    int current_running_idx = -1;
+    int last_process_id = -1;
+
+    Timeline timeline;
+    timeline_init(&timeline, run, count);
+    iodev_reset(&run->io, local_list, count);
+    sim_log(run, "\nTempo | Evento\n");
+    sim_log(run, "------------------------------------------\n");
+
+    sim_state_processes(run, local_list, count);
+    sim_state_bytes(run, tasks, sizeof(PeriodicTaskState) * count);
+    SIM_STATE(run, current_time); SIM_STATE(run, total_idle_time); SIM_STATE(run, total_context_switches);
+    SIM_STATE(run, current_running_idx); SIM_STATE(run, last_process_id);
+    sim_state_heap(run, &calendar); sim_state_heap(run, &ready);
+    if (!sim_state_ready(run)) horizon = current_time;
+    while (current_time < horizon) {
+        STAT_INC(loop_iterations);
+        sim_checkpoint(run, current_time);
+        periodic_release_jobs(run, local_list, tasks, &calendar, &ready, current_time, horizon, use_edf);
+
+        if (current_running_idx != -1 && ready.size > 0) {
+            int best_idx = heap_peek(&ready);
+            PeriodicTaskState *rs = &tasks[current_running_idx];
+            long long best_key = heap_peek_key(&ready);
+            long long run_key = periodic_key(rs, use_edf);
+            STAT_INC(preemption_checks);
+            if (best_key < run_key || (best_key == run_key && tasks[best_idx].rm_rank < rs->rm_rank)) {
+                STAT_INC(preemptions);
+                Process *running_p = &local_list[current_running_idx];
+                sim_log(run, "%-5d | PREEMPÇÃO %s: P%d preempta P%d\n", current_time, use_edf ? "EDF" : "RM",
+                       local_list[best_idx].spec->id, running_p->spec->id);
+                timeline_stop(&timeline, TL_END_PREEMPTED);
+                trace_preemption(run->trace, running_p->spec->id, local_list[best_idx].spec->id, current_time);
+                running_p->state = STATE_READY;
+                periodic_push_ready(&ready, tasks, current_running_idx, use_edf);
+                current_running_idx = -1;
+            }
+        }
+
+        if (current_running_idx == -1) {
+            STAT_PHASE_BEGIN(PHASE_PICK);
+            int best_idx = heap_pop(&ready);
+            STAT_PHASE_END(PHASE_PICK);
+            STAT_INC(picks); STAT_INC(procs_examined);
+            if (best_idx == -1) {
+                int idle_until = (calendar.size > 0) ? (int)heap_peek_key(&calendar) : horizon;
+                if (idle_until > horizon) idle_until = horizon;
+                sim_log(run, "%-5d | CPU Ociosa até t=%d\n", current_time, idle_until);
+                STAT_INC(idle_fastforwards); STAT_ADD(idle_time_skipped, idle_until - current_time);
+                trace_idle(run->trace, current_time, idle_until);
+                total_idle_time += idle_until - current_time;
+                current_time = idle_until;
+                continue;
+            }
+
+            Process *p = &local_list[best_idx];
+            if (run->switch_cost > 0 && last_process_id != p->spec->id && last_process_id != -1) {
+                sim_log(run, "%-5d | Context Switch (P%d to P%d) - Custo: %d\n", current_time, last_process_id, p->spec->id, run->switch_cost);
+                trace_context_switch(run->trace, last_process_id, p->spec->id, current_time, run->switch_cost);
+                series_switch(run->series, current_time, run->switch_cost);
+                current_time += run->switch_cost; total_context_switches++;
+                last_process_id = p->spec->id;
+                periodic_push_ready(&ready, tasks, best_idx, use_edf);
+                continue;
+            }
+
+            current_running_idx = best_idx;
+            p->state = STATE_RUNNING;
+            if (p->start_time == -1) p->start_time = current_time;
+            if (tasks[best_idx].job_start == -1) tasks[best_idx].job_start = current_time;
+            last_process_id = p->spec->id;
+            sim_log(run, "%-5d | P%d job %d (D:%d) executa (R: %d)\n", current_time, p->spec->id,
+                   tasks[best_idx].jobs_completed + 1, tasks[best_idx].job_deadline, tasks[best_idx].job_remaining);
+        }
+
+        Process *p = &local_list[current_running_idx];
+        PeriodicTaskState *ts = &tasks[current_running_idx];
+        long long run_until = (long long)current_time + ts->job_remaining;
+        if (calendar.size > 0 && heap_peek_key(&calendar) < run_until) run_until = heap_peek_key(&calendar);
+        if (run_until > horizon) run_until = horizon;
+        int delta = (int)(run_until - current_time);
+        current_time += delta;
+        ts->job_remaining -= delta;
+        timeline_run(&timeline, p->spec->id, current_time - delta, current_time);
+
+        if (ts->job_remaining == 0) {
+            int response = current_time - ts->job_release;
+            ts->jobs_completed++;
+            series_exit(run->series, current_time, 1);
+            ts->response_sum += response;
+            if (response > ts->response_max) ts->response_max = response;
+            if (response < ts->response_min) ts->response_min = response;
+            int missed = current_time > ts->job_deadline;
+            if (missed) ts->deadline_misses++;
+            class_periodic_job(run, p, ts, current_time, 1, missed);
+            timeline_stop(&timeline, TL_END_FINISHED);
+            sim_log(run, "%-5d | P%d job %d TERMINOU (Resposta: %d%s)\n", current_time, p->spec->id, ts->jobs_completed,
+                   response, missed ? ", DEADLINE PERDIDO" : "");
+            p->finish_time = current_time;
+            current_running_idx = -1;
+
+            if (ts->pending_jobs > 0) {
+                ts->pending_jobs--;
+                periodic_start_job(p, ts, ts->job_release + p->spec->period);
+                p->state = STATE_READY;
+                periodic_push_ready(&ready, tasks, (int)(ts - tasks), use_edf);
+            } else {
+                p->state = (p->spec->period > 0) ? STATE_BLOCKED : STATE_TERMINATED;
+            }
+        }
+    }
+
+    // Jobs ainda por terminar cujo deadline já passou contam como perdidos.
+    for (int i = 0; i < count; i++) {
+        PeriodicTaskState *ts = &tasks[i];
+        int missed = 0;
+        if (ts->job_remaining > 0 && ts->job_deadline <= current_time) missed++;
+        for (int k = 1; k <= ts->pending_jobs; k++) {
+            if (ts->job_deadline + (long long)k * local_list[i].spec->period <= current_time) missed++;
+        }
+        ts->deadline_misses += missed;
+        if (ts->job_remaining > 0) class_periodic_job(run, &local_list[i], ts, current_time, 0, missed);
+    }
+
+    timeline_finish(&timeline);
+    sim_log(run, "------------------------------------------\n");
+    print_periodic_report(run, local_list, tasks, count, current_time, horizon, hyperperiod, total_idle_time, total_context_switches);
+    timeline_report(&timeline, local_list, count);
+    timeline_free(&timeline);
+    heap_free(&calendar);
+    heap_free(&ready);
+    simctx_free(run->arena, order);
+    simctx_free(run->arena, tasks);
+    simctx_free(run->arena, local_list);
+}
+
+
+// ---------------------- Controlo de Admissão EDF ----------------------
+typedef struct {
+    int mode;
+    AdmissionTree tree;
+    int *deferred;
+    int deferred_count;
+    int admitted;
+    int rejected;
+    int deferred_total;
+    int deferred_admitted;
+} EdfAdmission;
+
+static int edf_admission_init(SimRun *run, EdfAdmission *ac, Process *local_list, int count, int mode) {
+    ac->mode = mode;
+    ac->deferred_count = 0;
+    ac->admitted = 0;
+    ac->rejected = 0;
+    ac->deferred_total = 0;
+    ac->deferred_admitted = 0;
+    ac->deferred = simctx_alloc(run->arena, sizeof(int) * count);
+    if (!ac->deferred) return 0;
+    if (!admission_init(&ac->tree, run->arena, local_list, count)) { simctx_free(run->arena, ac->deferred); return 0; }
+    return 1;
+}
+
+static void edf_admission_free(SimRun *run, EdfAdmission *ac) {
+    admission_free(&ac->tree);
+    simctx_free(run->arena, ac->deferred);
+}
+
+static void edf_admission_reject(SimRun *run, Process *p, int current_time) {
+    sim_log(run, "        Admissão: P%d REJEITADO at time %d (D:%d)\n", p->spec->id, current_time, p->spec->deadline);
+    p->state = STATE_TERMINATED;
+    p->admission_rejected = 1;
+    process_exit(run, p, current_time);
+}
+
+// Procura que falta a um job até ao seu deadline: o CPU restante, 2 trocas
+// de contexto (entrada e regresso ao preemptado, como em analysis.c) e as
+// fases de I/O conhecidas que ainda tem pela frente, contadas como se
+// ocupassem o processador (análise que ignora a suspensão). Terminado o CPU,
+// o I/O terminal já não compete com os outros jobs.
+static long long edf_admission_demand(const SimRun *run, const Process *p) {
+    if (p->remaining_time <= 0) return 0;
+    long long demand = (long long)p->remaining_time + 2LL * run->switch_cost;
+    for (int k = p->phase_next; k < p->spec->phase_count; k++) demand += p->phases[k].io;
+    return demand;
+}
+
+// Testa a admissão do processo idx no instante atual. Devolve 1 se admitido.
+static int edf_admission_try(const SimRun *run, EdfAdmission *ac, Process *local_list, int idx, int current_time) {
+    Process *p = &local_list[idx];
+    if (!admission_has_deadline(&ac->tree, idx)) return 1;
+    long long demand = edf_admission_demand(run, p);
+    if (current_time + demand <= p->spec->deadline) {
+        admission_charge(&ac->tree, idx, demand);
+        if (admission_feasible(&ac->tree, current_time)) return 1;
+        admission_charge(&ac->tree, idx, 0);
+    }
+    return 0;
+}
+
+// Substitui check_new_arrivals no EDF quando o controlo de admissão está ativo.
+// Devolve o número de processos rejeitados (contam como concluídos para o ciclo).
+static int edf_check_new_arrivals(SimRun *run, Process *local_list, const ActiveSet *active, int current_time, EdfAdmission *ac) {
+    if (!ac) {
+        (void)check_new_arrivals(run, local_list, active, current_time);
+        return 0;
+    }
+    int rejected = 0;
+    STAT_INC(arrival_checks);
+    STAT_PHASE_BEGIN(PHASE_ARRIVAL_CHECKS);
+    for (int k = 0; k < active->size; k++) {
+        int i = active->idx[k];
+        Process *p = &local_list[i];
+        if (p->state != STATE_NEW || p->spec->arrival_time > current_time) continue;
+        STAT_INC(arrivals_fired);
+        sim_log(run, "        Arrival: P%d at time %d\n", p->spec->id, current_time);
+        trace_arrival(run->trace, p->spec->id, current_time);
+        series_arrival(run->series, current_time);
+        if (edf_admission_try(run, ac, local_list, i, current_time)) {
+            ac->admitted++;
+            p->state = STATE_READY;
+            p->time_in_ready_queue = 0;
+        } else if (ac->mode == ADMISSION_DEFER && p->spec->deadline > current_time) {
+            sim_log(run, "        Admissão: P%d ADIADO at time %d (D:%d)\n", p->spec->id, current_time, p->spec->deadline);
+            p->state = STATE_DEFERRED;
+            series_defer_begin(run->series, current_time);
+            ac->deferred[ac->deferred_count++] = i;
+            ac->deferred_total++;
+        } else {
+            edf_admission_reject(run, p, current_time);
+            ac->rejected++;
+            rejected++;
+        }
+    }
+    STAT_PHASE_END(PHASE_ARRIVAL_CHECKS);
+    return rejected;
+}
+
+// Volta a testar os processos adiados (após conclusões ou com a CPU ociosa).
+static int edf_retry_deferred(SimRun *run, Process *local_list, int current_time, EdfAdmission *ac) {
+    if (!ac) return 0;
+    int rejected = 0;
+    int kept = 0;
+    for (int k = 0; k < ac->deferred_count; k++) {
+        int idx = ac->deferred[k];
+        Process *p = &local_list[idx];
+        if (edf_admission_try(run, ac, local_list, idx, current_time)) {
+            sim_log(run, "        Admissão: P%d (adiado) ADMITIDO at time %d\n", p->spec->id, current_time);
+            ac->admitted++;
+            ac->deferred_admitted++;
+            series_defer_end(run->series, current_time);
+            p->state = STATE_READY;
+            p->time_in_ready_queue = 0;
+        } else if (current_time + edf_admission_demand(run, p) > p->spec->deadline) {
+            series_defer_end(run->series, current_time);
+            edf_admission_reject(run, p, current_time);
+            ac->rejected++;
+            rejected++;
+        } else {
+            ac->deferred[kept++] = idx;
+        }
+    }
+    ac->deferred_count = kept;
+    return rejected;
+}
+
+static void print_admission_report(SimRun *run, Process *local_list, int count, const EdfAdmission *ac) {
+    int admitted_done = 0, admitted_misses = 0;
+    for (int i = 0; i < count; i++) {
+        if (local_list[i].admission_rejected || local_list[i].finish_time == -1) continue;
+        admitted_done++;
+        if (local_list[i].spec->deadline > 0 && local_list[i].finish_time > local_list[i].spec->deadline) admitted_misses++;
+    }
+    int offered = ac->admitted + ac->rejected + ac->deferred_count;
+    sim_log(run, "\n--- Controlo de Admissão EDF (%s) ---\n", ac->mode == ADMISSION_DEFER ? "defer" : "reject");
+    sim_log(run, "Processos Oferecidos:          %d\n", offered);
+    sim_log(run, "Admitidos:                     %d\n", ac->admitted);
+    sim_log(run, "Rejeitados:                    %d\n", ac->rejected);
+    if (ac->mode == ADMISSION_DEFER) {
+        sim_log(run, "Adiados (total / admitidos):   %d / %d\n", ac->deferred_total, ac->deferred_admitted);
+        sim_log(run, "Ainda Adiados no Fim:          %d\n", ac->deferred_count);
+    }
+    sim_log(run, "Taxa de Rejeição:              %.2f %%\n", offered > 0 ? 100.0 * ac->rejected / offered : 0.0);
+    sim_log(run, "Deadlines Perdidos (admitidos):%d de %d completos\n", admitted_misses, admitted_done);
+    sim_log(run, "Taxa de Perda (admitidos):     %.2f %%\n", admitted_done > 0 ? 100.0 * admitted_misses / admitted_done : 0.0);
+    sim_log(run, "--------------------------------------------------\n");
+}
+
 // ---------------------- EDF (Preemptive) ----------------------
-void schedule_edf_preemptive(Process *list, int count, int max_simulation_time) {
-    printf("\n--- EDF (Earliest Deadline First - Preemptive) ---\n");
-    if (max_simulation_time != -1) printf("Tempo Máximo de Simulação: %d\n", max_simulation_time);
-    printf("Custo Troca de Contexto: %d\n", CONTEXT_SWITCH_COST);
+void schedule_edf_preemptive(SimRun *run, const ProcessSpec *list, int count, int admission_mode, int max_simulation_time) {
+    sim_log(run, "\n--- EDF (Earliest Deadline First - Preemptive) ---\n");
+    if (max_simulation_time != -1) sim_log(run, "Tempo Máximo de Simulação: %d\n", max_simulation_time);
+    sim_log(run, "Custo Troca de Contexto: %d\n", run->switch_cost);
     if (count <= 0) { return; }
 
-    Process *local_list = malloc(count * sizeof(Process));
-    if (!local_list) { return; }
+    if (has_periodic_tasks(list, count)) {
+        sim_log(run, "    (Modelo periódico: jobs a cada 'period', deadline absoluto = release + D)\n");
+        if (admission_mode != ADMISSION_NONE) sim_log(run, "    (Controlo de admissão aplica-se apenas a jobs aperiódicos)\n");
+        schedule_periodic(run, list, count, max_simulation_time, 1);
+        return;
+    }
+
+    Process *local_list = simctx_alloc(run->arena, count * sizeof(Process));
+    if (!local_list) { sim_fail(run, SIM_ERR_MEMORY, "Erro malloc EDF\n"); return; }
     for(int i=0; i<count; i++) {
-        local_list[i] = list[i];
-        initialize_process_state(&local_list[i]);
+        process_bind(&local_list[i], &list[i], run->phases);
+    }
+    ActiveSet active;
+    if (!active_init(&active, run->arena, count)) { sim_fail(run, SIM_ERR_MEMORY, "Erro malloc EDF\n"); simctx_free(run->arena, local_list); return; }
+
+    EdfAdmission admission_state;
+    EdfAdmission *admission = NULL;
+    if (admission_mode != ADMISSION_NONE) {
+        if (!edf_admission_init(run, &admission_state, local_list, count, admission_mode)) {
+            sim_fail(run, SIM_ERR_MEMORY, "Erro malloc controlo de admissão\n");
+            simctx_free(run->arena, local_list);
+            return;
+        }
+        admission = &admission_state;
+        sim_log(run, "    (Controlo de Admissão: %s)\n", admission_mode == ADMISSION_DEFER ? "adiar" : "rejeitar");
+        if (run->io.count > 0) {
+            sim_log(run, "    (Com dispositivos de I/O partilhados a espera nas filas não é prevista:\n"
+                         "     a admissão deixa de garantir os deadlines dos admitidos)\n");
+        }
     }
 
     int current_time = 0;
@@ -962,29 +2386,54 @@ void schedule_edf_preemptive(Process *list, int count, int max_simulation_time)
     current_time = find_min_arrival_time(local_list, count);
     if (current_time > 0) {
         total_idle_time = current_time;
+        trace_idle(run->trace, 0, current_time);
     }
 
-    printf("\nTempo | Evento\n");
-    printf("------------------------------------------\n");
-
+    Timeline timeline;
+    timeline_init(&timeline, run, count);
+    iodev_reset(&run->io, local_list, count);
+    sim_log(run, "\nTempo | Evento\n");
+    sim_log(run, "------------------------------------------\n");
+
+    sim_state_processes(run, local_list, count);
+    SIM_STATE(run, current_time); SIM_STATE(run, completed_count); SIM_STATE(run, total_idle_time);
+    SIM_STATE(run, total_context_switches); SIM_STATE(run, current_running_idx); SIM_STATE(run, last_process_id);
+    if (admission) {
+        AdmissionTree *tree = &admission->tree;
+        SIM_STATE(run, admission->deferred_count); SIM_STATE(run, admission->admitted);
+        SIM_STATE(run, admission->rejected); SIM_STATE(run, admission->deferred_total);
+        SIM_STATE(run, admission->deferred_admitted);
+        sim_state_bytes(run, admission->deferred, sizeof(int) * count);
+        sim_state_bytes(run, tree->charged, sizeof(long long) * count);
+        sim_state_bytes(run, tree->sum, sizeof(long long) * 4 * tree->leaves);
+        sim_state_bytes(run, tree->best, sizeof(long long) * 4 * tree->leaves);
+    }
+    if (!sim_state_ready(run)) max_simulation_time = current_time;
      while (completed_count < count && (max_simulation_time == -1 || current_time < max_simulation_time)) {
-        (void)check_new_arrivals(local_list, count, current_time);
-        (void)check_io_completions(local_list, count, current_time);
+         STAT_INC(loop_iterations);
+         sim_checkpoint(run, current_time);
+         active_compact(&active, local_list, completed_count);
+        completed_count += edf_check_new_arrivals(run, local_list, &active, current_time, admission);
+        (void)check_io_completions(run, local_list, &active, current_time);
 
         int earliest_deadline_idx = -1;
         int min_deadline = INT_MAX;
-         for (int i = 0; i < count; i++) {
-             if (local_list[i].state == STATE_READY && local_list[i].finish_time == -1 && local_list[i].arrival_time <= current_time) {
-                if (local_list[i].deadline < min_deadline) {
-                    min_deadline = local_list[i].deadline;
+        STAT_INC(picks); STAT_ADD(procs_examined, active.size);
+        STAT_PHASE_BEGIN(PHASE_PICK);
+         for (int k = 0; k < active.size; k++) {
+             int i = active.idx[k];
+             if (local_list[i].state == STATE_READY && local_list[i].finish_time == -1 && local_list[i].spec->arrival_time <= current_time) {
+                if (local_list[i].spec->deadline < min_deadline) {
+                    min_deadline = local_list[i].spec->deadline;
                     earliest_deadline_idx = i;
-                } else if (local_list[i].deadline == min_deadline) {
-                     if (earliest_deadline_idx == -1 || local_list[i].arrival_time < local_list[earliest_deadline_idx].arrival_time) {
+                } else if (local_list[i].spec->deadline == min_deadline) {
+                     if (earliest_deadline_idx == -1 || local_list[i].spec->arrival_time < local_list[earliest_deadline_idx].spec->arrival_time) {
                         earliest_deadline_idx = i;
                     }
                 }
             }
         }
+        STAT_PHASE_END(PHASE_PICK);
 
         int preemption_occurred = 0;
 
@@ -994,78 +2443,88 @@ void schedule_edf_preemptive(Process *list, int count, int max_simulation_time)
             if (current_running_idx == -1) {
                  current_running_idx = earliest_deadline_idx; Process *p = next_p;
 
-                 if (CONTEXT_SWITCH_COST > 0 && last_process_id != p->id && last_process_id != -1) {
+                 if (run->switch_cost > 0 && last_process_id != p->spec->id && last_process_id != -1) {
                       char from_str[10];
                       if (last_process_id == -1) strcpy(from_str, "Idle"); else snprintf(from_str, sizeof(from_str), "P%d", last_process_id);
-                      printf("%-5d | Context Switch (%s to P%d) - Custo: %d\n", current_time, from_str, p->id, CONTEXT_SWITCH_COST);
-                      current_time += CONTEXT_SWITCH_COST; total_context_switches++;
-                      (void)check_new_arrivals(local_list, count, current_time); (void)check_io_completions(local_list, count, current_time);
+                      sim_log(run, "%-5d | Context Switch (%s to P%d) - Custo: %d\n", current_time, from_str, p->spec->id, run->switch_cost);
+                      trace_context_switch(run->trace, last_process_id, p->spec->id, current_time, run->switch_cost);
+                      series_switch(run->series, current_time, run->switch_cost);
+                      current_time += run->switch_cost; total_context_switches++;
+                      completed_count += edf_check_new_arrivals(run, local_list, &active, current_time, admission); (void)check_io_completions(run, local_list, &active, current_time);
                       if (max_simulation_time != -1 && current_time >= max_simulation_time) break;
                        int current_best_idx = -1; min_deadline = INT_MAX;
-                       for (int i = 0; i < count; i++) {
-                           if (local_list[i].state == STATE_READY && local_list[i].finish_time == -1 && local_list[i].arrival_time <= current_time) {
-                              if (local_list[i].deadline < min_deadline) { min_deadline = local_list[i].deadline; current_best_idx = i; }
-                              else if (local_list[i].deadline == min_deadline) {
-                                   if (current_best_idx == -1 || local_list[i].arrival_time < local_list[current_best_idx].arrival_time) { current_best_idx = i;}
+                       STAT_INC(picks); STAT_ADD(procs_examined, active.size);
+                       STAT_PHASE_BEGIN(PHASE_PICK);
+                       for (int k = 0; k < active.size; k++) {
+                           int i = active.idx[k];
+                           if (local_list[i].state == STATE_READY && local_list[i].finish_time == -1 && local_list[i].spec->arrival_time <= current_time) {
+                              if (local_list[i].spec->deadline < min_deadline) { min_deadline = local_list[i].spec->deadline; current_best_idx = i; }
+                              else if (local_list[i].spec->deadline == min_deadline) {
+                                   if (current_best_idx == -1 || local_list[i].spec->arrival_time < local_list[current_best_idx].spec->arrival_time) { current_best_idx = i;}
                               }
                           }
                        }
+                       STAT_PHASE_END(PHASE_PICK);
                       if(current_best_idx == -1) { current_running_idx = -1; goto check_idle_edf;}
                       current_running_idx = current_best_idx; p = &local_list[current_running_idx];
                  }
 
                  p->state = STATE_RUNNING;
                  if (p->start_time == -1) p->start_time = current_time;
-                 last_process_id = p->id;
-                 printf("%-5d | P%d (Deadl: %d) inicia execução (R: %d)\n", current_time, p->id, p->deadline, p->remaining_time);
+                 last_process_id = p->spec->id;
+                 sim_log(run, "%-5d | P%d (Deadl: %d) inicia execução (R: %d)\n", current_time, p->spec->id, p->spec->deadline, p->remaining_time);
 
             } else {
                  Process *running_p = &local_list[current_running_idx];
+                 STAT_INC(preemption_checks);
                  if (earliest_deadline_idx != current_running_idx &&
-                     (next_p->deadline < running_p->deadline || (next_p->deadline == running_p->deadline && next_p->arrival_time < running_p->arrival_time)))
+                     (next_p->spec->deadline < running_p->spec->deadline || (next_p->spec->deadline == running_p->spec->deadline && next_p->spec->arrival_time < running_p->spec->arrival_time)))
                  {
                      preemption_occurred = 1;
-                     printf("%-5d | PREEMPÇÃO EDF: P%d (D:%d) preempta P%d (D:%d)\n",
-                             current_time, next_p->id, next_p->deadline, running_p->id, running_p->deadline);
+                     STAT_INC(preemptions);
+                     sim_log(run, "%-5d | PREEMPÇÃO EDF: P%d (D:%d) preempta P%d (D:%d)\n",
+                             current_time, next_p->spec->id, next_p->spec->deadline, running_p->spec->id, running_p->spec->deadline);
+                     timeline_stop(&timeline, TL_END_PREEMPTED);
+                     trace_preemption(run->trace, running_p->spec->id, next_p->spec->id, current_time);
 
-                      if (running_p->io_burst_duration > 0 && (rand() % 5 == 0)) {
-                          printf("        P%d preemptido iniciando I/O (%d unidades)\n", running_p->id, running_p->io_burst_duration);
-                          running_p->state = STATE_BLOCKED; running_p->io_completion_time = current_time + running_p->io_burst_duration;
-                      } else { running_p->state = STATE_READY; }
+                      running_p->state = STATE_READY;
 
                       current_running_idx = earliest_deadline_idx; Process *p = next_p;
 
-                      if (CONTEXT_SWITCH_COST > 0) {
-                         printf("%-5d | Context Switch (P%d to P%d) - Custo: %d\n", current_time, running_p->id, p->id, CONTEXT_SWITCH_COST);
-                         current_time += CONTEXT_SWITCH_COST; total_context_switches++;
-                         (void)check_new_arrivals(local_list, count, current_time); (void)check_io_completions(local_list, count, current_time);
+                      if (run->switch_cost > 0) {
+                         sim_log(run, "%-5d | Context Switch (P%d to P%d) - Custo: %d\n", current_time, running_p->spec->id, p->spec->id, run->switch_cost);
+                         trace_context_switch(run->trace, running_p->spec->id, p->spec->id, current_time, run->switch_cost);
+                         series_switch(run->series, current_time, run->switch_cost);
+                         current_time += run->switch_cost; total_context_switches++;
+                         completed_count += edf_check_new_arrivals(run, local_list, &active, current_time, admission); (void)check_io_completions(run, local_list, &active, current_time);
                          if (max_simulation_time != -1 && current_time >= max_simulation_time) { running_p->state = STATE_READY; current_running_idx = -1; break; }
                          int current_best_idx = -1; min_deadline = INT_MAX;
-                         for (int i = 0; i < count; i++) {
-                             if (local_list[i].state == STATE_READY && local_list[i].finish_time == -1 && local_list[i].arrival_time <= current_time) {
-                                if (local_list[i].deadline < min_deadline) { min_deadline = local_list[i].deadline; current_best_idx = i; }
-                                else if (local_list[i].deadline == min_deadline) {
-                                     if (current_best_idx == -1 || local_list[i].arrival_time < local_list[current_best_idx].arrival_time) { current_best_idx = i;}
+                         STAT_INC(picks); STAT_ADD(procs_examined, active.size);
+                         STAT_PHASE_BEGIN(PHASE_PICK);
+                         for (int k = 0; k < active.size; k++) {
+                             int i = active.idx[k];
+                             if (local_list[i].state == STATE_READY && local_list[i].finish_time == -1 && local_list[i].spec->arrival_time <= current_time) {
+                                if (local_list[i].spec->deadline < min_deadline) { min_deadline = local_list[i].spec->deadline; current_best_idx = i; }
+                                else if (local_list[i].spec->deadline == min_deadline) {
+                                     if (current_best_idx == -1 || local_list[i].spec->arrival_time < local_list[current_best_idx].spec->arrival_time) { current_best_idx = i;}
                                 }
                             }
                          }
+                         STAT_PHASE_END(PHASE_PICK);
                          if (current_best_idx == -1) { current_running_idx = -1; goto check_idle_edf; }
                          current_running_idx = current_best_idx; p = &local_list[current_running_idx];
                       }
 
                       p->state = STATE_RUNNING;
                       if (p->start_time == -1) p->start_time = current_time;
-                      last_process_id = p->id;
-                      printf("%-5d | P%d (Deadl: %d) inicia execução PREEMPTIVA (R: %d)\n", current_time, p->id, p->deadline, p->remaining_time);
+                      last_process_id = p->spec->id;
+                      sim_log(run, "%-5d | P%d (Deadl: %d) inicia execução PREEMPTIVA (R: %d)\n", current_time, p->spec->id, p->spec->deadline, p->remaining_time);
                  }
             }
         } else {
-             if (current_running_idx != -1) {
-                 last_process_id = local_list[current_running_idx].id;
-                 current_running_idx = -1;
-             }
              int all_accounted = 1;
-             for(int i=0; i<count; ++i) {
+             for (int k = 0; k < active.size; k++) {
+                 int i = active.idx[k];
                   if(local_list[i].state != STATE_TERMINATED && local_list[i].state != STATE_BLOCKED && local_list[i].state != STATE_NEW) {
                       if(local_list[i].state == STATE_READY && local_list[i].finish_time == -1) {
                           all_accounted = 0; break;
@@ -1085,41 +2544,49 @@ void schedule_edf_preemptive(Process *list, int count, int max_simulation_time)
              }
 
              current_time++; p->remaining_time--;
-             printf("        P%d executa (R:%d)\n", p->id, p->remaining_time);
+             timeline_run(&timeline, p->spec->id, current_time - 1, current_time);
+             if (admission) admission_charge(&admission->tree, current_running_idx, edf_admission_demand(run, p));
 
-             (void)check_new_arrivals(local_list, count, current_time);
-             (void)check_io_completions(local_list, count, current_time);
+             completed_count += edf_check_new_arrivals(run, local_list, &active, current_time, admission);
+             (void)check_io_completions(run, local_list, &active, current_time);
 
              int process_stopped = 0;
              if (p->remaining_time == 0) {
-                 printf("%-5d | P%d TERMINOU CPU Burst\n", current_time, p->id);
+                 timeline_stop(&timeline, TL_END_FINISHED);
+                 process_burst_done(p, current_time);
+                 sim_log(run, "%-5d | P%d TERMINOU CPU Burst\n", current_time, p->spec->id);
                  p->state = STATE_TERMINATED;
                  p->finish_time = current_time;
                  completed_count++;
-                  if (p->io_burst_duration > 0) {
-                       printf("        P%d iniciando I/O (%d unidades) apos termino do burst\n", p->id, p->io_burst_duration);
-                       p->state = STATE_BLOCKED; p->io_completion_time = current_time + p->io_burst_duration;
+                  if (p->spec->io_burst_duration > 0) {
+                       sim_log(run, "        P%d iniciando I/O (%d unidades) apos termino do burst\n", p->spec->id, p->spec->io_burst_duration);
+                       iodev_submit(&run->io, p, current_time, p->spec->io_burst_duration, NULL);
                   }
+                  report_if_terminated(run, p);
+                 process_stopped = 1;
+             } else if (process_io_due(p, current_time)) {
+                 timeline_stop(&timeline, TL_END_IO);
+                 sim_log(run, "%-5d | P%d iniciando I/O (%d unidades) durante execução\n", current_time, p->spec->id, p->io_pending_duration);
+                 iodev_submit(&run->io, p, current_time, p->io_pending_duration, NULL);
                  process_stopped = 1;
-             } else {
-                  if (p->io_burst_duration > 0 && p->burst_time > 1 && (rand() % (p->burst_time * 2) < 1)) {
-                       printf("%-5d | P%d iniciando I/O (%d unidades) durante execução\n", current_time, p->id, p->io_burst_duration);
-                       p->state = STATE_BLOCKED; p->io_completion_time = current_time + p->io_burst_duration;
-                       process_stopped = 1;
-                 }
              }
 
              if(process_stopped) {
-                last_process_id = p->id;
+                last_process_id = p->spec->id;
                 current_running_idx = -1;
+                if (p->remaining_time == 0) completed_count += edf_retry_deferred(run, local_list, current_time, admission);
              }
         } else if (current_running_idx == -1) {
         check_idle_edf:
+              if (admission && admission->deferred_count > 0) {
+                  completed_count += edf_retry_deferred(run, local_list, current_time, admission);
+              }
               int next_event_time = INT_MAX;
               int has_ready_process = 0;
-              for(int i=0; i<count; i++) {
+              for (int k = 0; k < active.size; k++) {
+                  int i = active.idx[k];
                   if(local_list[i].state == STATE_READY && local_list[i].finish_time == -1) has_ready_process = 1;
-                  if (local_list[i].state == STATE_NEW && local_list[i].arrival_time < next_event_time) next_event_time = local_list[i].arrival_time;
+                  if (local_list[i].state == STATE_NEW && local_list[i].spec->arrival_time < next_event_time) next_event_time = local_list[i].spec->arrival_time;
                   if (local_list[i].state == STATE_BLOCKED && local_list[i].io_completion_time < next_event_time) next_event_time = local_list[i].io_completion_time;
               }
 
@@ -1129,56 +2596,81 @@ void schedule_edf_preemptive(Process *list, int count, int max_simulation_time)
               if (next_event_time == INT_MAX || (max_simulation_time != -1 && next_event_time >= max_simulation_time)) {
                   idle_until = (max_simulation_time != -1) ? max_simulation_time : current_time;
                   if(idle_until <= current_time) { break; }
-                  printf("%-5d | CPU Ociosa até %d (Fim da Simulação ou Sem Eventos)\n", current_time, idle_until);
+                  sim_log(run, "%-5d | CPU Ociosa até %d (Fim da Simulação ou Sem Eventos)\n", current_time, idle_until);
                    if (next_event_time == INT_MAX && completed_count >= count) break;
               } else {
                   idle_until = next_event_time;
-                  printf("%-5d | CPU Ociosa até t=%d (Próximo evento)\n", current_time, idle_until);
+                  sim_log(run, "%-5d | CPU Ociosa até t=%d (Próximo evento)\n", current_time, idle_until);
               }
 
               if(idle_until > current_time) {
+                  STAT_INC(idle_fastforwards); STAT_ADD(idle_time_skipped, idle_until - current_time);
+                  trace_idle(run->trace, current_time, idle_until);
                   total_idle_time += (idle_until - current_time);
                   current_time = idle_until;
               }
         }
      }
 
-    printf("------------------------------------------\n");
-    calculate_final_metrics(local_list, count, current_time, total_idle_time, total_context_switches);
-    free(local_list);
+    timeline_finish(&timeline);
+    sim_log(run, "------------------------------------------\n");
+    calculate_final_metrics(run, local_list, count, current_time, total_idle_time, total_context_switches);
+    timeline_report(&timeline, local_list, count);
+    timeline_free(&timeline);
+    if (admission) {
+        SimResults *res = run->results;
+        res->admission_admitted = admission->admitted;
+        res->admission_rejected = admission->rejected;
+        res->admission_deferred = admission->deferred_total;
+        res->admission_deferred_admitted = admission->deferred_admitted;
+        res->admission_deferred_pending = admission->deferred_count;
+        print_admission_report(run, local_list, count, admission);
+        edf_admission_free(run, admission);
+    }
+    active_free(&active);
+    simctx_free(run->arena, local_list);
 }
 
 // ---------------------- RM (Preemptive - baseado em Prioridade) ----------------------
-void schedule_rm_preemptive(Process *list, int count, int max_simulation_time) {
-    printf("\n--- RM (Rate Monotonic - Preemptive, baseado em Prioridade Estática) ---\n");
-    printf("    (Assume que 'priority' reflete a prioridade RM: 1=max, menor período=maior prio)\n");
-    printf("    (Aging Desabilitado por padrão para RM)\n");
+void schedule_rm_preemptive(SimRun *run, const ProcessSpec *list, int count, int max_simulation_time) {
+    if (has_periodic_tasks(list, count)) {
+        sim_log(run, "\n--- RM (Rate Monotonic - Preemptive, prioridades derivadas dos períodos) ---\n");
+        if (max_simulation_time != -1) sim_log(run, "Tempo Máximo de Simulação: %d\n", max_simulation_time);
+        sim_log(run, "Custo Troca de Contexto: %d\n", run->switch_cost);
+        schedule_periodic(run, list, count, max_simulation_time, 0);
+        return;
+    }
 
-     schedule_priority(list, count, 1 , 0 , max_simulation_time);
+    sim_log(run, "\n--- RM (Rate Monotonic - Preemptive, baseado em Prioridade Estática) ---\n");
+    sim_log(run, "    (Assume que 'priority' reflete a prioridade RM: 1=max, menor período=maior prio)\n");
+    sim_log(run, "    (Aging Desabilitado por padrão para RM)\n");
+
+     schedule_priority(run, list, count, 1 , 0 , max_simulation_time);
 
 }
 
 
 // ---------------------- MLQ (Multilevel Queue) ----------------------
-void schedule_mlq(Process *list, int count, int base_quantum, int max_simulation_time) {
-     printf("\n--- MLQ (Multilevel Queue) ---\n");
-     printf("    Q0 (Prio 1,2): RR (q=%d)\n", base_quantum);
-     printf("    Q1 (Prio 3,4): RR (q=%d)\n", base_quantum * 2);
-     printf("    Q2 (Prio 5+):  FCFS\n");
-     printf("    (Preempção entre filas: Q0 > Q1 > Q2)\n");
-     if (max_simulation_time != -1) printf("Tempo Máximo de Simulação: %d\n", max_simulation_time);
-     printf("Custo Troca de Contexto: %d\n", CONTEXT_SWITCH_COST);
-     if (count <= 0 || base_quantum <=0) return;
-
-    Process *local_list = malloc(count * sizeof(Process));
-    if (!local_list) { return; }
+void schedule_mlq(SimRun *run, const ProcessSpec *list, int count, int q0_quantum, int q1_quantum, int max_simulation_time) {
+     sim_log(run, "\n--- MLQ (Multilevel Queue) ---\n");
+     sim_log(run, "    Q0 (Prio 1,2): RR (q=%d)\n", q0_quantum);
+     sim_log(run, "    Q1 (Prio 3,4): RR (q=%d)\n", q1_quantum);
+     sim_log(run, "    Q2 (Prio 5+):  FCFS\n");
+     sim_log(run, "    (Preempção entre filas: Q0 > Q1 > Q2)\n");
+     if (max_simulation_time != -1) sim_log(run, "Tempo Máximo de Simulação: %d\n", max_simulation_time);
+     sim_log(run, "Custo Troca de Contexto: %d\n", run->switch_cost);
+     if (count <= 0 || q0_quantum <= 0 || q1_quantum <= 0) return;
+
+    Process *local_list = simctx_alloc(run->arena, count * sizeof(Process));
+    if (!local_list) { sim_fail(run, SIM_ERR_MEMORY, "Erro malloc MLQ\n"); return; }
     for(int i=0; i<count; i++) {
-        local_list[i] = list[i];
-        initialize_process_state(&local_list[i]);
+        process_bind(&local_list[i], &list[i], run->phases);
         if (list[i].priority <= 2) local_list[i].current_queue = 0;
         else if (list[i].priority <= 4) local_list[i].current_queue = 1;
         else local_list[i].current_queue = 2;
     }
+    ActiveSet active;
+    if (!active_init(&active, run->arena, count)) { sim_fail(run, SIM_ERR_MEMORY, "Erro malloc MLQ\n"); simctx_free(run->arena, local_list); return; }
 
     int current_time = 0;
     int completed_count = 0;
@@ -1192,39 +2684,58 @@ void schedule_mlq(Process *list, int count, int base_quantum, int max_simulation
     current_time = find_min_arrival_time(local_list, count);
     if (current_time > 0) {
         total_idle_time = current_time;
+        trace_idle(run->trace, 0, current_time);
     }
 
-    printf("\nTempo | Evento\n");
-    printf("------------------------------------------\n");
-
+    Timeline timeline;
+    timeline_init(&timeline, run, count);
+    iodev_reset(&run->io, local_list, count);
+    sim_log(run, "\nTempo | Evento\n");
+    sim_log(run, "------------------------------------------\n");
+
+    sim_state_processes(run, local_list, count);
+    SIM_STATE(run, current_time); SIM_STATE(run, completed_count); SIM_STATE(run, total_idle_time);
+    SIM_STATE(run, total_context_switches); SIM_STATE(run, current_running_idx); SIM_STATE(run, last_process_id);
+    SIM_STATE(run, last_checked_q0); SIM_STATE(run, last_checked_q1);
+    SIM_STATE(run, q0_quantum); SIM_STATE(run, q1_quantum);
+    if (!sim_state_ready(run)) max_simulation_time = current_time;
     while (completed_count < count && (max_simulation_time == -1 || current_time < max_simulation_time)) {
-        (void)check_new_arrivals(local_list, count, current_time);
-        (void)check_io_completions(local_list, count, current_time);
+        STAT_INC(loop_iterations);
+        if (sim_checkpoint(run, current_time)) { q0_quantum = run->mlq_quantum[0]; q1_quantum = run->mlq_quantum[1]; }
+        active_compact(&active, local_list, completed_count);
+        (void)check_new_arrivals(run, local_list, &active, current_time);
+        (void)check_io_completions(run, local_list, &active, current_time);
 
         int candidate_idx = -1;
         int candidate_queue = -1;
         int current_quantum = 0;
 
-        int search_start_q0 = (last_checked_q0 + 1);
-        for (int i = 0; i < count; ++i) {
-            int idx = (search_start_q0 + i) % count;
+        STAT_INC(picks);
+        STAT_PHASE_BEGIN(PHASE_PICK);
+        int search_start_q0 = active_after(&active, last_checked_q0);
+        for (int k = 0; k < active.size; ++k) {
+            int idx = active.idx[(search_start_q0 + k) % active.size];
+            STAT_INC(procs_examined);
             if (local_list[idx].state == STATE_READY && local_list[idx].finish_time == -1 && local_list[idx].current_queue == 0) {
-                candidate_idx = idx; candidate_queue = 0; current_quantum = base_quantum; last_checked_q0 = idx;
+                candidate_idx = idx; candidate_queue = 0; current_quantum = q0_quantum; last_checked_q0 = idx;
                 goto process_selected_mlq;
             }
         }
-         int search_start_q1 = (last_checked_q1 + 1);
-         for (int i = 0; i < count; ++i) {
-            int idx = (search_start_q1 + i) % count;
+         int search_start_q1 = active_after(&active, last_checked_q1);
+         for (int k = 0; k < active.size; ++k) {
+            int idx = active.idx[(search_start_q1 + k) % active.size];
+            STAT_INC(procs_examined);
              if (local_list[idx].state == STATE_READY && local_list[idx].finish_time == -1 && local_list[idx].current_queue == 1) {
-                candidate_idx = idx; candidate_queue = 1; current_quantum = base_quantum * 2; last_checked_q1 = idx;
+                candidate_idx = idx; candidate_queue = 1; current_quantum = q1_quantum; last_checked_q1 = idx;
                 goto process_selected_mlq;
             }
         }
          int fcfs_idx = -1;
-         for (int i = 0; i < count; ++i) {
+         STAT_ADD(procs_examined, active.size);
+         for (int k = 0; k < active.size; k++) {
+             int i = active.idx[k];
               if (local_list[i].state == STATE_READY && local_list[i].finish_time == -1 && local_list[i].current_queue == 2) {
-                  if (fcfs_idx == -1 || local_list[i].arrival_time < local_list[fcfs_idx].arrival_time) {
+                  if (fcfs_idx == -1 || local_list[i].spec->arrival_time < local_list[fcfs_idx].spec->arrival_time) {
                        fcfs_idx = i;
                   }
               }
@@ -1236,6 +2747,7 @@ void schedule_mlq(Process *list, int count, int base_quantum, int max_simulation
          }
 
     process_selected_mlq:;
+        STAT_PHASE_END(PHASE_PICK);
 
         int preemption_occurred = 0;
 
@@ -1245,56 +2757,56 @@ void schedule_mlq(Process *list, int count, int base_quantum, int max_simulation
              if (current_running_idx == -1) {
                  current_running_idx = candidate_idx; Process *p = next_p;
 
-                  if (CONTEXT_SWITCH_COST > 0 && last_process_id != p->id && last_process_id != -1) {
+                  if (run->switch_cost > 0 && last_process_id != p->spec->id && last_process_id != -1) {
                      char from_str[10];
                      if (last_process_id == -1) strcpy(from_str, "Idle"); else snprintf(from_str, sizeof(from_str), "P%d", last_process_id);
-                     printf("%-5d | Context Switch (%s to P%d [Q%d]) - Custo: %d\n", current_time, from_str, p->id, candidate_queue, CONTEXT_SWITCH_COST);
-                     current_time += CONTEXT_SWITCH_COST; total_context_switches++;
-                     (void)check_new_arrivals(local_list, count, current_time); (void)check_io_completions(local_list, count, current_time);
+                     sim_log(run, "%-5d | Context Switch (%s to P%d [Q%d]) - Custo: %d\n", current_time, from_str, p->spec->id, candidate_queue, run->switch_cost);
+                     trace_context_switch(run->trace, last_process_id, p->spec->id, current_time, run->switch_cost);
+                     series_switch(run->series, current_time, run->switch_cost);
+                     current_time += run->switch_cost; total_context_switches++;
+                     (void)check_new_arrivals(run, local_list, &active, current_time); (void)check_io_completions(run, local_list, &active, current_time);
                      if (max_simulation_time != -1 && current_time >= max_simulation_time) break;
-                     goto process_selected_mlq;
                   }
 
                  p->state = STATE_RUNNING; p->time_slice_remaining = current_quantum;
                  if (p->start_time == -1) p->start_time = current_time;
-                 last_process_id = p->id;
-                 printf("%-5d | P%d [Q%d] inicia execução (Qtm: %d, R: %d)\n", current_time, p->id, candidate_queue, current_quantum, p->remaining_time);
+                 last_process_id = p->spec->id;
+                 sim_log(run, "%-5d | P%d [Q%d] inicia execução (Qtm: %d, R: %d)\n", current_time, p->spec->id, candidate_queue, current_quantum, p->remaining_time);
 
              } else {
                   Process *running_p = &local_list[current_running_idx];
+                  STAT_INC(preemption_checks);
                   if (candidate_queue < running_p->current_queue) {
                        preemption_occurred = 1;
-                       printf("%-5d | PREEMPÇÃO MLQ: P%d [Q%d] preempta P%d [Q%d]\n",
-                             current_time, next_p->id, candidate_queue, running_p->id, running_p->current_queue);
+                       STAT_INC(preemptions);
+                       sim_log(run, "%-5d | PREEMPÇÃO MLQ: P%d [Q%d] preempta P%d [Q%d]\n",
+                             current_time, next_p->spec->id, candidate_queue, running_p->spec->id, running_p->current_queue);
+                       timeline_stop(&timeline, TL_END_PREEMPTED);
+                       trace_preemption(run->trace, running_p->spec->id, next_p->spec->id, current_time);
 
-                       if (running_p->io_burst_duration > 0 && (rand() % 5 == 0)) {
-                           printf("        P%d preemptido iniciando I/O (%d unidades)\n", running_p->id, running_p->io_burst_duration);
-                           running_p->state = STATE_BLOCKED; running_p->io_completion_time = current_time + running_p->io_burst_duration;
-                       } else { running_p->state = STATE_READY; }
+                       running_p->state = STATE_READY;
 
                        current_running_idx = candidate_idx; Process *p = next_p;
 
-                       if (CONTEXT_SWITCH_COST > 0) {
-                           printf("%-5d | Context Switch (P%d to P%d [Q%d]) - Custo: %d\n", current_time, running_p->id, p->id, candidate_queue, CONTEXT_SWITCH_COST);
-                           current_time += CONTEXT_SWITCH_COST; total_context_switches++;
-                           (void)check_new_arrivals(local_list, count, current_time); (void)check_io_completions(local_list, count, current_time);
+                       if (run->switch_cost > 0) {
+                           sim_log(run, "%-5d | Context Switch (P%d to P%d [Q%d]) - Custo: %d\n", current_time, running_p->spec->id, p->spec->id, candidate_queue, run->switch_cost);
+                           trace_context_switch(run->trace, running_p->spec->id, p->spec->id, current_time, run->switch_cost);
+                           series_switch(run->series, current_time, run->switch_cost);
+                           current_time += run->switch_cost; total_context_switches++;
+                           (void)check_new_arrivals(run, local_list, &active, current_time); (void)check_io_completions(run, local_list, &active, current_time);
                            if (max_simulation_time != -1 && current_time >= max_simulation_time) { running_p->state = STATE_READY; current_running_idx = -1; break; }
-                            goto process_selected_mlq;
                        }
 
                        p->state = STATE_RUNNING; p->time_slice_remaining = current_quantum;
                        if (p->start_time == -1) p->start_time = current_time;
-                       last_process_id = p->id;
-                       printf("%-5d | P%d [Q%d] inicia PREEMPTIVA (Qtm: %d, R: %d)\n", current_time, p->id, candidate_queue, current_quantum, p->remaining_time);
+                       last_process_id = p->spec->id;
+                       sim_log(run, "%-5d | P%d [Q%d] inicia PREEMPTIVA (Qtm: %d, R: %d)\n", current_time, p->spec->id, candidate_queue, current_quantum, p->remaining_time);
                   }
              }
         } else {
-             if (current_running_idx != -1) {
-                 last_process_id = local_list[current_running_idx].id;
-                 current_running_idx = -1;
-             }
               int all_accounted = 1;
-              for(int i=0; i<count; ++i) {
+              for (int k = 0; k < active.size; k++) {
+                  int i = active.idx[k];
                    if(local_list[i].state != STATE_TERMINATED && local_list[i].state != STATE_BLOCKED && local_list[i].state != STATE_NEW) {
                        if(local_list[i].state == STATE_READY && local_list[i].finish_time == -1) {
                            all_accounted = 0; break;
@@ -1314,52 +2826,53 @@ void schedule_mlq(Process *list, int count, int base_quantum, int max_simulation
             }
 
             current_time++; p->remaining_time--;
+            timeline_run(&timeline, p->spec->id, current_time - 1, current_time);
             if (p->current_queue < 2) {
                 p->time_slice_remaining--;
             }
-            printf("        P%d [Q%d] executa (R:%d, Q:%d)\n", p->id, p->current_queue, p->remaining_time, p->time_slice_remaining);
 
-             (void)check_new_arrivals(local_list, count, current_time);
-             (void)check_io_completions(local_list, count, current_time);
+             (void)check_new_arrivals(run, local_list, &active, current_time);
+             (void)check_io_completions(run, local_list, &active, current_time);
 
 
             int process_stopped = 0;
             if (p->remaining_time == 0) {
-                 printf("%-5d | P%d [Q%d] TERMINOU CPU Burst\n", current_time, p->id, p->current_queue);
+                 timeline_stop(&timeline, TL_END_FINISHED);
+                 process_burst_done(p, current_time);
+                 sim_log(run, "%-5d | P%d [Q%d] TERMINOU CPU Burst\n", current_time, p->spec->id, p->current_queue);
                  p->state = STATE_TERMINATED;
                  p->finish_time = current_time;
                  completed_count++;
-                  if (p->io_burst_duration > 0) {
-                       printf("        P%d iniciando I/O (%d unidades) apos termino do burst\n", p->id, p->io_burst_duration);
-                       p->state = STATE_BLOCKED; p->io_completion_time = current_time + p->io_burst_duration;
+                  if (p->spec->io_burst_duration > 0) {
+                       sim_log(run, "        P%d iniciando I/O (%d unidades) apos termino do burst\n", p->spec->id, p->spec->io_burst_duration);
+                       iodev_submit(&run->io, p, current_time, p->spec->io_burst_duration, NULL);
                   }
+                  report_if_terminated(run, p);
+                 process_stopped = 1;
+            } else if (process_io_due(p, current_time)) {
+                 timeline_stop(&timeline, TL_END_IO);
+                 sim_log(run, "%-5d | P%d [Q%d] iniciando I/O (%d unidades) durante execução\n", current_time, p->spec->id, p->current_queue, p->io_pending_duration);
+                 iodev_submit(&run->io, p, current_time, p->io_pending_duration, NULL);
                  process_stopped = 1;
             } else if (p->current_queue < 2 && p->time_slice_remaining == 0) {
-                 printf("%-5d | P%d [Q%d] fim do quantum, volta para READY\n", current_time, p->id, p->current_queue);
-                 if (p->io_burst_duration > 0 && (rand() % 3 == 0)) {
-                      printf("        P%d iniciando I/O (%d unidades) no fim do quantum\n", p->id, p->io_burst_duration);
-                      p->state = STATE_BLOCKED; p->io_completion_time = current_time + p->io_burst_duration;
-                 } else { p->state = STATE_READY; }
+                 timeline_stop(&timeline, TL_END_QUANTUM);
+                 sim_log(run, "%-5d | P%d [Q%d] fim do quantum, volta para READY\n", current_time, p->spec->id, p->current_queue);
+                 p->state = STATE_READY;
                  process_stopped = 1;
-            } else {
-                 if (p->io_burst_duration > 0 && p->burst_time > 1 && (rand() % (p->burst_time * 3) < 1)) {
-                       printf("%-5d | P%d [Q%d] iniciando I/O (%d unidades) durante execução\n", current_time, p->id, p->current_queue, p->io_burst_duration);
-                       p->state = STATE_BLOCKED; p->io_completion_time = current_time + p->io_burst_duration;
-                       process_stopped = 1;
-                 }
             }
 
             if(process_stopped) {
-               last_process_id = p->id;
+               last_process_id = p->spec->id;
                current_running_idx = -1;
             }
 
         } else if (current_running_idx == -1) {
              int next_event_time = INT_MAX;
              int has_ready_process = 0;
-              for(int i=0; i<count; i++) {
+              for (int k = 0; k < active.size; k++) {
+                  int i = active.idx[k];
                   if(local_list[i].state == STATE_READY && local_list[i].finish_time == -1) has_ready_process = 1;
-                  if (local_list[i].state == STATE_NEW && local_list[i].arrival_time < next_event_time) next_event_time = local_list[i].arrival_time;
+                  if (local_list[i].state == STATE_NEW && local_list[i].spec->arrival_time < next_event_time) next_event_time = local_list[i].spec->arrival_time;
                   if (local_list[i].state == STATE_BLOCKED && local_list[i].io_completion_time < next_event_time) next_event_time = local_list[i].io_completion_time;
               }
 
@@ -1369,21 +2882,27 @@ void schedule_mlq(Process *list, int count, int base_quantum, int max_simulation
               if (next_event_time == INT_MAX || (max_simulation_time != -1 && next_event_time >= max_simulation_time)) {
                   idle_until = (max_simulation_time != -1) ? max_simulation_time : current_time;
                   if(idle_until <= current_time) { break; }
-                  printf("%-5d | CPU Ociosa até %d (Fim da Simulação ou Sem Eventos)\n", current_time, idle_until);
+                  sim_log(run, "%-5d | CPU Ociosa até %d (Fim da Simulação ou Sem Eventos)\n", current_time, idle_until);
                    if (next_event_time == INT_MAX && completed_count >= count) break;
               } else {
                   idle_until = next_event_time;
-                  printf("%-5d | CPU Ociosa até t=%d (Próximo evento)\n", current_time, idle_until);
+                  sim_log(run, "%-5d | CPU Ociosa até t=%d (Próximo evento)\n", current_time, idle_until);
               }
 
               if(idle_until > current_time) {
+                  STAT_INC(idle_fastforwards); STAT_ADD(idle_time_skipped, idle_until - current_time);
+                  trace_idle(run->trace, current_time, idle_until);
                   total_idle_time += (idle_until - current_time);
                   current_time = idle_until;
               }
         }
     }
 
-    printf("------------------------------------------\n");
-    calculate_final_metrics(local_list, count, current_time, total_idle_time, total_context_switches);
-    free(local_list);
+    timeline_finish(&timeline);
+    sim_log(run, "------------------------------------------\n");
+    calculate_final_metrics(run, local_list, count, current_time, total_idle_time, total_context_switches);
+    timeline_report(&timeline, local_list, count);
+    timeline_free(&timeline);
+    active_free(&active);
+    simctx_free(run->arena, local_list);
 }
@@ -2,19 +2,25 @@
 #define SCHEDULER_H
 
 #include "process.h"
+#include "sim.h"
 
+// Valores por omissão de SimConfig (--cs, --aging, --aging-interval).
 #define CONTEXT_SWITCH_COST 100 // FALHA PROPOSITAL
 //#define CONTEXT_SWITCH_COST 1 (versao correta)
 #define AGING_THRESHOLD 20
 #define AGING_INTERVAL 10
 
-void schedule_fcfs(Process *list, int count, int max_simulation_time);
-void schedule_rr(Process *list, int count, int quantum, int max_simulation_time);
-void schedule_priority(Process *list, int count, int preemptive, int enable_aging, int max_simulation_time);
-void schedule_sjf(Process *list, int count, int max_simulation_time);
-void schedule_edf_preemptive(Process *list, int count, int max_simulation_time);
-void schedule_rm_preemptive(Process *list, int count, int max_simulation_time);
-void schedule_mlq(Process *list, int count, int base_quantum, int max_simulation_time);
+void schedule_fcfs(SimRun *run, const ProcessSpec *list, int count, int max_simulation_time);
+void schedule_rr(SimRun *run, const ProcessSpec *list, int count, int quantum, int max_simulation_time);
+void schedule_lottery(SimRun *run, const ProcessSpec *list, int count, int quantum, int max_simulation_time);
+void schedule_stride(SimRun *run, const ProcessSpec *list, int count, int quantum, int max_simulation_time);
+void schedule_priority(SimRun *run, const ProcessSpec *list, int count, int preemptive, int enable_aging, int max_simulation_time);
+void schedule_sjf(SimRun *run, const ProcessSpec *list, int count, int max_simulation_time);
+void schedule_srtf(SimRun *run, const ProcessSpec *list, int count, int max_simulation_time);
+void schedule_sjf_predictive(SimRun *run, const ProcessSpec *list, int count, double alpha, double tau0, int max_simulation_time);
+void schedule_edf_preemptive(SimRun *run, const ProcessSpec *list, int count, int admission_mode, int max_simulation_time);
+void schedule_rm_preemptive(SimRun *run, const ProcessSpec *list, int count, int max_simulation_time);
+void schedule_mlq(SimRun *run, const ProcessSpec *list, int count, int q0_quantum, int q1_quantum, int max_simulation_time);
 
 int find_min_arrival_time(Process *list, int count);
 void initialize_process_state(Process *p);
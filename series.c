@@ -0,0 +1,202 @@
+#include "series.h"
+#include "stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+#define SERIES_FILE_BUFFER (1 << 20)
+#define SERIES_INITIAL_WINDOWS 256
+
+enum { SERIES_SYSTEM, SERIES_BUSY, SERIES_SWITCH, SERIES_IO, SERIES_DEFERRED, SERIES_LEVELS };
+
+typedef struct {
+    int delta[SERIES_LEVELS];             // variação do nível dentro da janela
+    long long offset[SERIES_LEVELS];      // soma de sinal * (t - início da janela)
+    int arrivals;
+    int completions;
+    int switches;
+} SeriesWindow;
+
+struct TimeSeries {
+    FILE *file;
+    char *file_buffer;
+    int window;
+    SeriesWindow *windows;
+    int capacity;
+    int failed;                           // faltou memória: a série fica incompleta
+};
+
+TimeSeries *series_open(const char *path, int window) {
+    if (window < 1) return NULL;
+    TimeSeries *ts = sim_malloc(sizeof(TimeSeries));
+    if (!ts) return NULL;
+    ts->windows = sim_calloc(SERIES_INITIAL_WINDOWS, sizeof(SeriesWindow));
+    ts->file_buffer = sim_malloc(SERIES_FILE_BUFFER);
+    ts->file = (ts->windows && ts->file_buffer) ? fopen(path, "w") : NULL;
+    if (!ts->file) {
+        sim_free(ts->windows); sim_free(ts->file_buffer); sim_free(ts);
+        return NULL;
+    }
+    setvbuf(ts->file, ts->file_buffer, _IOFBF, SERIES_FILE_BUFFER);
+    ts->window = window;
+    ts->capacity = SERIES_INITIAL_WINDOWS;
+    ts->failed = 0;
+    return ts;
+}
+
+// Janela do instante t, a crescer o vetor se for preciso (NULL sem memória).
+static SeriesWindow *series_at(TimeSeries *ts, int t) {
+    int k = (t > 0 ? t : 0) / ts->window;
+    if (k >= ts->capacity) {
+        if (ts->failed) return NULL;
+        int capacity = ts->capacity;
+        while (capacity <= k) capacity = (capacity > INT_MAX / 2) ? k + 1 : capacity * 2;
+        SeriesWindow *grown = sim_realloc(ts->windows, sizeof(SeriesWindow) * (size_t)capacity);
+        if (!grown) {
+            ts->failed = 1;
+            return NULL;
+        }
+        memset(grown + ts->capacity, 0, sizeof(SeriesWindow) * (size_t)(capacity - ts->capacity));
+        ts->windows = grown;
+        ts->capacity = capacity;
+    }
+    return &ts->windows[k];
+}
+
+static void series_level(TimeSeries *ts, int level, int t, int sign) {
+    SeriesWindow *w = series_at(ts, t);
+    if (!w) return;
+    w->delta[level] += sign;
+    w->offset[level] += (long long)sign * (t - (t / ts->window) * ts->window);
+}
+
+void series_arrival(TimeSeries *ts, int time) {
+    if (!ts) return;
+    series_level(ts, SERIES_SYSTEM, time, 1);
+    SeriesWindow *w = series_at(ts, time);
+    if (w) w->arrivals++;
+}
+
+void series_exit(TimeSeries *ts, int time, int completed) {
+    if (!ts) return;
+    series_level(ts, SERIES_SYSTEM, time, -1);
+    SeriesWindow *w = series_at(ts, time);
+    if (w && completed) w->completions++;
+}
+
+void series_busy(TimeSeries *ts, int start, int end) {
+    if (!ts || end <= start) return;
+    series_level(ts, SERIES_BUSY, start, 1);
+    series_level(ts, SERIES_BUSY, end, -1);
+}
+
+void series_io_begin(TimeSeries *ts, int time) {
+    if (!ts) return;
+    series_level(ts, SERIES_IO, time, 1);
+}
+
+void series_io_end(TimeSeries *ts, int time) {
+    if (!ts) return;
+    series_level(ts, SERIES_IO, time, -1);
+}
+
+void series_defer_begin(TimeSeries *ts, int time) {
+    if (!ts) return;
+    series_level(ts, SERIES_DEFERRED, time, 1);
+}
+
+void series_defer_end(TimeSeries *ts, int time) {
+    if (!ts) return;
+    series_level(ts, SERIES_DEFERRED, time, -1);
+}
+
+void series_switch(TimeSeries *ts, int time, int cost) {
+    if (!ts) return;
+    SeriesWindow *w = series_at(ts, time);
+    if (w) w->switches++;
+    if (cost <= 0) return;
+    series_level(ts, SERIES_SWITCH, time, 1);
+    series_level(ts, SERIES_SWITCH, time + cost, -1);
+}
+
+// Escrita das linhas sem printf: com janelas pequenas há uma linha por
+// poucas unidades de tempo e a formatação dos reais dominaria o custo.
+static char *put_int(char *p, long long v) {
+    char digits[24];
+    int n = 0;
+    if (v < 0) { *p++ = '-'; v = -v; }
+    do { digits[n++] = (char)('0' + v % 10); v /= 10; } while (v > 0);
+    while (n > 0) *p++ = digits[--n];
+    return p;
+}
+
+// v com 'decimals' casas decimais (arredondado), seguido de vírgula.
+static char *put_fixed(char *p, double v, int decimals) {
+    static const long long scale[] = { 1, 10, 100, 1000, 10000 };
+    long long x = llround(v * scale[decimals]);
+    if (x < 0) { *p++ = '-'; x = -x; }
+    p = put_int(p, x / scale[decimals]);
+    *p++ = '.';
+    long long frac = x % scale[decimals];
+    for (int d = decimals - 1; d >= 0; d--) {
+        p[d] = (char)('0' + frac % 10);
+        frac /= 10;
+    }
+    p += decimals;
+    *p++ = ',';
+    return p;
+}
+
+long long series_close(TimeSeries *ts, int final_time) {
+    if (!ts) return 0;
+    long long written = -1;
+    if (!ts->failed) {
+        int W = ts->window;
+        int count = final_time > 0 ? (int)(((long long)final_time + W - 1) / W) : 0;
+        // Eventos exatamente no fim, com final_time múltiplo de W, contam
+        // na última janela (fechada à direita).
+        if (count > 0 && count < ts->capacity) {
+            SeriesWindow *last = &ts->windows[count - 1], *edge = &ts->windows[count];
+            last->arrivals += edge->arrivals;
+            last->completions += edge->completions;
+            last->switches += edge->switches;
+        }
+        fprintf(ts->file, "start,end,cpu_util,switch_util,ready_avg,io_blocked_avg,in_system_avg,arrivals,completions,context_switches,deferred_avg\n");
+        static const SeriesWindow empty;
+        long long level[SERIES_LEVELS] = { 0 };
+        for (int k = 0; k < count; k++) {
+            const SeriesWindow *w = k < ts->capacity ? &ts->windows[k] : &empty;
+            long long start = (long long)k * W;
+            long long end = start + W < final_time ? start + W : final_time;
+            long long width = end - start;
+            double avg[SERIES_LEVELS];
+            for (int l = 0; l < SERIES_LEVELS; l++) {
+                avg[l] = (double)((level[l] + w->delta[l]) * width - w->offset[l]) / width;
+                level[l] += w->delta[l];
+            }
+            double ready = avg[SERIES_SYSTEM] - avg[SERIES_BUSY] - avg[SERIES_IO] - avg[SERIES_DEFERRED];
+            char line[256], *p = line;
+            p = put_int(p, start); *p++ = ',';
+            p = put_int(p, end); *p++ = ',';
+            p = put_fixed(p, 100.0 * (avg[SERIES_BUSY] + avg[SERIES_SWITCH]), 2);
+            p = put_fixed(p, 100.0 * avg[SERIES_SWITCH], 2);
+            p = put_fixed(p, ready > 0.0 ? ready : 0.0, 4);
+            p = put_fixed(p, avg[SERIES_IO], 4);
+            p = put_fixed(p, avg[SERIES_SYSTEM], 4);
+            p = put_int(p, w->arrivals); *p++ = ',';
+            p = put_int(p, w->completions); *p++ = ',';
+            p = put_int(p, w->switches); *p++ = ',';
+            p = put_fixed(p, avg[SERIES_DEFERRED], 4);
+            p[-1] = '\n';
+            fwrite(line, 1, (size_t)(p - line), ts->file);
+        }
+        written = count;
+    }
+    if (fclose(ts->file) != 0) written = -1;
+    sim_free(ts->file_buffer);
+    sim_free(ts->windows);
+    sim_free(ts);
+    return written;
+}
@@ -0,0 +1,41 @@
+#ifndef SERIES_H
+#define SERIES_H
+
+// Série temporal por janelas de W unidades (--timeseries W ficheiro.csv):
+// utilização da CPU (execução e trocas de contexto, como a métrica global, e
+// a parte das trocas à parte), comprimento médio da fila de prontos,
+// processos em I/O e em sistema (médias ponderadas pelo tempo), chegadas,
+// conclusões e trocas de contexto em cada janela e, na última coluna, os
+// processos à espera de admissão (EDF com --admission defer).
+//
+// Nada é amostrado por tick: os motores assinalam os eventos (chegada,
+// saída, início/fim de I/O, intervalo de execução, troca) e cada evento só
+// mexe na sua janela. Os níveis (em sistema, a executar, em troca, em I/O)
+// guardam por janela a variação e a soma dos desvios dos eventos ao início
+// da janela, o que chega para integrar no fecho:
+//   integral = (nível_inicial + variação) * largura - soma dos desvios.
+// Prontos = em sistema - a executar - em I/O - adiados (inclui quem espera
+// a troca de contexto). Uma conclusão conta quando o processo sai do
+// sistema, depois do I/O terminal: quem ainda está nesse I/O no fim fica em
+// sistema, embora o resumo final já o dê como completo.
+// Com ts == NULL (série desligada) todas as chamadas retornam de imediato.
+typedef struct TimeSeries TimeSeries;
+
+// NULL se o ficheiro não puder ser criado (errno indica o motivo).
+TimeSeries *series_open(const char *path, int window);
+// Integra as janelas até final_time, escreve o CSV e fecha. Devolve o
+// número de janelas escritas, ou -1 se faltou memória ou a escrita falhou.
+long long series_close(TimeSeries *ts, int final_time);
+
+void series_arrival(TimeSeries *ts, int time);
+// Saída do sistema: conclusão (completed = 1) ou rejeição na admissão.
+void series_exit(TimeSeries *ts, int time, int completed);
+void series_busy(TimeSeries *ts, int start, int end);
+void series_io_begin(TimeSeries *ts, int time);
+void series_io_end(TimeSeries *ts, int time);
+void series_switch(TimeSeries *ts, int time, int cost);
+// Admissão adiada: o processo chegou mas ainda não foi admitido.
+void series_defer_begin(TimeSeries *ts, int time);
+void series_defer_end(TimeSeries *ts, int time);
+
+#endif
@@ -0,0 +1,259 @@
+#define _POSIX_C_SOURCE 200809L
+#include "shard.h"
+#include "stats.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#define SHARD_MAGIC   "PSSHARD1"
+#define SHARD_VERSION 1
+
+enum { SHARD_PENDING, SHARD_CLAIMED, SHARD_DONE, SHARD_FAILED };
+
+// Cabeçalho do ficheiro, ocupando 64 bytes; os registos seguem-se.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t identity;
+    int64_t count;
+    int64_t cursor;          // próximo índice da fila (incremento atómico)
+    int64_t cache_hits;      // pontos servidos pela cache de resultados nesta execução
+    char reserved[16];
+} ShardHeader;
+
+typedef struct {
+    int32_t state;           // SHARD_PENDING / _CLAIMED / _DONE / _FAILED
+    int32_t worker;          // pid do worker que o reclamou
+    SimResults result;
+} ShardRecord;
+
+struct ShardFile {
+    char *map;
+    size_t size;
+    ShardHeader *header;
+    ShardRecord *records;
+    int resumed;
+};
+
+// Tudo o que determina os resultados: a chave da cache de resultados da
+// configuração de base (carga incluída) e a grelha.
+static uint64_t shard_identity(const SweepGrid *grid, const SimWorkload *workload, const SimConfig *base) {
+    uint64_t h = CACHE_HASH_INIT;
+    h = cache_hash_int(h, SHARD_VERSION);
+    h = cache_hash_int(h, sizeof(ShardRecord));
+    h = cache_hash_int(h, (long long)cache_key(cache_hash_workload(workload), base));
+    h = cache_hash_int(h, grid->count);
+    for (int k = 0; k < grid->count; k++) {
+        const SweepPoint *pt = &grid->points[k];
+        h = cache_hash_int(h, pt->quantum);
+        h = cache_hash_int(h, pt->switch_cost);
+        h = cache_hash_int(h, pt->aging_threshold);
+        h = cache_hash_int(h, pt->aging_interval);
+        h = cache_hash_int(h, pt->mlq_quantum[0]);
+        h = cache_hash_int(h, pt->mlq_quantum[1]);
+    }
+    return h;
+}
+
+static int header_matches(const ShardHeader *hdr, uint64_t identity, int count) {
+    return memcmp(hdr->magic, SHARD_MAGIC, 8) == 0 && hdr->version == SHARD_VERSION &&
+           hdr->record_size == sizeof(ShardRecord) && hdr->identity == identity && hdr->count == count;
+}
+
+ShardFile *shard_open(const char *path, const SweepGrid *grid, const SimWorkload *workload, const SimConfig *base) {
+    uint64_t identity = shard_identity(grid, workload, base);
+    size_t size = sizeof(ShardHeader) + sizeof(ShardRecord) * (size_t)grid->count;
+
+    int fd;
+    char tmp_path[] = "/tmp/probsched-shard-XXXXXX";
+    if (path) {
+        fd = open(path, O_RDWR | O_CREAT, 0644);
+    } else {
+        fd = mkstemp(tmp_path);
+        if (fd >= 0) unlink(tmp_path);
+    }
+    if (fd < 0) {
+        fprintf(stderr, "Erro ao abrir ficheiro de resultados '%s': %s\n", path ? path : tmp_path, strerror(errno));
+        return NULL;
+    }
+
+    struct stat st;
+    int existing = (fstat(fd, &st) == 0 && st.st_size > 0);
+    if (existing && (size_t)st.st_size != size) {
+        fprintf(stderr, "Erro: '%s' pertence a outro varrimento (tamanho diferente).\n", path);
+        close(fd);
+        return NULL;
+    }
+    if (!existing && ftruncate(fd, (off_t)size) != 0) {
+        fprintf(stderr, "Erro ao dimensionar ficheiro de resultados: %s\n", strerror(errno));
+        close(fd);
+        return NULL;
+    }
+    char *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Erro ao mapear ficheiro de resultados: %s\n", strerror(errno));
+        return NULL;
+    }
+
+    ShardFile *sf = sim_calloc(1, sizeof(ShardFile));
+    if (!sf) {
+        fprintf(stderr, "Erro malloc varrimento\n");
+        munmap(map, size);
+        return NULL;
+    }
+    sf->map = map;
+    sf->size = size;
+    sf->header = (ShardHeader *)map;
+    sf->records = (ShardRecord *)(map + sizeof(ShardHeader));
+
+    if (existing) {
+        if (!header_matches(sf->header, identity, grid->count)) {
+            fprintf(stderr, "Erro: '%s' pertence a outro varrimento (carga, configuração ou grelha diferentes).\n", path);
+            shard_close(sf);
+            return NULL;
+        }
+        // Retoma: o que estava reclamado quando o varrimento parou, ou se
+        // perdeu com um worker, volta à fila.
+        for (int k = 0; k < grid->count; k++) {
+            ShardRecord *rec = &sf->records[k];
+            if (rec->state == SHARD_DONE) sf->resumed++;
+            else rec->state = SHARD_PENDING;
+        }
+    } else {
+        // ftruncate deixa os registos a zero, ou seja, SHARD_PENDING.
+        memcpy(sf->header->magic, SHARD_MAGIC, 8);
+        sf->header->version = SHARD_VERSION;
+        sf->header->record_size = sizeof(ShardRecord);
+        sf->header->identity = identity;
+        sf->header->count = grid->count;
+    }
+    sf->header->cursor = 0;
+    sf->header->cache_hits = 0;
+    return sf;
+}
+
+// Corpo de um worker: reclama pontos pelo cursor partilhado até a fila
+// acabar. Só termina com _exit, para não correr código do coordenador.
+static void shard_worker(ShardFile *sf, const SweepGrid *grid, const SimWorkload *workload, const SimConfig *base,
+                         ResultCache *cache, uint64_t workload_hash) {
+    SimContext arena;
+    if (!simctx_init(&arena, simctx_estimate(workload->count))) _exit(2);
+    int32_t pid = (int32_t)getpid();
+    // Os contadores da cópia da cache são deste processo; os acertos vão
+    // para o cabeçalho.
+    long long hits_before = cache ? cache->hits : 0;
+
+    for (;;) {
+        int64_t k = __atomic_fetch_add(&sf->header->cursor, 1, __ATOMIC_SEQ_CST);
+        if (k >= grid->count) break;
+        ShardRecord *rec = &sf->records[k];
+        int32_t expected = SHARD_PENDING;
+        if (!__atomic_compare_exchange_n(&rec->state, &expected, SHARD_CLAIMED, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+            continue;
+        }
+        __atomic_store_n(&rec->worker, pid, __ATOMIC_SEQ_CST);
+
+        SimConfig cfg;
+        sweep_point_config(base, &grid->points[k], &arena, &cfg);
+        simctx_reset(&arena);
+        int status = cache_simulate(cache, workload_hash, workload, &cfg, &rec->result);
+        __atomic_store_n(&rec->state, status == SIM_OK ? SHARD_DONE : SHARD_FAILED, __ATOMIC_RELEASE);
+    }
+    if (cache) __atomic_fetch_add(&sf->header->cache_hits, cache->hits - hits_before, __ATOMIC_SEQ_CST);
+    simctx_destroy(&arena);
+    _exit(0);
+}
+
+static pid_t spawn_worker(ShardFile *sf, const SweepGrid *grid, const SimWorkload *workload, const SimConfig *base,
+                          ResultCache *cache, uint64_t workload_hash) {
+    pid_t pid = fork();
+    if (pid == 0) shard_worker(sf, grid, workload, base, cache, workload_hash);
+    return pid;
+}
+
+// Ponto que o worker 'pid' tinha reclamado quando morreu: fica perdido.
+static int mark_lost(ShardFile *sf, int count, pid_t pid) {
+    int lost = 0;
+    for (int k = 0; k < count; k++) {
+        ShardRecord *rec = &sf->records[k];
+        if (rec->state == SHARD_CLAIMED && rec->worker == (int32_t)pid) {
+            rec->state = SHARD_FAILED;
+            lost++;
+        }
+    }
+    return lost;
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1.0e3 + ts.tv_nsec / 1.0e6;
+}
+
+int shard_run(ShardFile *sf, const SweepGrid *grid, const SimWorkload *workload, const SimConfig *base,
+              int workers, ResultCache *cache, ShardSummary *summary) {
+    double start = now_ms();
+    uint64_t workload_hash = cache ? cache_hash_workload(workload) : 0;
+    memset(summary, 0, sizeof(*summary));
+    summary->total = grid->count;
+    summary->resumed = sf->resumed;
+
+    int pending = grid->count - sf->resumed;
+    if (workers > pending) workers = pending;
+    // Os buffers do stdio seriam duplicados em cada fork.
+    fflush(NULL);
+
+    int running = 0;
+    for (int w = 0; w < workers; w++) {
+        if (spawn_worker(sf, grid, workload, base, cache, workload_hash) > 0) running++;
+    }
+    if (running == 0 && workers > 0) return SIM_ERR_MEMORY;
+
+    while (running > 0) {
+        int wstatus;
+        pid_t pid = waitpid(-1, &wstatus, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        running--;
+        if (WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0) continue;
+
+        // Morte anormal: perde-se o ponto em curso e, se ainda houver
+        // trabalho na fila, entra um worker novo.
+        summary->lost += mark_lost(sf, grid->count, pid);
+        if (__atomic_load_n(&sf->header->cursor, __ATOMIC_SEQ_CST) < grid->count &&
+            spawn_worker(sf, grid, workload, base, cache, workload_hash) > 0) {
+            running++;
+            summary->respawns++;
+        }
+    }
+
+    for (int k = 0; k < grid->count; k++) {
+        if (sf->records[k].state == SHARD_DONE) summary->done++;
+    }
+    summary->cached = (int)sf->header->cache_hits;
+    msync(sf->map, sf->size, MS_SYNC);
+    summary->wall_ms = now_ms() - start;
+    return SIM_OK;
+}
+
+const SimResults *shard_result(const ShardFile *sf, int point) {
+    const ShardRecord *rec = &sf->records[point];
+    return rec->state == SHARD_DONE ? &rec->result : NULL;
+}
+
+void shard_close(ShardFile *sf) {
+    if (!sf) return;
+    munmap(sf->map, sf->size);
+    sim_free(sf);
+}
@@ -0,0 +1,47 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include "sweep.h"
+
+// Varrimento em vários processos (--workers, --sweep-file). O coordenador
+// cria um ficheiro mapeado em memória (mmap partilhado) com um cabeçalho e
+// um registo de tamanho fixo por ponto; o cabeçalho tem o cursor da fila de
+// trabalho. Cada worker é um fork do coordenador (herda a carga já gerada),
+// reclama pontos com operações atómicas sobre o ficheiro e escreve o
+// SimResults diretamente no registo do ponto.
+//
+// Um worker que morra perde só o ponto que tinha reclamado (marcado como
+// perdido) e é substituído. Se o próprio varrimento for interrompido, uma
+// nova execução com o mesmo ficheiro e a mesma configuração retoma os pontos
+// que faltam, incluindo os perdidos; o ficheiro guarda uma identidade (hash
+// da carga, configuração e grelha) e é recusado se não corresponder.
+#define SHARD_MAX_POINTS (1 << 24)
+
+typedef struct ShardFile ShardFile;
+
+typedef struct {
+    int total;
+    int done;               // pontos com resultado (incluindo os retomados)
+    int resumed;            // já estavam feitos no ficheiro
+    int lost;               // reclamados por workers que morreram
+    int respawns;
+    int cached;             // servidos pela cache de resultados
+    double wall_ms;
+} ShardSummary;
+
+// path == NULL usa um ficheiro temporário (sem retoma). Em erro escreve a
+// mensagem no stderr e devolve NULL.
+ShardFile *shard_open(const char *path, const SweepGrid *grid, const SimWorkload *workload, const SimConfig *base);
+
+// Corre os pontos em falta com 'workers' processos, consultando 'cache'
+// (NULL = sem cache). Devolve SIM_OK, ou SIM_ERR_MEMORY se nenhum worker
+// puder ser criado.
+int shard_run(ShardFile *sf, const SweepGrid *grid, const SimWorkload *workload, const SimConfig *base,
+              int workers, ResultCache *cache, ShardSummary *summary);
+
+// Resultado do ponto, ou NULL se não foi calculado (perdido ou falhou).
+const SimResults *shard_result(const ShardFile *sf, int point);
+
+void shard_close(ShardFile *sf);
+
+#endif
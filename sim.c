@@ -0,0 +1,261 @@
+#include "sim.h"
+#include "scheduler.h"
+#include "checkpoint.h"
+#include "stats.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+
+#define SIM_LOG_LINE 512
+
+static void sim_vlog(SimRun *run, int level, const char *fmt, va_list ap) {
+    char line[SIM_LOG_LINE];
+    va_list copy;
+    va_copy(copy, ap);
+    int n = vsnprintf(line, sizeof(line), fmt, ap);
+    if (n < 0) { va_end(copy); return; }
+    if ((size_t)n < sizeof(line)) {
+        run->config->log(run->config->log_arg, level, line);
+    } else {
+        // Mensagem longa (relatórios com muitos campos): buffer dedicado.
+        char *big = sim_malloc((size_t)n + 1);
+        if (big) {
+            vsnprintf(big, (size_t)n + 1, fmt, copy);
+            run->config->log(run->config->log_arg, level, big);
+            sim_free(big);
+        }
+    }
+    va_end(copy);
+}
+
+int sim_logging(const SimRun *run) {
+    return run->config->log != NULL && run->config->log_level <= SIM_LOG_INFO;
+}
+
+void sim_log(SimRun *run, const char *fmt, ...) {
+    if (!run->config->log || run->config->log_level > SIM_LOG_INFO) return;
+    va_list ap;
+    va_start(ap, fmt);
+    sim_vlog(run, SIM_LOG_INFO, fmt, ap);
+    va_end(ap);
+}
+
+void sim_warn(SimRun *run, const char *fmt, ...) {
+    if (!run->config->log) return;
+    va_list ap;
+    va_start(ap, fmt);
+    sim_vlog(run, SIM_LOG_ERROR, fmt, ap);
+    va_end(ap);
+}
+
+void sim_fail(SimRun *run, int status, const char *fmt, ...) {
+    if (run->results->status == SIM_OK) run->results->status = status;
+    if (!run->config->log) return;
+    va_list ap;
+    va_start(ap, fmt);
+    sim_vlog(run, SIM_LOG_ERROR, fmt, ap);
+    va_end(ap);
+}
+
+int sim_branch(SimRun *run, int current_time) {
+    run->branch_time = INT_MAX;
+    SimParams params = { current_time, run->quantum, run->switch_cost, run->aging_threshold, run->aging_interval,
+                         { run->mlq_quantum[0], run->mlq_quantum[1] } };
+    run->config->on_branch(run->config->branch_arg, &params);
+    if (params.quantum < 1 || params.context_switch_cost < 0 || params.aging_threshold < 1 ||
+        params.aging_interval < 1 || params.mlq_quantum[0] < 1 || params.mlq_quantum[1] < 1) {
+        sim_fail(run, SIM_ERR_ARGS, "Erro: Parâmetros inválidos na ramificação em t=%d\n", current_time);
+        return 1;
+    }
+    run->quantum = params.quantum;
+    run->switch_cost = params.context_switch_cost;
+    run->aging_threshold = params.aging_threshold;
+    run->aging_interval = params.aging_interval;
+    run->mlq_quantum[0] = params.mlq_quantum[0];
+    run->mlq_quantum[1] = params.mlq_quantum[1];
+    return 1;
+}
+
+int sim_hook(SimRun *run, int current_time) {
+    int changed = current_time >= run->branch_time ? sim_branch(run, current_time) : 0;
+    run->hook_time = run->branch_time;
+    run->hook_steps = INT_MAX;
+    if (run->state) sim_state_tick(run, current_time);
+    return changed;
+}
+
+unsigned long long sim_rand(SimRun *run) {
+    unsigned long long z = (run->rng += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void sim_config_defaults(SimConfig *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->algorithm = "fcfs";
+    cfg->quantum = 4;
+    cfg->max_simulation_time = 100;
+    cfg->pred_alpha = SJF_PRED_DEFAULT_ALPHA;
+    cfg->pred_tau0 = SJF_PRED_DEFAULT_TAU0;
+    cfg->admission_mode = ADMISSION_NONE;
+    cfg->log_level = SIM_LOG_INFO;
+    cfg->context_switch_cost = CONTEXT_SWITCH_COST;
+    cfg->aging_threshold = AGING_THRESHOLD;
+    cfg->aging_interval = AGING_INTERVAL;
+}
+
+// Pela ordem do dispatch, com os parâmetros de execução que cada motor lê.
+// O rr não usa o quantum: corre sempre com fatia efetiva de 1 tick.
+static const struct {
+    const char *name;
+    int params;
+} algorithms[] = {
+    { "fcfs", 0 }, { "sjf", 0 }, { "srtf", 0 }, { "sjf-pred", 0 }, { "rr", 0 },
+    { "lottery", SIM_PARAM_QUANTUM }, { "stride", SIM_PARAM_QUANTUM },
+    { "prio-np", 0 }, { "prio-p", SIM_PARAM_AGING }, { "edf", 0 }, { "rm", 0 },
+    { "mlq", SIM_PARAM_QUANTUM | SIM_PARAM_MLQ_QUANTA }
+};
+
+static int algorithm_index(const char *algorithm) {
+    if (!algorithm) return -1;
+    for (int k = 0; k < (int)(sizeof(algorithms) / sizeof(algorithms[0])); k++) {
+        if (strcmp(algorithm, algorithms[k].name) == 0) return k;
+    }
+    return -1;
+}
+
+int sim_algorithm_valid(const char *algorithm) {
+    return algorithm_index(algorithm) >= 0;
+}
+
+int sim_algorithm_params(const char *algorithm) {
+    int k = algorithm_index(algorithm);
+    return k >= 0 ? algorithms[k].params : 0;
+}
+
+int sim_quantum_effective(const char *algorithm) {
+    return (sim_algorithm_params(algorithm) & SIM_PARAM_QUANTUM) != 0;
+}
+
+const char *sim_status_name(int status) {
+    switch (status) {
+        case SIM_OK:            return "ok";
+        case SIM_ERR_ARGS:      return "argumentos inválidos";
+        case SIM_ERR_ALGORITHM: return "algoritmo desconhecido";
+        case SIM_ERR_MEMORY:    return "memória insuficiente";
+        case SIM_ERR_TRACE:     return "erro no ficheiro de trace";
+        case SIM_ERR_CHECKPOINT: return "erro no checkpoint";
+        case SIM_ERR_SERIES:    return "erro no ficheiro da série temporal";
+    }
+    return "?";
+}
+
+static void dispatch(SimRun *run, int algo, const ProcessSpec *list, int count) {
+    const SimConfig *cfg = run->config;
+    int tmax = cfg->max_simulation_time;
+    switch (algo) {
+        case 0:  schedule_fcfs(run, list, count, tmax); break;
+        case 1:  schedule_sjf(run, list, count, tmax); break;
+        case 2:  schedule_srtf(run, list, count, tmax); break;
+        case 3:  schedule_sjf_predictive(run, list, count, cfg->pred_alpha, cfg->pred_tau0, tmax); break;
+        case 4:  schedule_rr(run, list, count, run->quantum, tmax); break;
+        case 5:  schedule_lottery(run, list, count, run->quantum, tmax); break;
+        case 6:  schedule_stride(run, list, count, run->quantum, tmax); break;
+        case 7:  schedule_priority(run, list, count, 0, 0, tmax); break;
+        case 8:  schedule_priority(run, list, count, 1, 1, tmax); break;
+        case 9:  schedule_edf_preemptive(run, list, count, cfg->admission_mode, tmax); break;
+        case 10: schedule_rm_preemptive(run, list, count, tmax); break;
+        case 11: schedule_mlq(run, list, count, run->mlq_quantum[0], run->mlq_quantum[1], tmax); break;
+    }
+}
+
+int simulate(const SimWorkload *workload, const SimConfig *config, SimResults *results) {
+    memset(results, 0, sizeof(*results));
+    results->resumed_time = -1;
+    if (!workload || !config || !workload->processes || workload->count <= 0 || !workload->phases ||
+        config->quantum < 1 || config->context_switch_cost < 0 || config->aging_threshold < 1 || config->aging_interval < 1 ||
+        config->mlq_quantum[0] < 0 || config->mlq_quantum[1] < 0) {
+        results->status = SIM_ERR_ARGS;
+        return results->status;
+    }
+    int algo = algorithm_index(config->algorithm);
+    if (algo < 0) {
+        results->status = SIM_ERR_ALGORITHM;
+        return results->status;
+    }
+
+    SimRun run;
+    memset(&run, 0, sizeof(run));
+    run.config = config;
+    run.phases = workload->phases;
+    run.arena = config->arena;
+    run.rng = config->seed;
+    run.switch_cost = config->context_switch_cost;
+    run.aging_threshold = config->aging_threshold;
+    run.aging_interval = config->aging_interval;
+    run.quantum = config->quantum;
+    run.mlq_quantum[0] = config->mlq_quantum[0] > 0 ? config->mlq_quantum[0] : config->quantum;
+    run.mlq_quantum[1] = config->mlq_quantum[1] > 0 ? config->mlq_quantum[1] : config->quantum * 2;
+    run.branch_time = config->on_branch ? config->branch_time : INT_MAX;
+    run.hook_time = run.branch_time;
+    run.hook_steps = INT_MAX;
+    run.results = results;
+    iodev_init(&run.io, &run, config->io_devices, config->io_device_count);
+    run.classes = sim_calloc(1, sizeof(ClassStats));
+    if (!run.classes) {
+        results->status = SIM_ERR_MEMORY;
+        return results->status;
+    }
+    run.classes->track_queues = (algo == 11);
+    if (!sim_state_open(&run, workload)) {
+        sim_state_close(&run);
+        sim_free(run.classes);
+        return results->status;
+    }
+
+    if (config->trace_path && config->trace_path[0] != '\0') {
+        run.trace = trace_open(config->trace_path, config->algorithm);
+        if (!run.trace) {
+            sim_fail(&run, SIM_ERR_TRACE, "Erro ao criar ficheiro de trace '%s': %s\n",
+                     config->trace_path, strerror(errno));
+            sim_state_close(&run);
+            sim_free(run.classes);
+            return results->status;
+        }
+        iodev_trace_tracks(&run.io);
+    }
+    if (config->series_path && config->series_path[0] != '\0') {
+        run.series = series_open(config->series_path, config->series_window);
+        if (!run.series) {
+            sim_fail(&run, SIM_ERR_SERIES, "Erro ao criar ficheiro da série temporal '%s': %s\n",
+                     config->series_path, strerror(errno));
+            if (run.trace) trace_close(run.trace);
+            sim_state_close(&run);
+            sim_free(run.classes);
+            return results->status;
+        }
+    }
+
+    // Tudo o que a execução aloca na arena é devolvido no fim.
+    size_t mark = run.arena ? simctx_mark(run.arena) : 0;
+    dispatch(&run, algo, workload->processes, workload->count);
+    sim_state_close(&run);
+    iodev_free(&run.io);
+    if (run.arena) simctx_release(run.arena, mark);
+
+    results->process_count = workload->count;
+    class_finish(run.classes, results);
+    sim_free(run.classes);
+    if (run.trace) results->trace_events = trace_close(run.trace);
+    if (run.series) {
+        results->series_windows = series_close(run.series, results->final_time);
+        if (results->series_windows < 0) {
+            sim_fail(&run, SIM_ERR_SERIES, "Erro ao escrever a série temporal '%s' (memória ou disco insuficiente)\n",
+                     config->series_path);
+        }
+    }
+    return results->status;
+}
@@ -0,0 +1,63 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include "probsched.h"
+#include "trace.h"
+#include "series.h"
+#include "classes.h"
+#include "iodev.h"
+
+// Estado interno de uma chamada a simulate(), passado a todos os motores em
+// vez de estado global: configuração, arena, trace, dispositivos de I/O,
+// gerador aleatório e resultados.
+typedef struct SimRun {
+    const SimConfig *config;
+    const Phase *phases;        // vetor de fases da carga
+    SimContext *arena;
+    TraceWriter *trace;
+    TimeSeries *series;         // série temporal por janelas (NULL = desligada)
+    ClassStats *classes;        // métricas por classe e equidade
+    IoDevices io;
+    unsigned long long rng;
+    int switch_cost;            // parâmetros de execução (cópia de config,
+    int aging_threshold;        // podem mudar na ramificação)
+    int aging_interval;
+    int quantum;
+    int mlq_quantum[MLQ_RR_LEVELS];
+    int branch_time;            // ramificação pendente (INT_MAX = nenhuma)
+    struct SimState *state;     // checkpoints (NULL = desligados, ver checkpoint.h)
+    int hook_time;              // próximo instante com trabalho para sim_hook
+    int hook_steps;             // passos até sim_hook consultar o relógio
+    SimResults *results;
+} SimRun;
+
+#ifdef __GNUC__
+#define SIM_PRINTF(f, a) __attribute__((format(printf, f, a)))
+#else
+#define SIM_PRINTF(f, a)
+#endif
+
+// Mensagens para o destino de registo; sem destino retornam de imediato.
+void sim_log(SimRun *run, const char *fmt, ...) SIM_PRINTF(2, 3);
+void sim_warn(SimRun *run, const char *fmt, ...) SIM_PRINTF(2, 3);
+// Erro fatal do motor: regista a mensagem e fixa o estado da execução.
+void sim_fail(SimRun *run, int status, const char *fmt, ...) SIM_PRINTF(3, 4);
+int  sim_logging(const SimRun *run);
+
+// Ramificação: chama config->on_branch e aplica os parâmetros devolvidos.
+// Devolve 1 (os parâmetros de execução podem ter mudado).
+int  sim_branch(SimRun *run, int current_time);
+
+// Ramificação e checkpoint pendentes; rearma hook_time e hook_steps. Devolve
+// 1 se os parâmetros de execução podem ter mudado.
+int  sim_hook(SimRun *run, int current_time);
+
+// Os motores chamam-na no início de cada passo do ciclo principal.
+static inline int sim_checkpoint(SimRun *run, int current_time) {
+    return (current_time >= run->hook_time || --run->hook_steps == 0) && sim_hook(run, current_time);
+}
+
+// Gerador da execução (splitmix64), independente do rand() global.
+unsigned long long sim_rand(SimRun *run);
+
+#endif
@@ -0,0 +1,126 @@
+#include "simctx.h"
+#include "stats.h"
+#include "process.h"
+#include <stdio.h>
+#include <string.h>
+
+static size_t align_up(size_t n) {
+    return (n + SIMCTX_ALIGN - 1) & ~(size_t)(SIMCTX_ALIGN - 1);
+}
+
+static int in_arena(const SimContext *ctx, const void *ptr) {
+    const char *p = (const char *)ptr;
+    return ctx && ctx->base && p >= ctx->base && p < ctx->base + ctx->capacity;
+}
+
+size_t simctx_estimate(int process_count) {
+    // Cópia local + algumas estruturas indexadas por processo + linha temporal.
+    size_t per_process = sizeof(Process) * 2 + 256;
+    size_t bytes = SIMCTX_MIN_BYTES + (size_t)(process_count > 0 ? process_count : 0) * per_process;
+    return align_up(bytes);
+}
+
+// Reserva 'capacity' bytes e toca todas as páginas já aqui, fora das execuções.
+static int arena_reserve(SimContext *ctx, size_t capacity) {
+    char *base = sim_malloc(capacity);
+    if (!base) return 0;
+    memset(base, 0, capacity);
+    ctx->base = base;
+    ctx->capacity = capacity;
+    return 1;
+}
+
+int simctx_init(SimContext *ctx, size_t capacity) {
+    memset(ctx, 0, sizeof(*ctx));
+    if (capacity < SIMCTX_MIN_BYTES) capacity = SIMCTX_MIN_BYTES;
+    if (!arena_reserve(ctx, align_up(capacity))) {
+        fprintf(stderr, "Erro malloc arena de simulação (a usar malloc direto)\n");
+        return 0;
+    }
+    return 1;
+}
+
+void simctx_destroy(SimContext *ctx) {
+    sim_free(ctx->base);
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+void simctx_reset(SimContext *ctx) {
+    size_t demand = ctx->used + ctx->fallback_bytes;
+    if (demand > ctx->peak) ctx->peak = demand;
+
+    // A execução anterior não coube: cresce para a próxima potência de 2.
+    if (ctx->base && ctx->peak > ctx->capacity) {
+        size_t capacity = ctx->capacity;
+        while (capacity < ctx->peak) capacity *= 2;
+        sim_free(ctx->base);
+        ctx->base = NULL;
+        ctx->capacity = 0;
+        if (!arena_reserve(ctx, capacity)) {
+            fprintf(stderr, "Erro malloc ao crescer a arena de simulação (a usar malloc direto)\n");
+        }
+        ctx->grows++;
+    }
+    ctx->used = 0;
+    ctx->last_block = 0;
+    ctx->fallback_bytes = 0;
+    ctx->resets++;
+}
+
+size_t simctx_mark(const SimContext *ctx) {
+    return ctx->used;
+}
+
+void simctx_release(SimContext *ctx, size_t mark) {
+    size_t demand = ctx->used + ctx->fallback_bytes;
+    if (demand > ctx->peak) ctx->peak = demand;
+    if (mark <= ctx->used) {
+        ctx->used = mark;
+        ctx->last_block = mark;
+    }
+}
+
+void *simctx_alloc(SimContext *ctx, size_t size) {
+    if (!ctx) return sim_malloc(size);
+    size_t need = align_up(size > 0 ? size : 1);
+    if (ctx->base && ctx->capacity - ctx->used >= need) {
+        void *ptr = ctx->base + ctx->used;
+        ctx->last_block = ctx->used;
+        ctx->used += need;
+        ctx->arena_allocs++;
+        return ptr;
+    }
+    ctx->fallback_allocs++;
+    ctx->fallback_bytes += need;
+    return sim_malloc(size);
+}
+
+void *simctx_calloc(SimContext *ctx, size_t n, size_t size) {
+    void *ptr = simctx_alloc(ctx, n * size);
+    if (ptr) memset(ptr, 0, n * size);
+    return ptr;
+}
+
+void *simctx_realloc(SimContext *ctx, void *ptr, size_t old_size, size_t new_size) {
+    if (!ctx) return sim_realloc(ptr, new_size);
+    if (!ptr) return simctx_alloc(ctx, new_size);
+    if (!in_arena(ctx, ptr)) {
+        ctx->fallback_allocs++;
+        ctx->fallback_bytes += align_up(new_size);
+        return sim_realloc(ptr, new_size);
+    }
+    // Último bloco da arena: cresce no lugar se houver espaço.
+    size_t offset = (size_t)((char *)ptr - ctx->base);
+    if (offset == ctx->last_block && offset + align_up(new_size) <= ctx->capacity) {
+        ctx->used = offset + align_up(new_size);
+        return ptr;
+    }
+    void *grown = simctx_alloc(ctx, new_size);
+    if (grown) memcpy(grown, ptr, old_size < new_size ? old_size : new_size);
+    return grown;
+}
+
+void simctx_free(SimContext *ctx, void *ptr) {
+    if (!ptr || in_arena(ctx, ptr)) return;
+    sim_free(ptr);
+}
@@ -0,0 +1,45 @@
+#ifndef SIMCTX_H
+#define SIMCTX_H
+
+#include <stddef.h>
+
+// Contexto de simulação: uma arena "bump" que guarda o estado de cada
+// execução (cópia local dos processos, heaps, Fenwick, linha temporal, ...).
+// Entre execuções a arena é reposta em vez de libertada, pelo que a memória é
+// reservada e pré-tocada uma só vez. Pedidos que não cabem vão ao malloc e a
+// arena cresce no reset seguinte para os acomodar. Todas as funções recebem o
+// contexto explicitamente; com ctx == NULL usam malloc/free diretamente.
+#define SIMCTX_ALIGN     16
+#define SIMCTX_MIN_BYTES (256 * 1024)
+
+typedef struct {
+    char *base;
+    size_t capacity;
+    size_t used;
+    size_t last_block;        // início do último bloco (realloc no lugar)
+    size_t fallback_bytes;    // bytes pedidos ao malloc desde o último reset
+    size_t peak;              // maior procura (arena + fallback) numa execução
+    unsigned long long resets;
+    unsigned long long arena_allocs;
+    unsigned long long fallback_allocs;
+    unsigned long long grows;
+} SimContext;
+
+// Estimativa do tamanho da arena para uma carga com 'process_count' processos.
+size_t simctx_estimate(int process_count);
+int    simctx_init(SimContext *ctx, size_t capacity);
+void   simctx_destroy(SimContext *ctx);
+// Início de uma execução: descarta tudo o que estava na arena.
+void   simctx_reset(SimContext *ctx);
+
+// Marca/liberta em pilha, para correr vários motores sobre a mesma carga.
+size_t simctx_mark(const SimContext *ctx);
+void   simctx_release(SimContext *ctx, size_t mark);
+
+void  *simctx_alloc(SimContext *ctx, size_t size);
+void  *simctx_calloc(SimContext *ctx, size_t n, size_t size);
+void  *simctx_realloc(SimContext *ctx, void *ptr, size_t old_size, size_t new_size);
+// Sem efeito para blocos da arena; blocos de fallback vão ao free.
+void   simctx_free(SimContext *ctx, void *ptr);
+
+#endif
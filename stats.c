@@ -0,0 +1,125 @@
+#define _POSIX_C_SOURCE 200809L
+#include "stats.h"
+#include <stdio.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#ifdef PROBSCHED_STATS
+
+STATS_THREAD_LOCAL SimStats g_stats;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1.0e9 + ts.tv_nsec;
+}
+
+static unsigned long long read_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// As fases de verificação (chegadas, I/O, escolha) são muito curtas e muito
+// frequentes, por isso só usam o TSC; as restantes usam também clock_gettime.
+void stats_phase_begin(StatsPhase phase) {
+    g_stats.phase_start_cycles[phase] = read_cycles();
+    if (phase < PHASE_ARRIVAL_CHECKS) g_stats.phase_start_ns[phase] = now_ns();
+}
+
+void stats_phase_end(StatsPhase phase) {
+    g_stats.phase_cycles[phase] += read_cycles() - g_stats.phase_start_cycles[phase];
+    if (phase < PHASE_ARRIVAL_CHECKS) g_stats.phase_ns[phase] += now_ns() - g_stats.phase_start_ns[phase];
+}
+
+void *stats_malloc(size_t size) {
+    g_stats.malloc_calls++;
+    g_stats.malloc_bytes += size;
+    return malloc(size);
+}
+
+void *stats_calloc(size_t n, size_t size) {
+    g_stats.malloc_calls++;
+    g_stats.malloc_bytes += n * size;
+    return calloc(n, size);
+}
+
+void *stats_realloc(void *ptr, size_t size) {
+    g_stats.malloc_calls++;
+    g_stats.malloc_bytes += size;
+    return realloc(ptr, size);
+}
+
+void stats_free(void *ptr) {
+    if (ptr) g_stats.free_calls++;
+    free(ptr);
+}
+
+int stats_enabled(void) { return 1; }
+
+// Largura visível de uma string UTF-8 (os nomes das fases têm acentos).
+static void print_padded(const char *text, int width) {
+    int visible = 0;
+    for (const char *c = text; *c; c++) {
+        if ((*c & 0xC0) != 0x80) visible++;
+    }
+    printf("%s", text);
+    for (int i = visible; i < width; i++) putchar(' ');
+}
+
+static double ratio(unsigned long long a, unsigned long long b) {
+    return b > 0 ? (double)a / b : 0.0;
+}
+
+void stats_print(void) {
+    static const char *phase_names[PHASE_COUNT] = {
+        "Geração/Leitura", "Simulação (total)", "Métricas Finais",
+        "check_new_arrivals", "check_io_completions", "Escolha do próximo"
+    };
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("\n--- Estatísticas de Instrumentação (--stats) ---\n");
+    printf("Iterações do Ciclo Principal:  %llu\n", g_stats.loop_iterations);
+    printf("Escolhas (picks):              %llu\n", g_stats.picks);
+    printf("Processos Examinados:          %llu (%.2f por escolha)\n",
+           g_stats.procs_examined, ratio(g_stats.procs_examined, g_stats.picks));
+    printf("Terminados Retirados:          %llu (dos varrimentos dos motores lineares)\n", g_stats.procs_retired);
+    printf("check_new_arrivals:            %llu chamadas, %llu chegadas (%.4f por chamada)\n",
+           g_stats.arrival_checks, g_stats.arrivals_fired, ratio(g_stats.arrivals_fired, g_stats.arrival_checks));
+    printf("check_io_completions:          %llu chamadas, %llu conclusões (%.4f por chamada)\n",
+           g_stats.io_checks, g_stats.io_fired, ratio(g_stats.io_fired, g_stats.io_checks));
+    printf("Verificações de Preempção:     %llu (%llu preempções, %.4f)\n",
+           g_stats.preemption_checks, g_stats.preemptions, ratio(g_stats.preemptions, g_stats.preemption_checks));
+    printf("Avanços em Ociosidade:         %llu (%llu unidades saltadas)\n",
+           g_stats.idle_fastforwards, g_stats.idle_time_skipped);
+    printf("--------------------------------------------------\n");
+    printf("Fase                  | Tempo (ms) | Ciclos (TSC)\n");
+    for (int ph = 0; ph < PHASE_COUNT; ph++) {
+        print_padded(phase_names[ph], 21);
+        if (ph < PHASE_ARRIVAL_CHECKS) {
+            printf(" | %10.3f | %llu\n", g_stats.phase_ns[ph] / 1.0e6, g_stats.phase_cycles[ph]);
+        } else {
+            printf(" | %10s | %llu\n", "-", g_stats.phase_cycles[ph]);
+        }
+    }
+    printf("--------------------------------------------------\n");
+    printf("Pico de Memória (RSS):         %ld KiB\n", usage.ru_maxrss);
+    printf("Alocações (malloc/realloc):    %llu (%llu bytes)\n", g_stats.malloc_calls, g_stats.malloc_bytes);
+    printf("Libertações (free):            %llu\n", g_stats.free_calls);
+    printf("Page Faults (minor/major):     %ld / %ld\n", usage.ru_minflt, usage.ru_majflt);
+    printf("--------------------------------------------------\n");
+}
+
+#else
+
+int stats_enabled(void) { return 0; }
+
+void stats_print(void) {
+    printf("\n--- Estatísticas de Instrumentação (--stats) ---\n");
+    printf("Indisponíveis: compilado sem PROBSCHED_STATS (make STATS=1).\n");
+}
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdlib.h>
+
+// Contadores de instrumentação do caminho crítico dos motores. Compilados
+// apenas com -DPROBSCHED_STATS (make STATS=1, ativo por omissão); com STATS=0
+// todas as macros desaparecem e o custo é nulo.
+typedef enum {
+    PHASE_GENERATION,
+    PHASE_SIMULATION,
+    PHASE_METRICS,
+    PHASE_ARRIVAL_CHECKS,
+    PHASE_IO_CHECKS,
+    PHASE_PICK,
+    PHASE_COUNT
+} StatsPhase;
+
+typedef struct {
+    unsigned long long loop_iterations;
+    unsigned long long picks;
+    unsigned long long procs_examined;
+    unsigned long long procs_retired;
+    unsigned long long arrival_checks;
+    unsigned long long arrivals_fired;
+    unsigned long long io_checks;
+    unsigned long long io_fired;
+    unsigned long long preemption_checks;
+    unsigned long long preemptions;
+    unsigned long long idle_fastforwards;
+    unsigned long long idle_time_skipped;
+    unsigned long long malloc_calls;
+    unsigned long long malloc_bytes;
+    unsigned long long free_calls;
+    double phase_ns[PHASE_COUNT];
+    unsigned long long phase_cycles[PHASE_COUNT];
+    double phase_start_ns[PHASE_COUNT];
+    unsigned long long phase_start_cycles[PHASE_COUNT];
+} SimStats;
+
+#ifdef PROBSCHED_STATS
+
+// Um conjunto de contadores por thread: as simulações de um varrimento
+// (--sweep) correm em paralelo e só as da thread principal são contadas.
+#ifdef __GNUC__
+#define STATS_THREAD_LOCAL __thread
+#else
+#define STATS_THREAD_LOCAL
+#endif
+
+extern STATS_THREAD_LOCAL SimStats g_stats;
+
+void  stats_phase_begin(StatsPhase phase);
+void  stats_phase_end(StatsPhase phase);
+void *stats_malloc(size_t size);
+void *stats_calloc(size_t n, size_t size);
+void *stats_realloc(void *ptr, size_t size);
+void  stats_free(void *ptr);
+
+#define STAT_INC(field)          (g_stats.field++)
+#define STAT_ADD(field, n)       (g_stats.field += (unsigned long long)(n))
+#define STAT_PHASE_BEGIN(phase)  stats_phase_begin(phase)
+#define STAT_PHASE_END(phase)    stats_phase_end(phase)
+#define sim_malloc(size)         stats_malloc(size)
+#define sim_calloc(n, size)      stats_calloc(n, size)
+#define sim_realloc(ptr, size)   stats_realloc(ptr, size)
+#define sim_free(ptr)            stats_free(ptr)
+
+#else
+
+#define STAT_INC(field)          ((void)0)
+#define STAT_ADD(field, n)       ((void)0)
+#define STAT_PHASE_BEGIN(phase)  ((void)0)
+#define STAT_PHASE_END(phase)    ((void)0)
+#define sim_malloc(size)         malloc(size)
+#define sim_calloc(n, size)      calloc(n, size)
+#define sim_realloc(ptr, size)   realloc(ptr, size)
+#define sim_free(ptr)            free(ptr)
+
+#endif
+
+int  stats_enabled(void);
+void stats_print(void);
+
+#endif
@@ -0,0 +1,93 @@
+#include "steady.h"
+#include <math.h>
+#include <string.h>
+
+void steady_init(SteadySeries *s) {
+    memset(s, 0, sizeof(*s));
+    s->bucket_size = STEADY_MSER_BATCH;
+}
+
+void steady_add(SteadySeries *s, double x) {
+    s->count++;
+    s->partial += x;
+    if (++s->partial_count < s->bucket_size) return;
+    if (s->buckets == STEADY_BUCKETS) {
+        // Cheio: funde pares e passa a blocos com o dobro das observações.
+        for (int k = 0; k < STEADY_BUCKETS / 2; k++) s->sum[k] = s->sum[2 * k] + s->sum[2 * k + 1];
+        s->buckets = STEADY_BUCKETS / 2;
+        s->bucket_size *= 2;
+        // O bloco em curso tinha o tamanho antigo: continua até ao novo.
+        if (s->partial_count < s->bucket_size) return;
+    }
+    s->sum[s->buckets++] = s->partial;
+    s->partial = 0.0;
+    s->partial_count = 0;
+}
+
+int steady_mser(const SteadySeries *s) {
+    int m = s->buckets;
+    if (m < 4) return 0;
+    // Somas dos sufixos das médias e dos quadrados, de trás para a frente.
+    double sum = 0.0, sq = 0.0;
+    double best = INFINITY;
+    int best_d = 0;
+    for (int d = m - 1; d >= 0; d--) {
+        double z = s->sum[d] / s->bucket_size;
+        sum += z;
+        sq += z * z;
+        if (d > m / 2) continue;
+        int n = m - d;
+        double mean = sum / n;
+        double sse = sq - n * mean * mean;
+        if (sse < 0.0) sse = 0.0;
+        double stat = sse / ((double)n * n);
+        if (stat <= best) {
+            best = stat;
+            best_d = d;
+        }
+    }
+    return best_d;
+}
+
+// Quantis 0.975 da t de Student para 1..30 graus de liberdade.
+static const double t975[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+static double t_quantile(int df) {
+    if (df < 1) return 0.0;
+    if (df <= 30) return t975[df - 1];
+    return 1.960 + 2.4 / df;
+}
+
+void steady_estimate(const SteadySeries *s, int skip, int batches, SteadyEstimate *out) {
+    memset(out, 0, sizeof(*out));
+    int m = s->buckets - skip;
+    if (m <= 0) return;
+    if (batches > STEADY_MAX_BATCHES) batches = STEADY_MAX_BATCHES;
+    if (batches > m) batches = m;
+    if (batches < 1) batches = 1;
+    // Cada lote tem o mesmo número de blocos; os que sobram são os mais
+    // próximos do corte e ficam de fora.
+    int per_batch = m / batches;
+    int first = s->buckets - per_batch * batches;
+    double means[STEADY_MAX_BATCHES];
+    double total = 0.0;
+    for (int b = 0; b < batches; b++) {
+        double sum = 0.0;
+        for (int k = 0; k < per_batch; k++) sum += s->sum[first + b * per_batch + k];
+        means[b] = sum / ((double)per_batch * s->bucket_size);
+        total += means[b];
+    }
+    out->batches = batches;
+    out->batch_size = per_batch * s->bucket_size;
+    out->used = out->batch_size * batches;
+    out->mean = total / batches;
+    if (batches < 2) return;
+    double var = 0.0;
+    for (int b = 0; b < batches; b++) var += (means[b] - out->mean) * (means[b] - out->mean);
+    var /= batches - 1;
+    out->half_width = t_quantile(batches - 1) * sqrt(var / batches);
+}
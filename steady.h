@@ -0,0 +1,44 @@
+#ifndef STEADY_H
+#define STEADY_H
+
+// Estimação em regime estacionário de uma série de observações (tempos de
+// resposta pela ordem de conclusão) com memória constante. As observações
+// são somadas em blocos de STEADY_MSER_BATCH; quando os STEADY_BUCKETS
+// blocos enchem, os pares adjacentes fundem-se e o tamanho dos blocos
+// duplica. No fim:
+//   - o transiente inicial é cortado pela regra MSER-5 (White, 1997) sobre
+//     as médias dos blocos: escolhe-se o corte d <= m/2 que minimiza o erro
+//     padrão da média dos blocos restantes;
+//   - o resto é agrupado em lotes e a média tem um intervalo de confiança de
+//     95% pelo método das médias de lotes (t de Student com lotes - 1 g.l.).
+#define STEADY_BUCKETS    4096
+#define STEADY_MSER_BATCH 5
+#define STEADY_MAX_BATCHES 64
+
+typedef struct {
+    double sum[STEADY_BUCKETS];
+    int buckets;
+    long long bucket_size;      // observações por bloco
+    double partial;             // bloco em curso
+    long long partial_count;
+    long long count;
+} SteadySeries;
+
+typedef struct {
+    double mean;
+    double half_width;          // meia largura do IC 95% (0 se não houver lotes)
+    int batches;
+    long long batch_size;       // observações por lote
+    long long used;             // observações depois do corte
+} SteadyEstimate;
+
+void steady_init(SteadySeries *s);
+void steady_add(SteadySeries *s, double x);
+// Blocos iniciais a descartar (MSER-5); multiplicar por bucket_size para
+// obter observações.
+int  steady_mser(const SteadySeries *s);
+// Média por lotes depois de descartar 'skip' blocos; 'batches' entre 2 e
+// STEADY_MAX_BATCHES (menos se não houver blocos suficientes).
+void steady_estimate(const SteadySeries *s, int skip, int batches, SteadyEstimate *out);
+
+#endif
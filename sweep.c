@@ -0,0 +1,299 @@
+#define _POSIX_C_SOURCE 200809L
+#include "sweep.h"
+#include "stats.h"
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+enum { KEY_Q, KEY_CS, KEY_AGING, KEY_AI, KEY_MLQ0, KEY_MLQ1, KEY_COUNT };
+
+static const char *key_names[KEY_COUNT] = { "q", "cs", "aging", "ai", "mlq0", "mlq1" };
+static const int key_min[KEY_COUNT] = { 1, 0, 1, 1, 1, 1 };
+
+typedef struct {
+    int *values;
+    int count;
+    int capacity;
+    int given;
+} SweepAxis;
+
+static int axis_push(SweepAxis *axis, int value, int max_points) {
+    if (axis->count == max_points) return 0;
+    if (axis->count == axis->capacity) {
+        int capacity = axis->capacity ? axis->capacity * 2 : 16;
+        int *grown = sim_realloc(axis->values, sizeof(int) * capacity);
+        if (!grown) return 0;
+        axis->values = grown;
+        axis->capacity = capacity;
+    }
+    axis->values[axis->count++] = value;
+    return 1;
+}
+
+static int parse_int(const char *text, char **end, int *out) {
+    errno = 0;
+    long v = strtol(text, end, 10);
+    if (*end == text || errno == ERANGE || v < INT_MIN || v > INT_MAX) return 0;
+    *out = (int)v;
+    return 1;
+}
+
+// Um valor ("5") ou um intervalo ("a..b", "a..b:N", "a..b:xN").
+static int parse_values(SweepAxis *axis, const char *text, int min, int max_points) {
+    char *end;
+    int first, last, step = 1, geometric = 0;
+    if (!parse_int(text, &end, &first)) return 0;
+    last = first;
+    if (strncmp(end, "..", 2) == 0) {
+        if (!parse_int(end + 2, &end, &last)) return 0;
+        if (*end == ':') {
+            const char *s = end + 1;
+            if (*s == 'x') { geometric = 1; s++; }
+            if (!parse_int(s, &end, &step)) return 0;
+            if (step < (geometric ? 2 : 1)) return 0;
+        }
+    }
+    if (*end != '\0' || first < min || last < first) return 0;
+    if (geometric && first == 0) return 0;
+
+    for (long long v = first; v <= last; v = geometric ? v * step : v + step) {
+        if (!axis_push(axis, (int)v, max_points)) return 0;
+    }
+    return 1;
+}
+
+int sweep_parse(const char *spec, const SimConfig *base, int max_points, SweepGrid *grid) {
+    SweepAxis axes[KEY_COUNT];
+    memset(axes, 0, sizeof(axes));
+    grid->points = NULL;
+    grid->count = 0;
+
+    size_t len = strlen(spec);
+    char *buf = sim_malloc(len + 1);
+    if (!buf) { fprintf(stderr, "Erro malloc varrimento\n"); return 0; }
+    memcpy(buf, spec, len + 1);
+
+    int ok = 1;
+    int current = -1;
+    // Divide à mão: o strtok juntaria vírgulas seguidas e esconderia itens vazios.
+    for (char *tok = buf, *next; tok && ok; tok = next) {
+        next = strchr(tok, ',');
+        if (next) *next++ = '\0';
+        char *eq = strchr(tok, '=');
+        if (*tok == '\0' || (eq && eq[1] == '\0')) {
+            fprintf(stderr, "Erro: Item vazio no varrimento '%s'\n", spec);
+            ok = 0;
+            break;
+        }
+        if (eq) {
+            *eq = '\0';
+            current = -1;
+            for (int k = 0; k < KEY_COUNT; k++) {
+                if (strcmp(tok, key_names[k]) == 0) current = k;
+            }
+            if (current < 0) {
+                fprintf(stderr, "Erro: Chave de varrimento '%s' desconhecida (q, cs, aging, ai, mlq0, mlq1)\n", tok);
+                ok = 0;
+                break;
+            }
+            if (axes[current].given) {
+                fprintf(stderr, "Erro: Chave de varrimento '%s' repetida\n", tok);
+                ok = 0;
+                break;
+            }
+            axes[current].given = 1;
+            tok = eq + 1;
+        } else if (current < 0) {
+            fprintf(stderr, "Erro: Varrimento deve começar por <chave>=<valores> ('%s')\n", tok);
+            ok = 0;
+            break;
+        }
+        if (!parse_values(&axes[current], tok, key_min[current], max_points)) {
+            fprintf(stderr, "Erro: Valores inválidos '%s' para '%s' (mínimo %d; a..b[:N|:xN])\n",
+                    tok, key_names[current], key_min[current]);
+            ok = 0;
+        }
+    }
+    sim_free(buf);
+
+    // Chaves omitidas: um só valor, o da configuração de base.
+    int defaults[KEY_COUNT] = { base->quantum, base->context_switch_cost, base->aging_threshold, base->aging_interval,
+                                base->mlq_quantum[0], base->mlq_quantum[1] };
+    long long total = 1;
+    for (int k = 0; k < KEY_COUNT && ok; k++) {
+        if (!axes[k].given) ok = axis_push(&axes[k], defaults[k], max_points);
+        total *= axes[k].count;
+        if (total > max_points) {
+            fprintf(stderr, "Erro: Varrimento com demasiados pontos (máx %d)\n", max_points);
+            ok = 0;
+        }
+    }
+
+    if (ok) {
+        grid->points = sim_malloc(sizeof(SweepPoint) * total);
+        if (!grid->points) { fprintf(stderr, "Erro malloc varrimento\n"); ok = 0; }
+    }
+    if (ok) {
+        // Produto cartesiano, com a última chave a variar mais depressa.
+        grid->count = (int)total;
+        for (int p = 0; p < grid->count; p++) {
+            int rest = p;
+            int value[KEY_COUNT];
+            for (int k = KEY_COUNT - 1; k >= 0; k--) {
+                value[k] = axes[k].values[rest % axes[k].count];
+                rest /= axes[k].count;
+            }
+            grid->points[p].quantum = value[KEY_Q];
+            grid->points[p].switch_cost = value[KEY_CS];
+            grid->points[p].aging_threshold = value[KEY_AGING];
+            grid->points[p].aging_interval = value[KEY_AI];
+            grid->points[p].mlq_quantum[0] = value[KEY_MLQ0];
+            grid->points[p].mlq_quantum[1] = value[KEY_MLQ1];
+        }
+    }
+
+    for (int k = 0; k < KEY_COUNT; k++) sim_free(axes[k].values);
+    return ok;
+}
+
+int sweep_varied_params(const SweepGrid *grid, const SimConfig *base) {
+    int params = 0;
+    for (int p = 0; p < grid->count; p++) {
+        const SweepPoint *pt = &grid->points[p];
+        if (pt->quantum != base->quantum) params |= SIM_PARAM_QUANTUM;
+        if (pt->aging_threshold != base->aging_threshold || pt->aging_interval != base->aging_interval)
+            params |= SIM_PARAM_AGING;
+        if (pt->mlq_quantum[0] != base->mlq_quantum[0] || pt->mlq_quantum[1] != base->mlq_quantum[1])
+            params |= SIM_PARAM_MLQ_QUANTA;
+    }
+    return params;
+}
+
+void sweep_param_keys(int params, char *buf, size_t size) {
+    snprintf(buf, size, "%s%s%s%s%s",
+             (params & SIM_PARAM_QUANTUM) ? "q" : "",
+             (params & SIM_PARAM_QUANTUM) && (params & ~SIM_PARAM_QUANTUM) ? ", " : "",
+             (params & SIM_PARAM_AGING) ? "aging/ai" : "",
+             (params & SIM_PARAM_AGING) && (params & SIM_PARAM_MLQ_QUANTA) ? ", " : "",
+             (params & SIM_PARAM_MLQ_QUANTA) ? "mlq0/mlq1" : "");
+}
+
+void sweep_free(SweepGrid *grid) {
+    sim_free(grid->points);
+    grid->points = NULL;
+    grid->count = 0;
+}
+
+void sweep_apply(const SimConfig *base, const SweepPoint *point, SimConfig *out) {
+    *out = *base;
+    out->quantum = point->quantum;
+    out->context_switch_cost = point->switch_cost;
+    out->aging_threshold = point->aging_threshold;
+    out->aging_interval = point->aging_interval;
+    out->mlq_quantum[0] = point->mlq_quantum[0];
+    out->mlq_quantum[1] = point->mlq_quantum[1];
+}
+
+void sweep_point_config(const SimConfig *base, const SweepPoint *point, SimContext *arena, SimConfig *out) {
+    sweep_apply(base, point, out);
+    out->trace_path = NULL;
+    out->series_path = NULL;
+    out->gantt_ascii = 0;
+    out->gantt_csv_path = NULL;
+    out->on_process = NULL;
+    out->log_level = SIM_LOG_ERROR;
+    out->arena = arena;
+}
+
+int sweep_default_jobs(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+typedef struct {
+    const SweepGrid *grid;
+    const SimWorkload *workload;
+    const SimConfig *base;
+    SimResults *results;
+    ResultCache *cache;
+    uint64_t workload_hash;
+    pthread_mutex_t lock;
+    int next;
+    int status;
+} SweepShared;
+
+// Cada thread tira o índice seguinte da fila partilhada e simula-o na sua
+// própria arena; a carga e a grelha só são lidas.
+static void *sweep_worker(void *arg) {
+    SweepShared *sh = (SweepShared *)arg;
+    SimContext arena;
+    if (!simctx_init(&arena, simctx_estimate(sh->workload->count))) {
+        pthread_mutex_lock(&sh->lock);
+        if (sh->status == SIM_OK) sh->status = SIM_ERR_MEMORY;
+        pthread_mutex_unlock(&sh->lock);
+        return NULL;
+    }
+
+    for (;;) {
+        pthread_mutex_lock(&sh->lock);
+        int k = (sh->status == SIM_OK && sh->next < sh->grid->count) ? sh->next++ : -1;
+        pthread_mutex_unlock(&sh->lock);
+        if (k < 0) break;
+
+        SimConfig cfg;
+        sweep_point_config(sh->base, &sh->grid->points[k], &arena, &cfg);
+
+        simctx_reset(&arena);
+        int status = cache_simulate(sh->cache, sh->workload_hash, sh->workload, &cfg, &sh->results[k]);
+        if (status != SIM_OK) {
+            pthread_mutex_lock(&sh->lock);
+            if (sh->status == SIM_OK) sh->status = status;
+            pthread_mutex_unlock(&sh->lock);
+        }
+    }
+    simctx_destroy(&arena);
+    return NULL;
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1.0e3 + ts.tv_nsec / 1.0e6;
+}
+
+int sweep_run(const SweepGrid *grid, const SimWorkload *workload, const SimConfig *base,
+              int jobs, ResultCache *cache, SimResults *results, double *wall_ms) {
+    double start = now_ms();
+    SweepShared sh;
+    sh.grid = grid;
+    sh.workload = workload;
+    sh.base = base;
+    sh.results = results;
+    sh.cache = cache;
+    sh.workload_hash = cache ? cache_hash_workload(workload) : 0;
+    sh.next = 0;
+    sh.status = SIM_OK;
+    pthread_mutex_init(&sh.lock, NULL);
+
+    if (jobs > grid->count) jobs = grid->count;
+    if (jobs < 1) jobs = 1;
+    pthread_t *threads = sim_malloc(sizeof(pthread_t) * jobs);
+    int started = 0;
+    if (threads) {
+        for (; started < jobs; started++) {
+            if (pthread_create(&threads[started], NULL, sweep_worker, &sh) != 0) break;
+        }
+    }
+    // Sem threads (ou sem nenhuma criada) o varrimento corre no chamador.
+    if (started == 0) sweep_worker(&sh);
+    for (int t = 0; t < started; t++) pthread_join(threads[t], NULL);
+    sim_free(threads);
+    pthread_mutex_destroy(&sh.lock);
+
+    if (wall_ms) *wall_ms = now_ms() - start;
+    return sh.status;
+}
@@ -0,0 +1,59 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "probsched.h"
+#include "cache.h"
+
+// Varrimento de parâmetros (--sweep): uma especificação como
+// "q=1..64:x2,cs=0,1,5,aging=10..40:10" é expandida no produto cartesiano
+// dos valores de cada chave e todos os pontos são simulados sobre a mesma
+// carga (imutável), em paralelo, cada thread com a sua arena.
+//
+// Chaves: q (quantum), cs (custo da troca de contexto), aging (limiar do
+// aging), ai (intervalo do aging) e mlq0/mlq1 (quanta das filas RR do mlq).
+// Valores: lista separada por vírgulas e/ou intervalos a..b (passo 1),
+// a..b:N (passo aditivo) ou a..b:xN (passo multiplicativo). Chaves omitidas
+// ficam com o valor da configuração.
+#define SWEEP_MAX_POINTS 100000
+
+typedef struct {
+    int quantum;
+    int switch_cost;
+    int aging_threshold;
+    int aging_interval;
+    int mlq_quantum[MLQ_RR_LEVELS];
+} SweepPoint;
+
+typedef struct {
+    SweepPoint *points;
+    int count;
+} SweepGrid;
+
+// Devolve 1 em sucesso; em erro escreve a mensagem no stderr e devolve 0.
+// 'max_points' limita a grelha (SWEEP_MAX_POINTS com resultados em memória).
+int  sweep_parse(const char *spec, const SimConfig *base, int max_points, SweepGrid *grid);
+void sweep_free(SweepGrid *grid);
+// Parâmetros (SIM_PARAM_*) em que algum ponto difere de 'base', para avisar
+// das chaves que o algoritmo não usa (ver sim_algorithm_params).
+int  sweep_varied_params(const SweepGrid *grid, const SimConfig *base);
+// Nomes das chaves desses parâmetros ("q, aging/ai"), para mensagens.
+void sweep_param_keys(int params, char *buf, size_t size);
+
+// Configuração do ponto: cópia de 'base' com os parâmetros do ponto.
+void sweep_apply(const SimConfig *base, const SweepPoint *point, SimConfig *out);
+// Como sweep_apply, para executar o ponto num varrimento: sem trace, Gantt
+// nem resultados por processo, log só de erros e a arena dada.
+void sweep_point_config(const SimConfig *base, const SweepPoint *point, SimContext *arena, SimConfig *out);
+
+// Número de threads por omissão (CPUs disponíveis).
+int  sweep_default_jobs(void);
+
+// Simula todos os pontos com até 'jobs' threads; results[k] corresponde a
+// grid->points[k]. Trace, Gantt e resultados por processo são desligados e
+// o log só recebe erros. Com 'cache' (NULL = sem cache) os pontos já
+// calculados são lidos da cache de resultados. Devolve SIM_OK ou o estado do
+// primeiro ponto que falhou; em *wall_ms fica o tempo de parede total.
+int  sweep_run(const SweepGrid *grid, const SimWorkload *workload, const SimConfig *base,
+               int jobs, ResultCache *cache, SimResults *results, double *wall_ms);
+
+#endif
@@ -0,0 +1,162 @@
+#include "timeline.h"
+#include "stats.h"
+#include "sim.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#define GANTT_WIDTH    72
+#define GANTT_MAX_ROWS 40
+
+static const char *reason_names[] = {
+    "terminou", "I/O", "quantum", "preempção", "T Max", "troca"
+};
+
+const char *timeline_reason_name(int reason) {
+    if (reason < 0 || reason > TL_END_SWITCH) return "?";
+    return reason_names[reason];
+}
+
+int timeline_init(Timeline *tl, SimRun *run, int capacity_hint) {
+    tl->run = run;
+    tl->size = 0;
+    tl->open = 0;
+    tl->capacity = (capacity_hint > 16) ? capacity_hint : 16;
+    tl->items = simctx_alloc(run->arena, sizeof(TimelineInterval) * tl->capacity);
+    if (!tl->items) {
+        // Sem memória os intervalos continuam a ser impressos, mas não guardados.
+        sim_warn(run, "Erro malloc linha temporal\n");
+        tl->capacity = 0;
+        return 0;
+    }
+    return 1;
+}
+
+void timeline_free(Timeline *tl) {
+    simctx_free(tl->run->arena, tl->items);
+    tl->items = NULL;
+    tl->size = 0;
+    tl->capacity = 0;
+    tl->open = 0;
+}
+
+static void timeline_append(Timeline *tl, const TimelineInterval *iv) {
+    if (tl->size == tl->capacity) {
+        if (tl->capacity == 0) return;
+        TimelineInterval *grown = simctx_realloc(tl->run->arena, tl->items, sizeof(TimelineInterval) * tl->capacity,
+                                                   sizeof(TimelineInterval) * tl->capacity * 2);
+        if (!grown) return;
+        tl->items = grown;
+        tl->capacity *= 2;
+    }
+    tl->items[tl->size++] = *iv;
+}
+
+void timeline_stop(Timeline *tl, TimelineEndReason reason) {
+    if (!tl->open) return;
+    TimelineInterval *iv = &tl->current;
+    iv->reason = reason;
+    sim_log(tl->run, "%-5d | P%d executou %d-%d (%d unidades, fim: %s)\n",
+           iv->end, iv->pid, iv->start, iv->end, iv->end - iv->start, reason_names[reason]);
+    trace_cpu_run(tl->run->trace, iv->pid, iv->start, iv->end);
+    series_busy(tl->run->series, iv->start, iv->end);
+    timeline_append(tl, iv);
+    tl->open = 0;
+}
+
+void timeline_run(Timeline *tl, int pid, int start, int end) {
+    if (end <= start) return;
+    if (tl->open) {
+        if (tl->current.pid == pid && tl->current.end == start) {
+            tl->current.end = end;
+            return;
+        }
+        timeline_stop(tl, TL_END_SWITCH);
+    }
+    tl->current.pid = pid;
+    tl->current.start = start;
+    tl->current.end = end;
+    tl->current.cpu = 0;
+    tl->current.reason = TL_END_SWITCH;
+    tl->open = 1;
+}
+
+void timeline_finish(Timeline *tl) {
+    timeline_stop(tl, TL_END_TIME_LIMIT);
+}
+
+static void print_gantt_ascii(const Timeline *tl, const Process *list, int count) {
+    int t0 = tl->items[0].start;
+    int t1 = tl->items[0].end;
+    for (int k = 1; k < tl->size; k++) {
+        if (tl->items[k].start < t0) t0 = tl->items[k].start;
+        if (tl->items[k].end > t1) t1 = tl->items[k].end;
+    }
+    int span = t1 - t0;
+    int bucket = (span + GANTT_WIDTH - 1) / GANTT_WIDTH;
+    if (bucket < 1) bucket = 1;
+    int columns = (span + bucket - 1) / bucket;
+    int rows = (count < GANTT_MAX_ROWS) ? count : GANTT_MAX_ROWS;
+    SimRun *run = tl->run;
+    char line[GANTT_WIDTH + 1];
+
+    sim_log(run, "\n--- Gantt (1 coluna = %d unidade%s, '#' = em execução) ---\n", bucket, bucket > 1 ? "s" : "");
+    for (int r = 0; r < rows; r++) {
+        memset(line, '.', columns);
+        line[columns] = '\0';
+        for (int k = 0; k < tl->size; k++) {
+            const TimelineInterval *iv = &tl->items[k];
+            if (iv->pid != list[r].spec->id) continue;
+            int first = (iv->start - t0) / bucket;
+            int last = (iv->end - 1 - t0) / bucket;
+            for (int c = first; c <= last && c < columns; c++) line[c] = '#';
+        }
+        sim_log(run, "P%-4d|%s|\n", list[r].spec->id, line);
+    }
+    if (rows < count) sim_log(run, "(... %d processos omitidos)\n", count - rows);
+    sim_log(run, "     %-*d%d\n", columns, t0, t1);
+}
+
+static void write_gantt_csv(const Timeline *tl, const char *path) {
+    SimRun *run = tl->run;
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        sim_warn(run, "Erro ao criar ficheiro CSV do Gantt: %s\n", strerror(errno));
+        return;
+    }
+    fprintf(f, "pid,start,end,cpu,reason\n");
+    for (int k = 0; k < tl->size; k++) {
+        const TimelineInterval *iv = &tl->items[k];
+        fprintf(f, "%d,%d,%d,%d,%s\n", iv->pid, iv->start, iv->end, iv->cpu, reason_names[iv->reason]);
+    }
+    fclose(f);
+    sim_log(run, "Gantt CSV escrito em '%s' (%d intervalos).\n", path, tl->size);
+}
+
+void timeline_report(const Timeline *tl, const Process *list, int count) {
+    SimRun *run = tl->run;
+    if (tl->size == 0) return;
+    long long busy = 0;
+    int longest = 0;
+    int by_reason[TL_END_SWITCH + 1] = {0};
+    for (int k = 0; k < tl->size; k++) {
+        int len = tl->items[k].end - tl->items[k].start;
+        busy += len;
+        if (len > longest) longest = len;
+        by_reason[tl->items[k].reason]++;
+    }
+
+    sim_log(run, "\n--- Linha Temporal (intervalos RLE) ---\n");
+    sim_log(run, "Intervalos de Execução:        %d (média %.2f, máx %d unidades)\n",
+           tl->size, (double)busy / tl->size, longest);
+    sim_log(run, "Tempo de CPU nos Intervalos:   %lld\n", busy);
+    sim_log(run, "Fim dos Intervalos:            ");
+    for (int r = 0; r <= TL_END_SWITCH; r++) {
+        if (by_reason[r] > 0) sim_log(run, "%s=%d ", reason_names[r], by_reason[r]);
+    }
+    sim_log(run, "\n");
+
+    const SimConfig *cfg = run->config;
+    if (cfg->gantt_ascii) print_gantt_ascii(tl, list, count);
+    if (cfg->gantt_csv_path && cfg->gantt_csv_path[0] != '\0') write_gantt_csv(tl, cfg->gantt_csv_path);
+}
@@ -0,0 +1,46 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include "process.h"
+
+// Linha temporal da CPU em intervalos comprimidos (RLE): ticks contíguos do
+// mesmo processo formam um único intervalo, impresso uma vez quando termina.
+// Os intervalos ficam guardados para o Gantt e para métricas posteriores.
+typedef enum {
+    TL_END_FINISHED,     // burst de CPU concluído
+    TL_END_IO,           // saiu para I/O durante a execução
+    TL_END_QUANTUM,      // fim do quantum
+    TL_END_PREEMPTED,    // preemptado por outro processo
+    TL_END_TIME_LIMIT,   // fim da simulação (T Max / horizonte)
+    TL_END_SWITCH        // substituído sem motivo registado
+} TimelineEndReason;
+
+typedef struct {
+    int pid;
+    int start;
+    int end;
+    int cpu;
+    int reason;
+} TimelineInterval;
+
+struct SimRun;
+
+typedef struct {
+    struct SimRun *run;         // destino das mensagens, trace e opções de Gantt
+    TimelineInterval *items;
+    int size;
+    int capacity;
+    TimelineInterval current;   // intervalo aberto (se open)
+    int open;
+} Timeline;
+
+int  timeline_init(Timeline *tl, struct SimRun *run, int capacity_hint);
+void timeline_free(Timeline *tl);
+void timeline_run(Timeline *tl, int pid, int start, int end);
+void timeline_stop(Timeline *tl, TimelineEndReason reason);
+void timeline_finish(Timeline *tl);
+void timeline_report(const Timeline *tl, const Process *list, int count);
+
+const char *timeline_reason_name(int reason);
+
+#endif
@@ -0,0 +1,163 @@
+#include "trace.h"
+#include "stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TRACE_FILE_BUFFER (1 << 20)
+
+// Faixas (tid) dentro do processo do trace: a CPU e, a partir de
+// TRACE_TID_IO, uma faixa de I/O por dispositivo.
+#define TRACE_TID_CPU 1
+#define TRACE_TID_IO  2
+
+struct TraceWriter {
+    FILE *file;
+    char *file_buffer;
+    TraceEvent *events;
+    int used;
+    long long written;
+    // Slice de execução ainda aberta; ticks contíguos do mesmo processo
+    // são fundidos aqui antes de entrarem no buffer.
+    int run_pid;
+    long long run_start;
+    long long run_end;
+};
+
+static void trace_write_event(TraceWriter *tw, const TraceEvent *ev) {
+    FILE *f = tw->file;
+    switch (ev->kind) {
+        case TRACE_EV_RUN:
+            fprintf(f, ",\n{\"name\":\"P%d\",\"cat\":\"cpu\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%d,\"args\":{\"pid\":%d}}",
+                    ev->pid, ev->ts, ev->dur, TRACE_TID_CPU, ev->pid);
+            break;
+        case TRACE_EV_SWITCH:
+            fprintf(f, ",\n{\"name\":\"Context Switch\",\"cat\":\"switch\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%d,\"args\":{\"from\":%d,\"to\":%d}}",
+                    ev->ts, ev->dur, TRACE_TID_CPU, ev->other, ev->pid);
+            break;
+        case TRACE_EV_IDLE:
+            fprintf(f, ",\n{\"name\":\"Idle\",\"cat\":\"idle\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%d}",
+                    ev->ts, ev->dur, TRACE_TID_CPU);
+            break;
+        case TRACE_EV_IO:
+            // Os I/O de processos diferentes sobrepõem-se: eventos assíncronos.
+            fprintf(f, ",\n{\"name\":\"I/O P%d\",\"cat\":\"io\",\"ph\":\"b\",\"id\":%d,\"ts\":%lld,\"pid\":1,\"tid\":%d}"
+                       ",\n{\"name\":\"I/O P%d\",\"cat\":\"io\",\"ph\":\"e\",\"id\":%d,\"ts\":%lld,\"pid\":1,\"tid\":%d}",
+                    ev->pid, ev->pid, ev->ts, TRACE_TID_IO + ev->other, ev->pid, ev->pid, ev->ts + ev->dur,
+                    TRACE_TID_IO + ev->other);
+            break;
+        case TRACE_EV_ARRIVAL:
+            fprintf(f, ",\n{\"name\":\"Arrival P%d\",\"cat\":\"arrival\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%lld,\"pid\":1,\"tid\":%d}",
+                    ev->pid, ev->ts, TRACE_TID_CPU);
+            break;
+        case TRACE_EV_PREEMPT:
+            fprintf(f, ",\n{\"name\":\"Preempt P%d\",\"cat\":\"preempt\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%lld,\"pid\":1,\"tid\":%d,\"args\":{\"by\":%d}}",
+                    ev->pid, ev->ts, TRACE_TID_CPU, ev->other);
+            break;
+    }
+}
+
+static void trace_flush_buffer(TraceWriter *tw) {
+    for (int i = 0; i < tw->used; i++) trace_write_event(tw, &tw->events[i]);
+    tw->written += tw->used;
+    tw->used = 0;
+}
+
+static void trace_push(TraceWriter *tw, int kind, long long ts, long long dur, int pid, int other) {
+    if (tw->used == TRACE_BUFFER_EVENTS) trace_flush_buffer(tw);
+    TraceEvent *ev = &tw->events[tw->used++];
+    ev->kind = kind;
+    ev->ts = ts;
+    ev->dur = dur;
+    ev->pid = pid;
+    ev->other = other;
+}
+
+static void trace_close_run(TraceWriter *tw) {
+    if (tw->run_pid == -1) return;
+    trace_push(tw, TRACE_EV_RUN, tw->run_start, tw->run_end - tw->run_start, tw->run_pid, -1);
+    tw->run_pid = -1;
+}
+
+TraceWriter *trace_open(const char *path, const char *label) {
+    TraceWriter *tw = sim_malloc(sizeof(TraceWriter));
+    if (!tw) return NULL;
+    tw->events = sim_malloc(sizeof(TraceEvent) * TRACE_BUFFER_EVENTS);
+    tw->file_buffer = sim_malloc(TRACE_FILE_BUFFER);
+    tw->file = (tw->events && tw->file_buffer) ? fopen(path, "w") : NULL;
+    if (!tw->file) {
+        sim_free(tw->events); sim_free(tw->file_buffer); sim_free(tw);
+        return NULL;
+    }
+    setvbuf(tw->file, tw->file_buffer, _IOFBF, TRACE_FILE_BUFFER);
+    tw->used = 0;
+    tw->written = 0;
+    tw->run_pid = -1;
+
+    fprintf(tw->file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(tw->file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"probsched %s\"}}", label);
+    fprintf(tw->file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"CPU 0\"}}", TRACE_TID_CPU);
+    return tw;
+}
+
+void trace_io_track(TraceWriter *tw, int device, const char *name) {
+    if (!tw) return;
+    fprintf(tw->file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+            TRACE_TID_IO + device, name);
+}
+
+long long trace_close(TraceWriter *tw) {
+    if (!tw) return 0;
+    trace_close_run(tw);
+    trace_flush_buffer(tw);
+    fprintf(tw->file, "\n]}\n");
+    fclose(tw->file);
+    long long written = tw->written;
+    sim_free(tw->file_buffer);
+    sim_free(tw->events);
+    sim_free(tw);
+    return written;
+}
+
+long long trace_event_count(const TraceWriter *tw) {
+    return tw ? tw->written + tw->used : 0;
+}
+
+void trace_cpu_run(TraceWriter *tw, int pid, int start, int end) {
+    if (!tw || end <= start) return;
+    if (tw->run_pid == pid && tw->run_end == start) {
+        tw->run_end = end;
+        return;
+    }
+    trace_close_run(tw);
+    tw->run_pid = pid;
+    tw->run_start = start;
+    tw->run_end = end;
+}
+
+void trace_context_switch(TraceWriter *tw, int from_pid, int to_pid, int start, int cost) {
+    if (!tw || cost <= 0) return;
+    trace_close_run(tw);
+    trace_push(tw, TRACE_EV_SWITCH, start, cost, to_pid, from_pid);
+}
+
+void trace_idle(TraceWriter *tw, int start, int end) {
+    if (!tw || end <= start) return;
+    trace_close_run(tw);
+    trace_push(tw, TRACE_EV_IDLE, start, end - start, -1, -1);
+}
+
+void trace_io(TraceWriter *tw, int device, int pid, int start, int end) {
+    if (!tw || end <= start) return;
+    trace_push(tw, TRACE_EV_IO, start, end - start, pid, device);
+}
+
+void trace_arrival(TraceWriter *tw, int pid, int time) {
+    if (!tw) return;
+    trace_push(tw, TRACE_EV_ARRIVAL, time, 0, pid, -1);
+}
+
+void trace_preemption(TraceWriter *tw, int victim_pid, int by_pid, int time) {
+    if (!tw) return;
+    trace_close_run(tw);
+    trace_push(tw, TRACE_EV_PREEMPT, time, 0, victim_pid, by_pid);
+}
@@ -0,0 +1,46 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// Exportação do escalonamento simulado no formato Trace Event (Chrome /
+// Perfetto). Os eventos são acumulados num buffer pré-alocado e escritos em
+// blocos com I/O bufferizado. Cada execução tem o seu escritor; com
+// tw == NULL (trace desligado) todas as chamadas retornam de imediato.
+// 1 unidade de tempo simulado = 1 us no trace.
+#define TRACE_BUFFER_EVENTS (1 << 16)
+
+typedef enum {
+    TRACE_EV_RUN,        // slice de execução na CPU (ticks contíguos fundidos)
+    TRACE_EV_SWITCH,     // troca de contexto
+    TRACE_EV_IDLE,       // CPU ociosa
+    TRACE_EV_IO,         // I/O de um processo (pode sobrepor-se a outros)
+    TRACE_EV_ARRIVAL,    // instante: chegada / libertação de job
+    TRACE_EV_PREEMPT     // instante: preempção
+} TraceEventKind;
+
+typedef struct {
+    long long ts;
+    long long dur;
+    int pid;
+    int other;           // processo de origem (troca), preemptor ou dispositivo (I/O)
+    int kind;
+} TraceEvent;
+
+typedef struct TraceWriter TraceWriter;
+
+// NULL se o ficheiro não puder ser criado (errno indica o motivo).
+TraceWriter *trace_open(const char *path, const char *label);
+// Fecha o ficheiro e devolve o número de eventos escritos.
+long long trace_close(TraceWriter *tw);
+long long trace_event_count(const TraceWriter *tw);
+
+void trace_cpu_run(TraceWriter *tw, int pid, int start, int end);
+void trace_context_switch(TraceWriter *tw, int from_pid, int to_pid, int start, int cost);
+void trace_idle(TraceWriter *tw, int start, int end);
+// Nomeia a faixa de I/O do dispositivo (0 sem dispositivos: atraso puro);
+// chamar logo a seguir a trace_open, antes de qualquer evento.
+void trace_io_track(TraceWriter *tw, int device, const char *name);
+void trace_io(TraceWriter *tw, int device, int pid, int start, int end);
+void trace_arrival(TraceWriter *tw, int pid, int time);
+void trace_preemption(TraceWriter *tw, int victim_pid, int by_pid, int time);
+
+#endif
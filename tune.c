@@ -0,0 +1,231 @@
+#include "tune.h"
+#include "stats.h"
+#include <stdio.h>
+#include <string.h>
+
+static const int tune_quanta[] = { 1, 2, 3, 4, 5, 6, 8, 10, 12, 16, 20, 24, 32, 48, 64 };
+static const int tune_aging[] = { 1, 2, 3, 5, 8, 10, 15, 20, 30, 40, 60, 80, 120 };
+
+#define COUNT_OF(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+static const char *objective_names[] = { "p99", "avg", "turnaround" };
+
+int tune_parse_objective(const char *name) {
+    for (int k = 0; k <= TUNE_AVG_TURNAROUND; k++) {
+        if (strcmp(name, objective_names[k]) == 0) return k;
+    }
+    return -1;
+}
+
+const char *tune_objective_name(int objective) {
+    if (objective < 0 || objective > TUNE_AVG_TURNAROUND) return "?";
+    return objective_names[objective];
+}
+
+int tune_algorithm_supported(const char *algorithm) {
+    return sim_algorithm_params(algorithm) != 0;
+}
+
+void tune_point_flags(const char *algorithm, const SweepPoint *point, char *buf, size_t size) {
+    if (strcmp(algorithm, "prio-p") == 0) snprintf(buf, size, "--aging %d", point->aging_threshold);
+    else if (strcmp(algorithm, "mlq") == 0) snprintf(buf, size, "--mlq-q %d,%d", point->mlq_quantum[0], point->mlq_quantum[1]);
+    else snprintf(buf, size, "-q %d", point->quantum);
+}
+
+// Espaço de procura do algoritmo, a partir do ponto da configuração de base.
+static int build_candidates(const char *algorithm, const SweepPoint *base, TuneCandidate **out) {
+    int count;
+    if (strcmp(algorithm, "prio-p") == 0) count = COUNT_OF(tune_aging);
+    else if (strcmp(algorithm, "mlq") == 0) count = COUNT_OF(tune_quanta) * (COUNT_OF(tune_quanta) + 1) / 2;
+    else count = COUNT_OF(tune_quanta);
+
+    TuneCandidate *c = sim_calloc(count, sizeof(TuneCandidate));
+    if (!c) return 0;
+    int n = 0;
+    if (strcmp(algorithm, "prio-p") == 0) {
+        for (int a = 0; a < COUNT_OF(tune_aging); a++) {
+            c[n].point = *base;
+            c[n++].point.aging_threshold = tune_aging[a];
+        }
+    } else if (strcmp(algorithm, "mlq") == 0) {
+        // Q1 serve processos menos prioritários: nunca com quantum menor que Q0.
+        for (int i = 0; i < COUNT_OF(tune_quanta); i++) {
+            for (int j = i; j < COUNT_OF(tune_quanta); j++) {
+                c[n].point = *base;
+                c[n].point.mlq_quantum[0] = tune_quanta[i];
+                c[n++].point.mlq_quantum[1] = tune_quanta[j];
+            }
+        }
+    } else {
+        for (int q = 0; q < COUNT_OF(tune_quanta); q++) {
+            c[n].point = *base;
+            c[n++].point.quantum = tune_quanta[q];
+        }
+    }
+    *out = c;
+    return n;
+}
+
+static double objective_value(int objective, const SimResults *r) {
+    switch (objective) {
+        case TUNE_AVG_WAIT:       return r->avg_waiting_time;
+        case TUNE_AVG_TURNAROUND: return r->avg_turnaround_time;
+        default:                  return r->p99_waiting_time;
+    }
+}
+
+static int dominates(const TuneCandidate *a, const TuneCandidate *b) {
+    return a->objective <= b->objective && a->overhead <= b->overhead &&
+           (a->objective < b->objective || a->overhead < b->overhead);
+}
+
+// Nível de Pareto de cada candidato vivo: retira sucessivamente os não
+// dominados (O(n^2) por nível; n é no máximo algumas centenas).
+static void assign_fronts(TuneCandidate **alive, int n) {
+    for (int i = 0; i < n; i++) alive[i]->front = -1;
+    int assigned = 0;
+    for (int level = 0; assigned < n; level++) {
+        // Marca provisória (n + nível) para que os candidatos deste nível
+        // ainda contem como dominadores uns dos outros.
+        for (int i = 0; i < n; i++) {
+            TuneCandidate *a = alive[i];
+            if (a->front != -1) continue;
+            int dominated = 0;
+            for (int j = 0; j < n && !dominated; j++) {
+                const TuneCandidate *b = alive[j];
+                if (j != i && (b->front == -1 || b->front >= n) && dominates(b, a)) dominated = 1;
+            }
+            if (!dominated) a->front = n + level;
+        }
+        for (int i = 0; i < n; i++) {
+            if (alive[i]->front == n + level) { alive[i]->front = level; assigned++; }
+        }
+    }
+}
+
+// Dentro do orçamento primeiro, depois frente de Pareto, objetivo e sobrecarga
+// (empates pela ordem do espaço de procura).
+static int compare_alive(const void *x, const void *y) {
+    const TuneCandidate *a = *(const TuneCandidate *const *)x;
+    const TuneCandidate *b = *(const TuneCandidate *const *)y;
+    if (a->feasible != b->feasible) return b->feasible - a->feasible;
+    if (a->front != b->front) return a->front - b->front;
+    if (a->objective != b->objective) return a->objective < b->objective ? -1 : 1;
+    if (a->overhead != b->overhead) return a->overhead < b->overhead ? -1 : 1;
+    return (a > b) - (a < b);
+}
+
+// Melhor da ronda final: menor objetivo dentro do orçamento; se nenhum
+// cumprir o orçamento, o de menor sobrecarga.
+static int pick_best(TuneCandidate *const *alive, int n, const TuneCandidate *base) {
+    const TuneCandidate *best = alive[0];
+    for (int i = 1; i < n; i++) {
+        const TuneCandidate *c = alive[i];
+        if (best->feasible) {
+            if (c->feasible && (c->objective < best->objective ||
+                                (c->objective == best->objective && c->overhead < best->overhead))) best = c;
+        } else if (c->overhead < best->overhead) {
+            best = c;
+        }
+    }
+    return (int)(best - base);
+}
+
+// Avalia os candidatos vivos com o horizonte dado (-1 = sem limite).
+static int evaluate(const SimWorkload *workload, const SimConfig *base, const TuneOptions *options,
+                    TuneReport *report, TuneCandidate **alive, int n, int horizon, int rung) {
+    SweepGrid grid;
+    grid.count = n;
+    grid.points = sim_malloc(sizeof(SweepPoint) * n);
+    SimResults *results = sim_malloc(sizeof(SimResults) * n);
+    if (!grid.points || !results) {
+        sim_free(grid.points);
+        sim_free(results);
+        return SIM_ERR_MEMORY;
+    }
+    for (int i = 0; i < n; i++) grid.points[i] = alive[i]->point;
+
+    SimConfig cfg = *base;
+    cfg.max_simulation_time = horizon;
+    double ms = 0.0;
+    int status = sweep_run(&grid, workload, &cfg, options->jobs, options->cache, results, &ms);
+    report->wall_ms += ms;
+
+    for (int i = 0; i < n && status == SIM_OK; i++) {
+        TuneCandidate *c = alive[i];
+        c->result = results[i];
+        c->objective = objective_value(options->objective, &results[i]);
+        c->overhead = results[i].final_time > 0 ? 100.0 * results[i].context_switch_cost / results[i].final_time : 0.0;
+        c->feasible = options->switch_budget < 0 || c->overhead <= options->switch_budget;
+        c->rung = rung;
+        report->simulated_time += results[i].final_time;
+    }
+    sim_free(grid.points);
+    sim_free(results);
+    return status;
+}
+
+int tune_run(const SimWorkload *workload, const SimConfig *base, const TuneOptions *options, TuneReport *report) {
+    memset(report, 0, sizeof(*report));
+    report->best = -1;
+    if (!tune_algorithm_supported(base->algorithm)) return SIM_ERR_ARGS;
+
+    SweepPoint origin;
+    origin.quantum = base->quantum;
+    origin.switch_cost = base->context_switch_cost;
+    origin.aging_threshold = base->aging_threshold;
+    origin.aging_interval = base->aging_interval;
+    origin.mlq_quantum[0] = base->mlq_quantum[0] > 0 ? base->mlq_quantum[0] : base->quantum;
+    origin.mlq_quantum[1] = base->mlq_quantum[1] > 0 ? base->mlq_quantum[1] : base->quantum * 2;
+    report->count = build_candidates(base->algorithm, &origin, &report->candidates);
+    if (report->count == 0) return SIM_ERR_MEMORY;
+
+    TuneCandidate **alive = sim_malloc(sizeof(TuneCandidate *) * report->count);
+    if (!alive) { tune_free(report); return SIM_ERR_MEMORY; }
+    int n = report->count;
+    for (int i = 0; i < n; i++) alive[i] = &report->candidates[i];
+
+    // Sem limite de tempo, os prefixos são frações do tempo final de uma
+    // execução piloto com a configuração de base.
+    int full = base->max_simulation_time;
+    int status = SIM_OK;
+    if (full == -1) {
+        SweepGrid pilot_grid = { &origin, 1 };
+        SimResults pilot;
+        double ms = 0.0;
+        status = sweep_run(&pilot_grid, workload, base, 1, options->cache, &pilot, &ms);
+        report->wall_ms += ms;
+        report->simulated_time += pilot.final_time;
+        full = pilot.final_time;
+    }
+
+    int rungs = 1;
+    while (rungs < TUNE_MAX_RUNGS && (n >> rungs) >= 1 && (full >> rungs) >= TUNE_MIN_HORIZON) rungs++;
+    report->rungs = rungs;
+
+    for (int r = 0; r < rungs && status == SIM_OK; r++) {
+        int last = (r == rungs - 1);
+        int horizon = last ? base->max_simulation_time : full >> (rungs - 1 - r);
+        report->horizon[r] = horizon;
+        report->evaluated[r] = n;
+        status = evaluate(workload, base, options, report, alive, n, horizon, r);
+        if (status != SIM_OK) break;
+
+        assign_fronts(alive, n);
+        if (last) {
+            report->best = pick_best(alive, n, report->candidates);
+        } else {
+            qsort(alive, n, sizeof(TuneCandidate *), compare_alive);
+            n = (n + 1) / 2;
+        }
+    }
+
+    sim_free(alive);
+    return status;
+}
+
+void tune_free(TuneReport *report) {
+    sim_free(report->candidates);
+    report->candidates = NULL;
+    report->count = 0;
+}
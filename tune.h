@@ -0,0 +1,62 @@
+#ifndef TUNE_H
+#define TUNE_H
+
+#include "sweep.h"
+
+// Afinação automática (--tune): procura o quantum (lottery, stride), o
+// limiar de aging (prio-p) ou os quanta das filas do mlq que minimizam um
+// objetivo de latência para a carga dada, por successive halving. Todos os
+// candidatos são avaliados em paralelo (sweep_run) num prefixo curto da
+// simulação (max_simulation_time); só a melhor metade passa à ronda
+// seguinte, com o dobro do horizonte, até à simulação completa. A ordem de
+// cada ronda é pela frente de Pareto (latência vs sobrecarga de trocas) e
+// depois pelo objetivo, para que a frente final não seja cortada cedo.
+#define TUNE_MAX_RUNGS   4
+#define TUNE_MIN_HORIZON 20
+
+typedef enum {
+    TUNE_P99_WAIT,          // P99 da espera (inclui processos por terminar)
+    TUNE_AVG_WAIT,          // espera média dos completos
+    TUNE_AVG_TURNAROUND     // turnaround médio dos completos
+} TuneObjective;
+
+typedef struct {
+    int objective;          // TuneObjective
+    double switch_budget;   // sobrecarga máxima (% do tempo em trocas); < 0 = sem limite
+    int jobs;
+    ResultCache *cache;     // NULL = sem cache de resultados
+} TuneOptions;
+
+typedef struct {
+    SweepPoint point;
+    SimResults result;      // da última avaliação
+    double objective;
+    double overhead;        // % do tempo final gasto em trocas de contexto
+    int feasible;           // dentro do orçamento de trocas
+    int rung;               // última ronda em que foi avaliado
+    int front;              // nível de Pareto nessa ronda (0 = não dominado)
+} TuneCandidate;
+
+typedef struct {
+    TuneCandidate *candidates;
+    int count;
+    int rungs;
+    int horizon[TUNE_MAX_RUNGS];    // -1 = sem limite
+    int evaluated[TUNE_MAX_RUNGS];
+    int best;                       // índice em candidates
+    long long simulated_time;       // soma dos tempos finais de todas as avaliações
+    double wall_ms;
+} TuneReport;
+
+int  tune_parse_objective(const char *name);
+const char *tune_objective_name(int objective);
+int  tune_algorithm_supported(const char *algorithm);
+
+// Opções de linha de comando que reproduzem o ponto (ex: "-q 8").
+void tune_point_flags(const char *algorithm, const SweepPoint *point, char *buf, size_t size);
+
+// Devolve SIM_OK ou o estado da primeira avaliação que falhou.
+int  tune_run(const SimWorkload *workload, const SimConfig *base, const TuneOptions *options, TuneReport *report);
+void tune_free(TuneReport *report);
+
+#endif
@@ -0,0 +1,135 @@
+#define _DEFAULT_SOURCE
+#include "whatif.h"
+#include "stats.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+// Resultado de uma variante, escrito pelo filho em memória partilhada.
+typedef struct {
+    int done;
+    SimResults result;
+} WhatIfSlot;
+
+typedef struct {
+    const SweepGrid *variants;
+    WhatIfSlot *slots;
+    pid_t *pids;
+    int variant;            // -1 no pai; índice da variante num filho
+    int reached_time;
+} WhatIfCtx;
+
+void whatif_base_point(const SimConfig *base, SweepPoint *point) {
+    point->quantum = base->quantum;
+    point->switch_cost = base->context_switch_cost;
+    point->aging_threshold = base->aging_threshold;
+    point->aging_interval = base->aging_interval;
+    point->mlq_quantum[0] = base->mlq_quantum[0];
+    point->mlq_quantum[1] = base->mlq_quantum[1];
+}
+
+// Callback de SimConfig.on_branch: o pai cria um filho por variante e
+// regressa sem alterações; cada filho regressa com os parâmetros da sua.
+static void whatif_branch(void *arg, SimParams *params) {
+    WhatIfCtx *ctx = (WhatIfCtx *)arg;
+    ctx->reached_time = params->time;
+    // Os buffers do stdio seriam duplicados em cada fork.
+    fflush(NULL);
+    for (int k = 0; k < ctx->variants->count; k++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            const SweepPoint *pt = &ctx->variants->points[k];
+            ctx->variant = k;
+            params->quantum = pt->quantum;
+            params->context_switch_cost = pt->switch_cost;
+            params->aging_threshold = pt->aging_threshold;
+            params->aging_interval = pt->aging_interval;
+            params->mlq_quantum[0] = pt->mlq_quantum[0] > 0 ? pt->mlq_quantum[0] : pt->quantum;
+            params->mlq_quantum[1] = pt->mlq_quantum[1] > 0 ? pt->mlq_quantum[1] : pt->quantum * 2;
+            return;
+        }
+        ctx->pids[k] = pid;
+    }
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1.0e3 + ts.tv_nsec / 1.0e6;
+}
+
+int whatif_run(const SimWorkload *workload, const SimConfig *base, int branch_time, const SweepGrid *variants,
+               SimResults *results, WhatIfSummary *summary) {
+    double start = now_ms();
+    memset(summary, 0, sizeof(*summary));
+    summary->branch_time = branch_time;
+    summary->reached_time = -1;
+
+    size_t size = sizeof(WhatIfSlot) * (size_t)variants->count;
+    WhatIfSlot *slots = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    pid_t *pids = sim_malloc(sizeof(pid_t) * variants->count);
+    if (slots == MAP_FAILED || !pids) {
+        fprintf(stderr, "Erro ao reservar memória partilhada: %s\n", strerror(errno));
+        if (slots != MAP_FAILED) munmap(slots, size);
+        sim_free(pids);
+        results[0].status = SIM_ERR_MEMORY;
+        return SIM_ERR_MEMORY;
+    }
+    memset(slots, 0, size);
+
+    WhatIfCtx ctx;
+    ctx.variants = variants;
+    ctx.slots = slots;
+    ctx.pids = pids;
+    ctx.variant = -1;
+    ctx.reached_time = -1;
+
+    // Só métricas globais: sem trace, Gantt nem resultados por processo, que
+    // os filhos escreveriam nos mesmos ficheiros.
+    SimConfig cfg = *base;
+    cfg.trace_path = NULL;
+    cfg.series_path = NULL;
+    cfg.gantt_ascii = 0;
+    cfg.gantt_csv_path = NULL;
+    cfg.on_process = NULL;
+    cfg.log_level = SIM_LOG_ERROR;
+    cfg.on_branch = whatif_branch;
+    cfg.branch_arg = &ctx;
+    cfg.branch_time = branch_time;
+
+    int status = simulate(workload, &cfg, &results[0]);
+    if (ctx.variant >= 0) {
+        WhatIfSlot *slot = &slots[ctx.variant];
+        slot->result = results[0];
+        __atomic_store_n(&slot->done, 1, __ATOMIC_RELEASE);
+        _exit(0);
+    }
+
+    summary->reached_time = ctx.reached_time;
+    for (int k = 0; k < variants->count; k++) {
+        SimResults *r = &results[1 + k];
+        if (ctx.reached_time < 0) {
+            *r = results[0];
+            continue;
+        }
+        int wstatus = 0;
+        int exited = pids[k] > 0 && waitpid(pids[k], &wstatus, 0) == pids[k] &&
+                     WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0;
+        if (exited && __atomic_load_n(&slots[k].done, __ATOMIC_ACQUIRE)) {
+            *r = slots[k].result;
+        } else {
+            memset(r, 0, sizeof(*r));
+            r->status = SIM_ERR_MEMORY;
+            summary->lost++;
+        }
+    }
+
+    munmap(slots, size);
+    sim_free(pids);
+    summary->wall_ms = now_ms() - start;
+    return status;
+}
@@ -0,0 +1,36 @@
+#ifndef WHATIF_H
+#define WHATIF_H
+
+#include "sweep.h"
+
+// Exploração "what-if" (--whatif T:espec): a simulação corre uma só vez até
+// ao instante T; aí o processo faz fork() de um filho por variante (a mesma
+// sintaxe do --sweep) e cada filho continua, com os parâmetros da variante,
+// a partir do estado exato da ramificação: processos, filas, dispositivos de
+// I/O, gerador e relógio são partilhados por cópia na escrita. O pai segue
+// sem alterações, como referência. O prefixo comum é simulado uma vez em vez
+// de uma vez por variante.
+//
+// Só os parâmetros de execução mudam (quantum, custo de troca, aging e
+// quanta do mlq); o algoritmo não, porque cada motor guarda as filas nas
+// suas próprias estruturas. Os filhos correm em paralelo com o pai, pelo que
+// o número de variantes é limitado.
+#define WHATIF_MAX_VARIANTS 64
+
+typedef struct {
+    int branch_time;        // pedido
+    int reached_time;       // instante real da ramificação; -1 = a simulação acabou antes
+    int lost;               // variantes cujo processo falhou
+    double wall_ms;
+} WhatIfSummary;
+
+// Ponto com os parâmetros de execução da configuração (referência).
+void whatif_base_point(const SimConfig *base, SweepPoint *point);
+
+// results[0] é a continuação sem alterações e results[1 + k] a variante k
+// (igual à referência se a ramificação não aconteceu; status != SIM_OK se
+// o filho falhou). Devolve o estado da referência.
+int  whatif_run(const SimWorkload *workload, const SimConfig *base, int branch_time, const SweepGrid *variants,
+                SimResults *results, WhatIfSummary *summary);
+
+#endif
@@ -0,0 +1,394 @@
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include "workload.h"
+#include "stats.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+PhaseArena g_phase_arena = { NULL, 0, 0 };
+
+int phase_arena_push(int cpu_end, int io) {
+    if (g_phase_arena.size == g_phase_arena.capacity) {
+        int new_capacity = g_phase_arena.capacity > 0 ? g_phase_arena.capacity * 2 : 256;
+        Phase *grown = sim_realloc(g_phase_arena.phases, sizeof(Phase) * new_capacity);
+        if (!grown) {
+            fprintf(stderr, "Erro: Falha ao alocar memória para as fases CPU/I/O\n");
+            return 0;
+        }
+        g_phase_arena.phases = grown;
+        g_phase_arena.capacity = new_capacity;
+    }
+    g_phase_arena.phases[g_phase_arena.size].cpu_end = cpu_end;
+    g_phase_arena.phases[g_phase_arena.size].io = io;
+    g_phase_arena.size++;
+    return 1;
+}
+
+// Esvazia a arena mantendo a capacidade (nova carga na mesma execução do programa).
+void phase_arena_reset(void) {
+    g_phase_arena.size = 0;
+}
+
+void phase_arena_free(void) {
+    sim_free(g_phase_arena.phases);
+    g_phase_arena.phases = NULL;
+    g_phase_arena.size = 0;
+    g_phase_arena.capacity = 0;
+}
+
+// Processos com um único burst (gerados ou lidos sem sequência explícita)
+// recebem aqui as suas fases: o burst é partido nos pontos em que o processo
+// pede I/O, amostrados uma única vez. Cada tick tem probabilidade 1/(2*burst)
+// de pedir I/O, com intervalos geométricos. Feito numa segunda passagem para
+// que o resto da carga gerada com uma dada semente não mude.
+void sample_io_points(ProcessSpec *list, int count) {
+    for (int i = 0; i < count; i++) {
+        ProcessSpec *p = &list[i];
+        if (p->phase_count > 0) continue;
+        p->phase_offset = g_phase_arena.size;
+
+        if (p->io_burst_duration > 0 && p->burst_time > 1) {
+            double prob = 1.0 / (p->burst_time * 2);
+            double executed = 0.0;
+            for (;;) {
+                double u;
+                do {
+                    u = (double)rand() / (RAND_MAX + 1.0);
+                } while (u == 0.0);
+                double gap = ceil(log(u) / log(1.0 - prob));
+                if (gap < 1.0) gap = 1.0;
+                executed += gap;
+                if (executed >= p->burst_time) break;
+                if (!phase_arena_push((int)executed, p->io_burst_duration)) return;
+                p->phase_count++;
+            }
+        }
+        if (!phase_arena_push(p->burst_time, p->io_burst_duration)) return;
+        p->phase_count++;
+    }
+}
+
+// Bilhetes por omissão: prioridade 1 (máxima) recebe 5x os bilhetes da prioridade 5.
+int tickets_from_priority(int priority) {
+    int level = TICKETS_PRIORITY_LEVELS + 1 - priority;
+    if (level < 1) level = 1;
+    if (level > TICKETS_PRIORITY_LEVELS) level = TICKETS_PRIORITY_LEVELS;
+    return level * TICKETS_PER_PRIORITY_LEVEL;
+}
+
+// --- Distribuição exponencial ---
+double rand_exponential(double lambda) {
+    if (lambda <= 0) return 1.0;
+    double u;
+    do {
+        u = (double)rand() / (RAND_MAX + 1.0);
+    } while (u == 0.0 || u == 1.0);
+    return -log(u) / lambda;
+}
+
+// --- Distribuição normal (Box-Muller) ---
+double rand_normal(double mean, double stddev) {
+    if (stddev < 0) stddev = 0;
+    double u1, u2;
+    do {
+        u1 = (double)rand() / (RAND_MAX + 1.0);
+    } while (u1 == 0.0);
+    u2 = (double)rand() / (RAND_MAX + 1.0);
+    double z = sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+    return z * stddev + mean;
+}
+
+ProcessSpec* generate_static_processes(SimContext *arena, int count) {
+    if (count <= 0) return NULL;
+    ProcessSpec* list = simctx_alloc(arena, sizeof(ProcessSpec) * count);
+    if (!list) {
+        fprintf(stderr, "Erro: Falha ao alocar memória em generate_static_processes\n");
+        return NULL;
+    }
+    for (int i = 0; i < count; i++) {
+        list[i].id = i + 1;
+        list[i].arrival_time = i * 2;
+        list[i].burst_time = 5 + (i % 3);
+        if (list[i].burst_time <=0) list[i].burst_time = 1;
+        list[i].priority = 1 + (i % 5);
+        list[i].deadline = list[i].arrival_time + 10 + (rand() % 5);
+        list[i].period = 0;
+        list[i].tickets = tickets_from_priority(list[i].priority);
+        list[i].io_burst_duration = (rand() % 2 == 0) ? (2 + rand() % 4) : 0;
+        list[i].phase_count = 0;
+    }
+    sample_io_points(list, count);
+    return list;
+}
+
+static int sample_burst(double p1, double p2, int burst_dist_type) {
+    double burst_val;
+    if (burst_dist_type == 1) {
+        double lambda_burst = p1;
+         if (lambda_burst <= 0) lambda_burst = 0.1;
+        burst_val = rand_exponential(lambda_burst);
+    } else {
+        double mean = p1;
+        double stddev = p2;
+        burst_val = rand_normal(mean, stddev);
+    }
+    int burst = (int)round(burst_val);
+    return (burst <= 0) ? 1 : burst;
+}
+
+static int sample_io_duration(int min_io_duration, int max_io_duration) {
+    int duration = 0;
+    if (max_io_duration > min_io_duration) {
+         duration = min_io_duration + rand() % (max_io_duration - min_io_duration + 1);
+    } else if (max_io_duration >= 0) {
+        duration = min_io_duration;
+    }
+    return (duration <= 0) ? 1 : duration;
+}
+
+ProcessSpec* generate_random_processes(SimContext *arena, int count, double lambda_arrival, double p1, double p2, int burst_dist_type, int prio_type,
+                                   double io_chance, int min_io_duration, int max_io_duration, int bursts_per_process) {
+    if (count <= 0) return NULL;
+    ProcessSpec* list = simctx_alloc(arena, sizeof(ProcessSpec) * count);
+     if (!list) {
+        fprintf(stderr, "Erro: Falha ao alocar memória em generate_random_processes\n");
+        return NULL;
+    }
+    double current_time = 0.0;
+
+    for (int i = 0; i < count; i++) {
+        list[i].id = i + 1;
+
+        current_time += rand_exponential(lambda_arrival);
+        list[i].arrival_time = (int)round(current_time);
+        if (list[i].arrival_time < 0) list[i].arrival_time = 0;
+
+        list[i].burst_time = sample_burst(p1, p2, burst_dist_type);
+
+        // Com --bursts > 1 o processo alterna bursts de CPU com I/O; as fases
+        // intermédias vão já para a arena (o I/O terminal é decidido abaixo).
+        list[i].phase_count = 0;
+        int io_between = 0;
+        if (bursts_per_process > 1) {
+            list[i].phase_offset = g_phase_arena.size;
+            int cpu_end = list[i].burst_time;
+            for (int b = 1; b < bursts_per_process; b++) {
+                int io = sample_io_duration(min_io_duration, max_io_duration);
+                if (!phase_arena_push(cpu_end, io)) { simctx_free(arena, list); return NULL; }
+                list[i].phase_count++;
+                io_between += io;
+                cpu_end += sample_burst(p1, p2, burst_dist_type);
+            }
+            list[i].burst_time = cpu_end;
+        }
+
+        if (prio_type == 1) {
+             list[i].priority = 1 + rand() % 5;
+        } else {
+            int dice = rand() % 100;
+            if (dice < 40) list[i].priority = 1;
+            else if (dice < 70) list[i].priority = 2;
+            else if (dice < 90) list[i].priority = 3;
+            else if (dice < 97) list[i].priority = 4;
+            else list[i].priority = 5;
+        }
+
+        double avg_burst = (burst_dist_type == 1 && p1 > 0) ? (1.0 / p1) : ((burst_dist_type == 0) ? p1 : 5.0);
+        int slack = (int)round(avg_burst * 1.5) + (rand() % ((int)avg_burst + 1));
+        list[i].deadline = list[i].arrival_time + list[i].burst_time + io_between + slack;
+         if (list[i].deadline <= list[i].arrival_time) {
+             list[i].deadline = list[i].arrival_time + list[i].burst_time + 1;
+         }
+
+        list[i].period = 0;
+        list[i].tickets = tickets_from_priority(list[i].priority);
+
+        list[i].io_burst_duration = 0;
+        if (((double)rand() / RAND_MAX) < io_chance) {
+            list[i].io_burst_duration = sample_io_duration(min_io_duration, max_io_duration);
+        }
+        if (list[i].phase_count > 0) {
+            if (!phase_arena_push(list[i].burst_time, list[i].io_burst_duration)) { simctx_free(arena, list); return NULL; }
+            list[i].phase_count++;
+        }
+
+    }
+    sample_io_points(list, count);
+    return list;
+}
+
+
+#define MAX_FILE_BURSTS 256
+
+// Uma linha do ficheiro: ID Chegada Burst(s) Prio Dead Period [IODur(s) [Tickets]],
+// onde Burst(s) e IODur(s) podem ser listas separadas por vírgulas.
+typedef struct {
+    int fields;
+    int id, arrival, priority, deadline, period, tickets;
+    int bursts[MAX_FILE_BURSTS];
+    int burst_count;
+    int ios[MAX_FILE_BURSTS];
+    int io_count;
+} ProcessLine;
+
+static int parse_int_list(const char *token, int *values, int max_values) {
+    int n = 0;
+    const char *c = token;
+    while (*c != '\0') {
+        char *end;
+        long v = strtol(c, &end, 10);
+        if (end == c || n >= max_values) return 0;
+        values[n++] = (int)v;
+        if (*end == ',') c = end + 1;
+        else if (*end == '\0') break;
+        else return 0;
+    }
+    return n;
+}
+
+static int parse_int(const char *token, int *value) {
+    char *end;
+    long v = strtol(token, &end, 10);
+    if (end == token || *end != '\0') return 0;
+    *value = (int)v;
+    return 1;
+}
+
+// Devolve o número de campos lidos (>= 6 para uma linha válida).
+static int parse_process_line(char *buffer, ProcessLine *line) {
+    char *tokens[8];
+    int n = 0;
+    for (char *tok = strtok(buffer, " \t\r\n"); tok && n < 8; tok = strtok(NULL, " \t\r\n")) tokens[n++] = tok;
+    if (n < 6) return 0;
+
+    line->io_count = 0;
+    line->tickets = 0;
+    if (!parse_int(tokens[0], &line->id) || !parse_int(tokens[1], &line->arrival) ||
+        !parse_int(tokens[3], &line->priority) || !parse_int(tokens[4], &line->deadline) ||
+        !parse_int(tokens[5], &line->period)) return 0;
+    line->burst_count = parse_int_list(tokens[2], line->bursts, MAX_FILE_BURSTS);
+    if (line->burst_count == 0) return 0;
+    if (n >= 7) {
+        line->io_count = parse_int_list(tokens[6], line->ios, MAX_FILE_BURSTS);
+        if (line->io_count == 0) return 0;
+    }
+    if (n >= 8 && !parse_int(tokens[7], &line->tickets)) return 0;
+    line->fields = n;
+    return n;
+}
+
+// Sequência explícita de bursts: o I/O k separa os bursts k e k+1 (mínimo 1;
+// se faltar, usa 1) e um I/O extra no fim é o I/O terminal.
+static int build_file_phases(ProcessSpec *p, const ProcessLine *line) {
+    p->phase_count = 0;
+    if (line->burst_count == 1) {
+        p->burst_time = (line->bursts[0] > 0) ? line->bursts[0] : 1;
+        p->io_burst_duration = (line->io_count >= 1 && line->ios[0] > 0) ? line->ios[0] : 0;
+        return 1;
+    }
+    p->phase_offset = g_phase_arena.size;
+    p->io_burst_duration = (line->io_count >= line->burst_count && line->ios[line->burst_count - 1] > 0)
+                           ? line->ios[line->burst_count - 1] : 0;
+    int cpu_end = 0;
+    for (int b = 0; b < line->burst_count; b++) {
+        cpu_end += (line->bursts[b] > 0) ? line->bursts[b] : 1;
+        int io;
+        if (b == line->burst_count - 1) io = p->io_burst_duration;
+        else io = (b < line->io_count && line->ios[b] > 0) ? line->ios[b] : 1;
+        if (!phase_arena_push(cpu_end, io)) return 0;
+        p->phase_count++;
+    }
+    p->burst_time = cpu_end;
+    return 1;
+}
+
+int read_next_process_line(FILE *file, int *arrival, int *burst, int *priority) {
+    char buffer[4096];
+    ProcessLine line;
+    while (fgets(buffer, sizeof(buffer), file)) {
+        if (buffer[0] == '\n' || buffer[0] == '\r' || buffer[0] == '#' || buffer[0] == ' ') continue;
+        char copy[4096];
+        strcpy(copy, buffer);
+        if (parse_process_line(copy, &line) < 6) {
+            fprintf(stderr, "Aviso: Linha mal formatada ignorada no ficheiro: %s", buffer);
+            continue;
+        }
+        int total = 0;
+        for (int b = 0; b < line.burst_count; b++) total += (line.bursts[b] > 0) ? line.bursts[b] : 1;
+        *arrival = line.arrival;
+        *burst = total;
+        *priority = line.priority;
+        return 1;
+    }
+    return 0;
+}
+
+ProcessSpec* read_processes_from_file(SimContext *arena, const char* filename, int* count_ptr) {
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        perror("Erro ao abrir ficheiro de processos");
+        *count_ptr = 0;
+        return NULL;
+    }
+    int count = 0;
+    char buffer[4096];
+    char copy[4096];
+    ProcessLine line;
+    while (fgets(buffer, sizeof(buffer), file)) {
+        if (buffer[0] == '\n' || buffer[0] == '\r' || buffer[0] == '#' || buffer[0] == ' ') continue;
+        strcpy(copy, buffer);
+        if (parse_process_line(copy, &line) >= 6) {
+             count++;
+        } else {
+            fprintf(stderr, "Aviso: Linha mal formatada ignorada no ficheiro: %s", buffer);
+        }
+    }
+
+    if (count == 0) {
+        fprintf(stderr, "Erro: Nenhum processo válido encontrado no ficheiro '%s'.\n", filename);
+        fclose(file);
+        *count_ptr = 0;
+        return NULL;
+    }
+
+    ProcessSpec* list = simctx_alloc(arena, sizeof(ProcessSpec) * count);
+    if (!list) {
+        fprintf(stderr, "Erro: Falha ao alocar memória para %d processos do ficheiro.\n", count);
+        fclose(file);
+        *count_ptr = 0;
+        return NULL;
+    }
+
+    rewind(file);
+    int current_process_index = 0;
+    while (fgets(buffer, sizeof(buffer), file) && current_process_index < count) {
+         if (buffer[0] == '\n' || buffer[0] == '\r' || buffer[0] == '#' || buffer[0] == ' ') continue;
+        if (parse_process_line(buffer, &line) >= 6) {
+            ProcessSpec *p = &list[current_process_index];
+            p->id = line.id;
+            p->arrival_time = line.arrival;
+            p->priority = line.priority;
+            p->deadline = line.deadline;
+            p->period = line.period;
+            p->tickets = (line.fields == 8 && line.tickets > 0) ? line.tickets : tickets_from_priority(line.priority);
+            if (!build_file_phases(p, &line)) {
+                fclose(file);
+                simctx_free(arena, list);
+                *count_ptr = 0;
+                return NULL;
+            }
+
+            current_process_index++;
+        }
+    }
+    fclose(file);
+    sample_io_points(list, count);
+    *count_ptr = count;
+    printf("Lidos %d processos do ficheiro '%s'.\n", count, filename);
+    return list;
+}
@@ -0,0 +1,38 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "process.h"
+
+// Cargas do CLI: geração aleatória, carga estática e leitura de ficheiro.
+// Não fazem parte da libprobsched: usam rand() e o vetor global de fases
+// g_phase_arena, e quem embebe a biblioteca constrói a sua própria carga.
+#define TICKETS_PER_PRIORITY_LEVEL 100
+#define TICKETS_PRIORITY_LEVELS 5
+
+typedef struct {
+    Phase *phases;
+    int size;
+    int capacity;
+} PhaseArena;
+
+extern PhaseArena g_phase_arena;
+
+// Os geradores não são reentrantes: usam rand() e g_phase_arena. A lista
+// devolvida vem da arena indicada (NULL = malloc) e liberta-se com simctx_free.
+ProcessSpec* generate_static_processes(SimContext *arena, int count);
+
+ProcessSpec* generate_random_processes(SimContext *arena, int count, double lambda_arrival, double p1, double p2, int burst_dist_type, int prio_type,
+                                   double io_chance, int min_io_duration, int max_io_duration, int bursts_per_process);
+
+ProcessSpec* read_processes_from_file(SimContext *arena, const char* filename, int* count_ptr);
+// Leitura em fluxo do mesmo formato, linha a linha (--open-trace): devolve 1
+// com a próxima linha válida (CPU total dos bursts, sem I/O) e 0 no fim.
+int  read_next_process_line(FILE *file, int *arrival, int *burst, int *priority);
+int  tickets_from_priority(int priority);
+
+void sample_io_points(ProcessSpec *list, int count);
+int  phase_arena_push(int cpu_end, int io);
+void phase_arena_reset(void);
+void phase_arena_free(void);
+
+#endif